@@ -0,0 +1,303 @@
+#include <cstdio>
+#include <QtConcurrent>
+#include "batchmode.hpp"
+#include "logdocument.hpp"
+#include "rowfilter.hpp"
+#include "logexporter.hpp"
+#include "columnarexporter.hpp"
+
+static const char *BatchActionList[] = {"--stats", "--find", "--export", "--help", "-h"};
+
+enum BatchAction
+{
+	StatsAction,
+	FindAction,
+	ExportAction
+};
+
+struct BatchOptions
+{
+	BatchAction action;
+	RowFilter filter;
+	ExportOptions exportOptions;
+	QDir exportDir;
+};
+
+struct BatchResult
+{
+	QByteArray output;
+	QString errorMessage;
+};
+
+static QByteArray statsHeader()
+{
+	return "file\trows\tphysics_frames\tcommand_frames\ttime\tframebulks\tmax_hspd\tmean_hspd"
+		"\tdamage_rows\tcollision_rows\tobject_move_rows\tconsole_print_rows\n";
+}
+
+static QByteArray statsLine(const QString &fileName, const LogDocument &document)
+{
+	const GameTimeIndex &timeIndex = document.gameTimeIndex();
+	const EventIndex &eventIndex = document.eventIndex();
+	const RangeSummary speed = document.rowCount() > 0
+		? document.rangeStatistics().summarize(HorizontalSpeedField, 0, document.rowCount() - 1)
+		: RangeSummary();
+
+	QStringList fieldList;
+	fieldList << fileName
+		<< QString::number(document.rowCount())
+		<< QString::number(timeIndex.physicsFrameCount())
+		<< QString::number(timeIndex.commandFrameCount())
+		<< QString::number(timeIndex.totalTime(), 'f', 6)
+		<< QString::number(document.framebulkIndex().count())
+		<< QString::number(speed.count ? speed.max : 0)
+		<< QString::number(speed.mean())
+		<< QString::number(eventIndex.rows(DamageEvent).size())
+		<< QString::number(eventIndex.rows(CollisionEvent).size())
+		<< QString::number(eventIndex.rows(ObjectMoveEvent).size())
+		<< QString::number(eventIndex.rows(ConsolePrintEvent).size());
+	return fieldList.join('\t').toUtf8() + '\n';
+}
+
+static QByteArray findHeader()
+{
+	return "file\trow\ttime\n";
+}
+
+static QByteArray findLines(const QString &fileName, const LogDocument &document,
+	const RowFilter &filter)
+{
+	const RowFilterSource source = {
+		&document.tasLog(),
+		&document.logColumns(),
+		&document.eventIndex(),
+		&document.gameTimeIndex(),
+	};
+
+	QByteArray output;
+	const QByteArray name = fileName.toUtf8();
+	for (const int row : filter.evaluate(source)) {
+		const double time = document.gameTimeIndex().timeAt(document.physicsFrameIndex(row));
+		output += name + '\t' + QByteArray::number(row) + '\t'
+			+ QByteArray::number(time, 'f', 6) + '\n';
+	}
+	return output;
+}
+
+static QByteArray exportHeader()
+{
+	return "file\texport\trows\n";
+}
+
+static QByteArray exportLog(const QString &fileName, const LogDocument &document,
+	const BatchOptions &options, QString *errorMessage)
+{
+	ExportOptions exportOptions = options.exportOptions;
+	if (!options.filter.isEmpty()) {
+		const RowFilterSource source = {
+			&document.tasLog(),
+			&document.logColumns(),
+			&document.eventIndex(),
+			&document.gameTimeIndex(),
+		};
+		exportOptions.rowList = options.filter.evaluate(source);
+		// An empty row list would export every row.
+		if (exportOptions.rowList.isEmpty())
+			return fileName.toUtf8() + "\t\t0\n";
+	}
+
+	const QString exportName = options.exportDir.filePath(QFileInfo(fileName).completeBaseName()
+		+ '.' + exportFileExtension(exportOptions.format));
+	QFile file(exportName);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+		*errorMessage = QString("cannot write %1: %2").arg(exportName, file.errorString());
+		return QByteArray();
+	}
+	const bool written = exportOptions.format == ColumnarFormat
+		? ColumnarExporter(document).write(&file, errorMessage)
+		: LogExporter(document, exportOptions).write(&file, errorMessage);
+	if (!written)
+		return QByteArray();
+
+	const int rowCount = exportOptions.rowList.isEmpty()
+		? document.rowCount() : exportOptions.rowList.size();
+	return fileName.toUtf8() + '\t' + exportName.toUtf8() + '\t'
+		+ QByteArray::number(rowCount) + '\n';
+}
+
+// Loads and processes one log. Called on the threads of the global pool, each with its own
+// document, so only as many logs as there are threads are in memory at once.
+struct ProcessLog
+{
+	typedef BatchResult result_type;
+
+	const BatchOptions *options;
+
+	BatchResult operator()(const QString &fileName) const
+	{
+		BatchResult result;
+		LogDocument document;
+		const LogFileError error = document.load(fileName);
+		if (error == LFErrorCannotOpen) {
+			result.errorMessage = "cannot open the file";
+			return result;
+		} else if (error == LFErrorInvalidLogFile) {
+			result.errorMessage = "not a valid log file";
+			return result;
+		}
+
+		switch (options->action) {
+		case StatsAction:
+			result.output = statsLine(fileName, document);
+			break;
+		case FindAction:
+			result.output = findLines(fileName, document, options->filter);
+			break;
+		case ExportAction:
+			result.output = exportLog(fileName, document, *options, &result.errorMessage);
+			break;
+		}
+		return result;
+	}
+};
+
+bool isBatchMode(int argc, char **argv)
+{
+	for (int i = 1; i < argc; i++) {
+		const QByteArray argument(argv[i]);
+		for (const char *action : BatchActionList) {
+			if (argument == action || argument.startsWith(QByteArray(action) + '='))
+				return true;
+		}
+	}
+	return false;
+}
+
+int runBatchMode(const QStringList &arguments)
+{
+	QCommandLineParser parser;
+	parser.setApplicationDescription("Processes TAS logs without a display and writes "
+		"tab-separated results to the standard output.");
+	parser.addHelpOption();
+	const QCommandLineOption statsOption("stats",
+		"Print the row counts, duration, speed and event counts of each log.");
+	const QCommandLineOption findOption("find",
+		"Print the rows matching a row filter, e.g. \"g && hspd > 320\".", "filter");
+	const QCommandLineOption exportOption("export",
+		"Export the rows of each log, or those matching --find, to <dir>.", "dir");
+	const QCommandLineOption columnsOption("columns",
+		"Comma-separated columns to export, e.g. \"time,hspd,vyaw,y\". Defaults to all "
+		"log fields and the game time.", "columns");
+	const QCommandLineOption tsvOption("tsv", "Export tab-separated instead of CSV files.");
+	const QCommandLineOption columnarOption("columnar",
+		"Export every column and event in the columnar binary format instead.");
+	const QCommandLineOption anglemodOption("anglemod",
+		"Export the viewangles in anglemod units.");
+	const QCommandLineOption fsuLettersOption("fsu-letters",
+		"Export the moves as F/B, L/R and D/U letters instead of values.");
+	const QCommandLineOption jobsOption(QStringList() << "j" << "jobs",
+		"Process up to <count> logs at once. Defaults to the number of cores.", "count");
+	parser.addOption(statsOption);
+	parser.addOption(findOption);
+	parser.addOption(exportOption);
+	parser.addOption(columnsOption);
+	parser.addOption(tsvOption);
+	parser.addOption(columnarOption);
+	parser.addOption(anglemodOption);
+	parser.addOption(fsuLettersOption);
+	parser.addOption(jobsOption);
+	parser.addPositionalArgument("logs", "The log files to process.", "logs...");
+	parser.process(arguments);
+
+	BatchOptions options;
+	if (parser.isSet(exportOption)) {
+		if (parser.isSet(statsOption)) {
+			fprintf(stderr, "--stats cannot be combined with --export.\n");
+			return 2;
+		}
+		options.action = ExportAction;
+	} else if (parser.isSet(statsOption) == parser.isSet(findOption)) {
+		fprintf(stderr, "Exactly one of --stats, --find and --export must be given.\n");
+		return 2;
+	} else
+		options.action = parser.isSet(statsOption) ? StatsAction : FindAction;
+
+	if (options.action == ExportAction) {
+		ExportOptions &exportOptions = options.exportOptions;
+		exportOptions.format = parser.isSet(columnarOption) ? ColumnarFormat
+			: parser.isSet(tsvOption) ? TsvFormat : CsvFormat;
+		if (exportOptions.format == ColumnarFormat
+			&& (parser.isSet(columnsOption) || parser.isSet(findOption))) {
+			fprintf(stderr, "--columnar exports whole logs, without --columns or --find.\n");
+			return 2;
+		}
+		exportOptions.anglemodUnit = parser.isSet(anglemodOption);
+		exportOptions.fsuValues = !parser.isSet(fsuLettersOption);
+		if (parser.isSet(columnsOption)) {
+			for (const QString &name : parser.value(columnsOption).split(',')) {
+				const int column = findExportColumn(name.trimmed());
+				if (column == -1) {
+					fprintf(stderr, "Unknown column: %s\n", qPrintable(name));
+					return 2;
+				}
+				exportOptions.columnList.append(column);
+			}
+		} else {
+			exportOptions.columnList.append(ElapsedTimeColumn);
+			for (int field = 0; field < LogFieldCount; field++)
+				exportOptions.columnList.append(field);
+		}
+
+		options.exportDir = QDir(parser.value(exportOption));
+		if (!options.exportDir.exists() && !options.exportDir.mkpath(".")) {
+			fprintf(stderr, "Cannot create the directory %s\n",
+				qPrintable(parser.value(exportOption)));
+			return 2;
+		}
+	}
+
+	if (parser.isSet(findOption)) {
+		QString errorMessage;
+		if (!options.filter.compile(parser.value(findOption), &errorMessage)) {
+			fprintf(stderr, "Invalid filter: %s\n", qPrintable(errorMessage));
+			return 2;
+		}
+	}
+
+	if (parser.isSet(jobsOption)) {
+		bool ok;
+		const int jobs = parser.value(jobsOption).toInt(&ok);
+		if (!ok || jobs < 1) {
+			fprintf(stderr, "Invalid job count: %s\n", qPrintable(parser.value(jobsOption)));
+			return 2;
+		}
+		QThreadPool::globalInstance()->setMaxThreadCount(jobs);
+	}
+
+	const QStringList fileList = parser.positionalArguments();
+	if (fileList.isEmpty()) {
+		fprintf(stderr, "No log files given.\n");
+		return 2;
+	}
+
+	const QByteArray header = options.action == StatsAction ? statsHeader()
+		: options.action == FindAction ? findHeader() : exportHeader();
+	fwrite(header.constData(), 1, header.size(), stdout);
+
+	// The results are written in the order of the files as soon as each one is ready.
+	const QFuture<BatchResult> future = QtConcurrent::mapped(fileList, ProcessLog{&options});
+	int exitCode = 0;
+	for (int i = 0; i < fileList.size(); i++) {
+		const BatchResult result = future.resultAt(i);
+		if (!result.errorMessage.isEmpty()) {
+			fprintf(stderr, "%s: %s\n", qPrintable(fileList.at(i)),
+				qPrintable(result.errorMessage));
+			exitCode = 1;
+			continue;
+		}
+		fwrite(result.output.constData(), 1, result.output.size(), stdout);
+		fflush(stdout);
+	}
+
+	return exitCode;
+}
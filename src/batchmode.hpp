@@ -0,0 +1,10 @@
+#pragma once
+
+#include <QtCore>
+
+// Returns whether the command line asks for the batch mode, which processes logs without a
+// display instead of opening the main window.
+bool isBatchMode(int argc, char **argv);
+
+// Runs the batch mode with the arguments of the application and returns the exit code.
+int runBatchMode(const QStringList &arguments);
@@ -0,0 +1,224 @@
+#include <algorithm>
+#include <cmath>
+#include "chartview.hpp"
+
+static const double ZoomStep = 1.25;
+static const int DragThreshold = 3;
+static const int Margin = 4;
+static const QColor PlotColor(40, 90, 200);
+static const QColor CursorColor(Qt::red);
+
+ChartView::ChartView(QWidget *parent, const LogTableModel *model)
+	: QWidget(parent), logTableModel(model)
+{
+	setMinimumSize(200, 80);
+	setAutoFillBackground(true);
+	setBackgroundRole(QPalette::Base);
+}
+
+void ChartView::setField(int field)
+{
+	this->field = field;
+	update();
+}
+
+void ChartView::setTimeAxis(bool enable)
+{
+	// Keep the same rows in view.
+	const int first = rowAtX(xMin);
+	const int last = rowAtX(xMax);
+	timeAxis = enable;
+	xMin = xOfRow(first);
+	xMax = std::max(xMin + (timeAxis ? 1e-3 : 1), xOfRow(last));
+	update();
+}
+
+void ChartView::setCurrentRow(int row)
+{
+	currentRow = row;
+
+	// Follow the cursor when it leaves the view.
+	if (row >= 0 && row < logTableModel->rowCount()) {
+		const double x = xOfRow(row);
+		if (x < xMin || x > xMax) {
+			const double span = xMax - xMin;
+			xMin = x - span / 2;
+			xMax = x + span / 2;
+		}
+	}
+	update();
+}
+
+void ChartView::fitToLog()
+{
+	xMin = 0;
+	xMax = std::max(timeAxis ? 1e-3 : 1.0, xExtent());
+	update();
+}
+
+double ChartView::xExtent() const
+{
+	return timeAxis ? logTableModel->gameTimeIndex().totalTime() : logTableModel->rowCount();
+}
+
+double ChartView::xOfRow(int row) const
+{
+	if (!timeAxis)
+		return row;
+	const GameTimeIndex &timeIndex = logTableModel->gameTimeIndex();
+	return timeIndex.timeAt(timeIndex.findPhysicsFrameByRow(row));
+}
+
+int ChartView::rowAtX(double x) const
+{
+	const int rowCount = logTableModel->rowCount();
+	if (rowCount == 0)
+		return 0;
+	if (!timeAxis)
+		return std::max(0, std::min(rowCount - 1, static_cast<int>(std::ceil(x))));
+
+	const GameTimeIndex &timeIndex = logTableModel->gameTimeIndex();
+	const int phy = timeIndex.findPhysicsFrame(x);
+	return phy == -1 ? 0 : timeIndex.physicsFrameRow(phy);
+}
+
+double ChartView::xAtPixel(double px) const
+{
+	return xMin + (px - Margin) * (xMax - xMin) / std::max(1, width() - 2 * Margin);
+}
+
+double ChartView::pixelAtX(double x) const
+{
+	return Margin + (x - xMin) * std::max(1, width() - 2 * Margin) / (xMax - xMin);
+}
+
+void ChartView::paintEvent(QPaintEvent *)
+{
+	QPainter painter(this);
+	const int rowCount = logTableModel->rowCount();
+	if (rowCount == 0)
+		return;
+
+	const LogColumns &columns = logTableModel->logColumns();
+	const RangeStatistics &statistics = logTableModel->rangeStatistics();
+	const int firstRow = rowAtX(xMin);
+	const int lastRow = std::max(firstRow, std::min(rowCount - 1, rowAtX(xMax)));
+
+	const RangeSummary visible = statistics.summarize(field, firstRow, lastRow);
+	if (!visible.count)
+		return;
+	double yMin = visible.min;
+	double yMax = visible.max;
+	const double pad = yMax > yMin ? (yMax - yMin) * 0.05 : 1;
+	yMin -= pad;
+	yMax += pad;
+	const double plotHeight = height() - 2 * Margin;
+	const auto pixelAtY = [&](double y) {
+		return Margin + (yMax - y) * plotHeight / (yMax - yMin);
+	};
+
+	painter.setPen(palette().color(QPalette::Mid));
+	painter.drawText(rect().adjusted(Margin, Margin, -Margin, -Margin),
+		Qt::AlignLeft | Qt::AlignTop, QString::number(visible.max));
+	painter.drawText(rect().adjusted(Margin, Margin, -Margin, -Margin),
+		Qt::AlignLeft | Qt::AlignBottom, QString::number(visible.min));
+
+	painter.setPen(PlotColor);
+	const int plotWidth = width() - 2 * Margin;
+	if (lastRow - firstRow + 1 <= plotWidth) {
+		// Few enough rows to draw every sample.
+		QPolygonF line;
+		for (int row = firstRow; row <= lastRow; row++) {
+			const float value = columns.value(field, row);
+			if (std::isnan(value)) {
+				painter.drawPolyline(line);
+				line.clear();
+				continue;
+			}
+			line.append(QPointF(pixelAtX(xOfRow(row)), pixelAtY(value)));
+		}
+		painter.drawPolyline(line);
+	} else {
+		// One vertical span per pixel column, joined to the last sample of the previous one.
+		float previous = NAN;
+		for (int px = Margin; px < Margin + plotWidth; px++) {
+			const int first = rowAtX(xAtPixel(px));
+			const int last = std::max(first, rowAtX(xAtPixel(px + 1)) - 1);
+			const RangeSummary summary = statistics.summarize(field, first, last);
+			if (!summary.count) {
+				previous = NAN;
+				continue;
+			}
+			float low = summary.min;
+			float high = summary.max;
+			if (!std::isnan(previous)) {
+				low = std::min(low, previous);
+				high = std::max(high, previous);
+			}
+			painter.drawLine(QPointF(px, pixelAtY(low)), QPointF(px, pixelAtY(high)));
+			previous = columns.value(field, last);
+		}
+	}
+
+	if (currentRow >= 0 && currentRow < rowCount) {
+		const double x = pixelAtX(xOfRow(currentRow));
+		painter.setPen(CursorColor);
+		painter.drawLine(QPointF(x, 0), QPointF(x, height()));
+		const float value = columns.value(field, currentRow);
+		if (!std::isnan(value)) {
+			painter.drawText(QRectF(x + Margin, Margin, width(), height()),
+				Qt::AlignLeft | Qt::AlignTop, QString::number(value));
+		}
+	}
+}
+
+void ChartView::mousePressEvent(QMouseEvent *event)
+{
+	pressPos = event->pos();
+	lastMousePos = event->pos();
+	dragged = false;
+}
+
+void ChartView::mouseMoveEvent(QMouseEvent *event)
+{
+	if (!(event->buttons() & Qt::LeftButton))
+		return;
+	if ((event->pos() - pressPos).manhattanLength() >= DragThreshold)
+		dragged = true;
+	if (!dragged)
+		return;
+
+	const double delta = xAtPixel(lastMousePos.x()) - xAtPixel(event->pos().x());
+	lastMousePos = event->pos();
+	xMin += delta;
+	xMax += delta;
+	update();
+}
+
+void ChartView::mouseReleaseEvent(QMouseEvent *event)
+{
+	if (dragged || event->button() != Qt::LeftButton || logTableModel->rowCount() == 0)
+		return;
+
+	emit rowClicked(rowAtX(xAtPixel(event->pos().x())));
+}
+
+void ChartView::mouseDoubleClickEvent(QMouseEvent *)
+{
+	fitToLog();
+}
+
+void ChartView::wheelEvent(QWheelEvent *event)
+{
+	const double factor = std::pow(ZoomStep, event->angleDelta().y() / 120.0);
+	const double anchor = xAtPixel(event->pos().x());
+
+	// Keep the position under the cursor in place, but never zoom in past a few rows.
+	const double minSpan = timeAxis ? 1e-3 : 4;
+	const double span = std::max(minSpan, (xMax - xMin) / factor);
+	const double ratio = (anchor - xMin) / (xMax - xMin);
+	xMin = anchor - ratio * span;
+	xMax = xMin + span;
+	update();
+	event->accept();
+}
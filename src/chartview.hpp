@@ -0,0 +1,59 @@
+#pragma once
+
+#include <QtWidgets>
+#include "logtablemodel.hpp"
+
+// Plots a log field against the row or the game time, with the current row as a cursor.
+//
+// Every pixel column is drawn from the minimum and maximum of the rows it covers, answered
+// by the range statistics of the model, so the cost of a frame depends on the width of the
+// widget rather than on the number of rows shown. Once there are fewer rows in view than
+// pixels, the samples are drawn as a polyline instead.
+class ChartView : public QWidget
+{
+	Q_OBJECT
+
+public:
+	ChartView(QWidget *parent, const LogTableModel *model);
+
+	void setField(int field);
+	void setTimeAxis(bool enable);
+	void setCurrentRow(int row);
+
+public slots:
+	// Shows the whole log.
+	void fitToLog();
+
+signals:
+	void rowClicked(int row);
+
+protected:
+	void paintEvent(QPaintEvent *event) override;
+	void mousePressEvent(QMouseEvent *event) override;
+	void mouseMoveEvent(QMouseEvent *event) override;
+	void mouseReleaseEvent(QMouseEvent *event) override;
+	void mouseDoubleClickEvent(QMouseEvent *event) override;
+	void wheelEvent(QWheelEvent *event) override;
+
+private:
+	const LogTableModel *logTableModel;
+
+	int field = HorizontalSpeedField;
+	bool timeAxis = false;
+	int currentRow = -1;
+
+	// Visible range of the horizontal axis, in rows or seconds.
+	double xMin = 0;
+	double xMax = 1;
+
+	QPoint pressPos;
+	QPoint lastMousePos;
+	bool dragged = false;
+
+	double xExtent() const;
+	double xOfRow(int row) const;
+	// Returns the first row at or after the position, clamped to the log.
+	int rowAtX(double x) const;
+	double xAtPixel(double px) const;
+	double pixelAtX(double x) const;
+};
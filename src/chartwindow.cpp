@@ -0,0 +1,70 @@
+#include "chartwindow.hpp"
+
+ChartWindow::ChartWindow(QWidget *parent, const LogTableModel *model)
+	: QDockWidget(parent), logTableModel(model)
+{
+	setupUi();
+}
+
+void ChartWindow::setupUi()
+{
+	setWindowTitle("Chart");
+	setObjectName("chartWindow");
+
+	QWidget *chartWidget = new QWidget(this);
+
+	fieldCombo = new QComboBox(chartWidget);
+	for (int field = 0; field < LogFieldCount; field++)
+		fieldCombo->addItem(LogFieldNameList[field], field);
+	fieldCombo->setCurrentIndex(HorizontalSpeedField);
+	connect(fieldCombo, SIGNAL(currentIndexChanged(int)), this, SLOT(fieldChanged(int)));
+
+	axisCombo = new QComboBox(chartWidget);
+	axisCombo->addItem("Row");
+	axisCombo->addItem("Game time");
+	connect(axisCombo, SIGNAL(currentIndexChanged(int)), this, SLOT(axisChanged(int)));
+
+	chartView = new ChartView(chartWidget, logTableModel);
+	chartView->setToolTip("Drag to pan, scroll to zoom, double-click to show the whole log");
+	connect(chartView, SIGNAL(rowClicked(int)), this, SIGNAL(rowClicked(int)));
+
+	QHBoxLayout *controlLayout = new QHBoxLayout;
+	controlLayout->addWidget(new QLabel("Field:", chartWidget));
+	controlLayout->addWidget(fieldCombo);
+	controlLayout->addWidget(new QLabel("Against:", chartWidget));
+	controlLayout->addWidget(axisCombo);
+	controlLayout->addStretch(1);
+
+	QVBoxLayout *layout = new QVBoxLayout(chartWidget);
+	layout->setContentsMargins(2, 2, 2, 2);
+	layout->addLayout(controlLayout);
+	layout->addWidget(chartView, 1);
+	chartWidget->setLayout(layout);
+	setWidget(chartWidget);
+
+	connect(logTableModel, SIGNAL(logFileLoaded(bool)), chartView, SLOT(fitToLog()));
+	connect(logTableModel, SIGNAL(logColumnsChanged()), this, SLOT(logColumnsChanged()));
+	connect(logTableModel, SIGNAL(logFramesAppended(int)), chartView, SLOT(update()));
+	chartView->fitToLog();
+}
+
+void ChartWindow::fieldChanged(int index)
+{
+	chartView->setField(fieldCombo->itemData(index).toInt());
+}
+
+void ChartWindow::axisChanged(int index)
+{
+	chartView->setTimeAxis(index == 1);
+}
+
+void ChartWindow::logColumnsChanged()
+{
+	chartView->update();
+}
+
+void ChartWindow::closeEvent(QCloseEvent *event)
+{
+	emit aboutToClose();
+	QDockWidget::closeEvent(event);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <QtWidgets>
+#include "logtablemodel.hpp"
+#include "chartview.hpp"
+
+class ChartWindow : public QDockWidget
+{
+	Q_OBJECT
+
+public:
+	ChartWindow(QWidget *parent, const LogTableModel *model);
+
+public slots:
+	inline void setCurrentRow(int row) { chartView->setCurrentRow(row); }
+
+signals:
+	void aboutToClose();
+	void rowClicked(int row);
+
+protected:
+	void closeEvent(QCloseEvent *event) override;
+
+private slots:
+	void fieldChanged(int index);
+	void axisChanged(int index);
+	void logColumnsChanged();
+
+private:
+	const LogTableModel *logTableModel;
+
+	QComboBox *fieldCombo;
+	QComboBox *axisCombo;
+	ChartView *chartView;
+
+	void setupUi();
+};
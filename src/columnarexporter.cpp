@@ -0,0 +1,502 @@
+#include <cstring>
+#include <limits>
+#include "columnarexporter.hpp"
+
+static const char Magic[8] = {'Q', 'C', 'R', '2', 'C', 'O', 'L', 'S'};
+static const quint32 FormatVersion = 1;
+static const quint32 PrePlayerMoveFlag = 1 << 0;
+static const int Alignment = 64;
+static const int HeaderSize = 64;
+static const int SectionEntrySize = 64;
+static const int SectionNameSize = 32;
+static const int BufferSize = 1 << 20;
+static const float NaN = std::numeric_limits<float>::quiet_NaN();
+
+// Sections after the log fields, which come first and keep their LogField numbers.
+enum ColumnarSection {
+	TimeSection = LogFieldCount,
+	PhysicsFrameSection,
+	CommandFrameSection,
+	SharedSeedSection,
+	NonSharedRNGSection,
+	PrePositionSection,
+	PreVelocitySection,
+	PreBaseVelocitySection,
+	PreOnGroundSection,
+	PreOnLadderSection,
+	PreDuckStateSection,
+	PreWaterLevelSection,
+	PostPositionSection,
+	PostVelocitySection,
+	PostBaseVelocitySection,
+	PostOnGroundSection,
+	PostOnLadderSection,
+	PostDuckStateSection,
+	PostWaterLevelSection,
+	DamageRowsSection,
+	DamageAmountSection,
+	DamageBitsSection,
+	DamageDirectionSection,
+	CollisionRowsSection,
+	CollisionEntitySection,
+	CollisionNormalSection,
+	CollisionImpactVelocitySection,
+	ObjectMoveRowsSection,
+	ObjectMovePullSection,
+	ObjectMoveVelocitySection,
+	ObjectMovePositionSection,
+	ConsolePrintRowsSection,
+	ConsolePrintTextOffsetsSection,
+	ConsolePrintTextSection,
+	CommandBufferTextOffsetsSection,
+	CommandBufferTextSection,
+	ColumnarSectionCount
+};
+
+enum ElementType {
+	Float32Element = 1,
+	Float64Element,
+	Int32Element,
+	UInt32Element,
+	UInt64Element,
+	UInt8Element
+};
+
+static const int ElementSizeList[] = {0, 4, 8, 4, 4, 8, 1};
+
+// What the number of elements of a section is counted in.
+enum SectionLength {
+	RowLength = 0,
+	RowSpanLength,
+	DamageLength,
+	CollisionLength,
+	ObjectMoveLength,
+	ConsolePrintLength,
+	ConsolePrintSpanLength,
+	ConsolePrintTextLength,
+	PhysicsFrameSpanLength,
+	CommandBufferTextLength,
+	SectionLengthCount
+};
+
+struct SectionInfo
+{
+	const char *name;
+	ElementType type;
+	int width;
+	SectionLength length;
+};
+
+static const SectionInfo SectionInfoList[] = {
+	{"time", Float64Element, 1, RowLength},
+	{"phy", UInt32Element, 1, RowLength},
+	{"cmd", UInt8Element, 1, RowLength},
+	{"seed", UInt32Element, 1, RowLength},
+	{"idum", Int32Element, 1, RowLength},
+	{"pre.position", Float32Element, 3, RowLength},
+	{"pre.velocity", Float32Element, 3, RowLength},
+	{"pre.basevelocity", Float32Element, 3, RowLength},
+	{"pre.onground", UInt8Element, 1, RowLength},
+	{"pre.onladder", UInt8Element, 1, RowLength},
+	{"pre.duckstate", Int32Element, 1, RowLength},
+	{"pre.waterlevel", Int32Element, 1, RowLength},
+	{"post.position", Float32Element, 3, RowLength},
+	{"post.velocity", Float32Element, 3, RowLength},
+	{"post.basevelocity", Float32Element, 3, RowLength},
+	{"post.onground", UInt8Element, 1, RowLength},
+	{"post.onladder", UInt8Element, 1, RowLength},
+	{"post.duckstate", Int32Element, 1, RowLength},
+	{"post.waterlevel", Int32Element, 1, RowLength},
+	{"damage.rows", UInt64Element, 1, RowSpanLength},
+	{"damage.amount", Float32Element, 1, DamageLength},
+	{"damage.bits", Int32Element, 1, DamageLength},
+	{"damage.direction", Float32Element, 3, DamageLength},
+	{"collision.rows", UInt64Element, 1, RowSpanLength},
+	{"collision.entity", Int32Element, 1, CollisionLength},
+	{"collision.normal", Float32Element, 3, CollisionLength},
+	{"collision.impact_velocity", Float32Element, 3, CollisionLength},
+	{"objmove.rows", UInt64Element, 1, RowSpanLength},
+	{"objmove.pull", UInt8Element, 1, ObjectMoveLength},
+	{"objmove.velocity", Float32Element, 3, ObjectMoveLength},
+	{"objmove.position", Float32Element, 3, ObjectMoveLength},
+	{"print.rows", UInt64Element, 1, RowSpanLength},
+	{"print.text_offsets", UInt64Element, 1, ConsolePrintSpanLength},
+	{"print.text", UInt8Element, 1, ConsolePrintTextLength},
+	{"cmdbuf.text_offsets", UInt64Element, 1, PhysicsFrameSpanLength},
+	{"cmdbuf.text", UInt8Element, 1, CommandBufferTextLength},
+};
+
+static SectionInfo sectionInfo(int section)
+{
+	if (section < LogFieldCount) {
+		const SectionInfo info = {nullptr, Float32Element, 1, RowLength};
+		return info;
+	}
+	return SectionInfoList[section - LogFieldCount];
+}
+
+static QByteArray sectionName(int section)
+{
+	if (section < LogFieldCount)
+		return LogFieldNameList[section].toLatin1();
+	return SectionInfoList[section - LogFieldCount].name;
+}
+
+static quint64 alignedSize(quint64 size)
+{
+	return (size + Alignment - 1) / Alignment * Alignment;
+}
+
+// Appends little-endian values to a buffer that is flushed to the device whenever it fills.
+// Once writing fails or the export is canceled, everything further is dropped.
+class ColumnarWriter
+{
+public:
+	ColumnarWriter(QIODevice *device, const QAtomicInt *canceled)
+		: device(device), canceled(canceled), buffer(BufferSize, Qt::Uninitialized)
+	{
+	}
+
+	inline bool failed() const { return _failed; }
+	inline bool wasCanceled() const { return _canceled; }
+
+	void appendBytes(const void *data, quint64 size)
+	{
+		if (used + size > BufferSize) {
+			flush();
+			// Large arrays skip the buffer.
+			if (size >= BufferSize) {
+				if (!_failed && !_canceled) {
+					const qint64 result = device->write(static_cast<const char *>(data), size);
+					_failed = result != static_cast<qint64>(size);
+				}
+				position += size;
+				return;
+			}
+		}
+		memcpy(buffer.data() + used, data, size);
+		used += size;
+		position += size;
+	}
+
+	inline void appendUInt8(quint8 value) { appendBytes(&value, 1); }
+
+	template <typename T>
+	inline void appendInteger(T value)
+	{
+		const T littleEndian = qToLittleEndian(value);
+		appendBytes(&littleEndian, sizeof(littleEndian));
+	}
+
+	inline void appendFloat32(float value)
+	{
+		quint32 bits;
+		memcpy(&bits, &value, sizeof(bits));
+		appendInteger(bits);
+	}
+
+	inline void appendFloat64(double value)
+	{
+		quint64 bits;
+		memcpy(&bits, &value, sizeof(bits));
+		appendInteger(bits);
+	}
+
+	inline void appendVector(const float vector[3])
+	{
+		for (int i = 0; i < 3; i++)
+			appendFloat32(vector[i]);
+	}
+
+	// Pads with zeros up to the start of the next section.
+	void pad()
+	{
+		static const char zeros[Alignment] = {};
+		appendBytes(zeros, alignedSize(position) - position);
+	}
+
+	void flush()
+	{
+		if (!_failed && !_canceled && canceled && canceled->load())
+			_canceled = true;
+		if (!_failed && !_canceled && used)
+			_failed = device->write(buffer.constData(), used) != static_cast<qint64>(used);
+		used = 0;
+	}
+
+private:
+	QIODevice *device;
+	const QAtomicInt *canceled;
+	QByteArray buffer;
+	quint64 used = 0;
+	quint64 position = 0;
+	bool _failed = false;
+	bool _canceled = false;
+};
+
+// Returns the number of events of the type on a row. Rows without command frames have a
+// null command frame.
+static quint64 rowEventCount(int section, const TASLogger::ReaderPhysicsFrame &phy,
+	const TASLogger::ReaderCommandFrame *cmd, bool firstRowOfFrame)
+{
+	if (section == CollisionRowsSection)
+		return cmd ? cmd->collisionList.size() : 0;
+	if (!firstRowOfFrame)
+		return 0;
+	switch (section) {
+	case DamageRowsSection:
+		return phy.damageList.size();
+	case ObjectMoveRowsSection:
+		return phy.objectMoveList.size();
+	default:
+		return phy.consolePrintList.size();
+	}
+}
+
+static void writeEventRows(ColumnarWriter &writer, const TASLogger::TASLog &tasLog, int section)
+{
+	quint64 total = 0;
+	writer.appendInteger<quint64>(total);
+	for (const TASLogger::ReaderPhysicsFrame &phy : tasLog.physicsFrameList) {
+		if (phy.commandFrameList.empty()) {
+			total += rowEventCount(section, phy, nullptr, true);
+			writer.appendInteger<quint64>(total);
+			continue;
+		}
+
+		bool firstRowOfFrame = true;
+		for (const TASLogger::ReaderCommandFrame &cmd : phy.commandFrameList) {
+			total += rowEventCount(section, phy, &cmd, firstRowOfFrame);
+			writer.appendInteger<quint64>(total);
+			firstRowOfFrame = false;
+		}
+	}
+}
+
+// Writes a section of the pre-PM or post-PM player states.
+static void writePlayerStates(ColumnarWriter &writer, const LogDocument &document, int section)
+{
+	static const float NaNVector[3] = {NaN, NaN, NaN};
+	const bool pre = section < PostPositionSection;
+	const int preSection = pre ? section : section - (PostPositionSection - PrePositionSection);
+	for (int row = 0; row < document.rowCount(); row++) {
+		const TASLogger::ReaderCommandFrame *cmdFrame = document.frameAt(row).cmdFrame;
+		const TASLogger::ReaderPlayerState *pm = !cmdFrame ? nullptr
+			: pre ? &cmdFrame->prePMState : &cmdFrame->postPMState;
+		switch (preSection) {
+		case PrePositionSection:
+			writer.appendVector(pm ? pm->position : NaNVector);
+			break;
+		case PreVelocitySection:
+			writer.appendVector(pm ? pm->velocity : NaNVector);
+			break;
+		case PreBaseVelocitySection:
+			writer.appendVector(pm ? pm->baseVelocity : NaNVector);
+			break;
+		case PreOnGroundSection:
+			writer.appendUInt8(pm && pm->onGround);
+			break;
+		case PreOnLadderSection:
+			writer.appendUInt8(pm && pm->onLadder);
+			break;
+		case PreDuckStateSection:
+			writer.appendInteger<qint32>(pm ? pm->duckState : 0);
+			break;
+		case PreWaterLevelSection:
+			writer.appendInteger<qint32>(pm ? pm->waterLevel : 0);
+			break;
+		}
+	}
+}
+
+ColumnarExporter::ColumnarExporter(const LogDocument &document)
+	: document(document)
+{
+}
+
+bool ColumnarExporter::write(QIODevice *device, QString *errorMessage,
+	const QAtomicInt *canceled) const
+{
+	const TASLogger::TASLog &tasLog = document.tasLog();
+	const int rowCount = document.rowCount();
+
+	quint64 lengthList[SectionLengthCount] = {};
+	lengthList[RowLength] = rowCount;
+	lengthList[RowSpanLength] = rowCount + 1;
+	for (const TASLogger::ReaderPhysicsFrame &phy : tasLog.physicsFrameList) {
+		lengthList[DamageLength] += phy.damageList.size();
+		lengthList[ObjectMoveLength] += phy.objectMoveList.size();
+		lengthList[ConsolePrintLength] += phy.consolePrintList.size();
+		for (const std::string &text : phy.consolePrintList)
+			lengthList[ConsolePrintTextLength] += text.size();
+		for (const TASLogger::ReaderCommandFrame &cmd : phy.commandFrameList)
+			lengthList[CollisionLength] += cmd.collisionList.size();
+		lengthList[CommandBufferTextLength] += phy.commandBuffer.size();
+	}
+	lengthList[ConsolePrintSpanLength] = lengthList[ConsolePrintLength] + 1;
+	lengthList[PhysicsFrameSpanLength] = tasLog.physicsFrameList.size() + 1;
+
+	ColumnarWriter writer(device, canceled);
+	writer.appendBytes(Magic, sizeof(Magic));
+	writer.appendInteger<quint32>(FormatVersion);
+	writer.appendInteger<quint32>(ColumnarSectionCount);
+	writer.appendInteger<quint64>(rowCount);
+	writer.appendInteger<quint64>(tasLog.physicsFrameList.size());
+	writer.appendInteger<quint64>(HeaderSize);
+	writer.appendInteger<quint32>(document.prePlayerMove() ? PrePlayerMoveFlag : 0);
+	writer.pad();
+
+	quint64 offset = alignedSize(HeaderSize + ColumnarSectionCount * SectionEntrySize);
+	for (int section = 0; section < ColumnarSectionCount; section++) {
+		const SectionInfo info = sectionInfo(section);
+		const quint64 length = lengthList[info.length];
+		const QByteArray name = sectionName(section).leftJustified(SectionNameSize, '\0', true);
+		writer.appendBytes(name.constData(), SectionNameSize);
+		writer.appendInteger<quint32>(info.type);
+		writer.appendInteger<quint32>(info.width);
+		writer.appendInteger<quint64>(offset);
+		writer.appendInteger<quint64>(length);
+		writer.appendInteger<quint64>(0);
+		offset += alignedSize(length * info.width * ElementSizeList[info.type]);
+	}
+	writer.pad();
+
+	const LogColumns &columns = document.logColumns();
+	const GameTimeIndex &timeIndex = document.gameTimeIndex();
+	for (int section = 0; section < ColumnarSectionCount; section++) {
+		if (section < LogFieldCount) {
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+			writer.appendBytes(columns.field(section), quint64(rowCount) * sizeof(float));
+#else
+			for (int row = 0; row < rowCount; row++)
+				writer.appendFloat32(columns.value(section, row));
+#endif
+			writer.pad();
+			continue;
+		}
+		if (section >= PrePositionSection && section <= PostWaterLevelSection) {
+			writePlayerStates(writer, document, section);
+			writer.pad();
+			continue;
+		}
+
+		switch (section) {
+		case TimeSection:
+			for (int row = 0; row < rowCount; row++)
+				writer.appendFloat64(timeIndex.timeAt(document.physicsFrameIndex(row)));
+			break;
+		case PhysicsFrameSection:
+			for (int row = 0; row < rowCount; row++)
+				writer.appendInteger<quint32>(document.physicsFrameIndex(row));
+			break;
+		case CommandFrameSection:
+			for (int row = 0; row < rowCount; row++)
+				writer.appendUInt8(document.frameAt(row).cmdFrame != nullptr);
+			break;
+		case SharedSeedSection:
+			for (int row = 0; row < rowCount; row++) {
+				const TASLogger::ReaderCommandFrame *cmdFrame = document.frameAt(row).cmdFrame;
+				writer.appendInteger<quint32>(cmdFrame ? cmdFrame->sharedSeed : 0);
+			}
+			break;
+		case NonSharedRNGSection:
+			for (int row = 0; row < rowCount; row++)
+				writer.appendInteger<qint32>(document.frameAt(row).phyFrame->rng.idum);
+			break;
+		case DamageRowsSection:
+		case CollisionRowsSection:
+		case ObjectMoveRowsSection:
+		case ConsolePrintRowsSection:
+			writeEventRows(writer, tasLog, section);
+			break;
+		case DamageAmountSection:
+		case DamageBitsSection:
+		case DamageDirectionSection:
+			for (const TASLogger::ReaderPhysicsFrame &phy : tasLog.physicsFrameList) {
+				for (const TASLogger::ReaderDamage &dmg : phy.damageList) {
+					if (section == DamageAmountSection)
+						writer.appendFloat32(dmg.damage);
+					else if (section == DamageBitsSection)
+						writer.appendInteger<qint32>(dmg.damageBits);
+					else
+						writer.appendVector(dmg.direction);
+				}
+			}
+			break;
+		case CollisionEntitySection:
+		case CollisionNormalSection:
+		case CollisionImpactVelocitySection:
+			for (const TASLogger::ReaderPhysicsFrame &phy : tasLog.physicsFrameList) {
+				for (const TASLogger::ReaderCommandFrame &cmd : phy.commandFrameList) {
+					for (const TASLogger::ReaderCollision &col : cmd.collisionList) {
+						if (section == CollisionEntitySection)
+							writer.appendInteger<qint32>(col.entity);
+						else if (section == CollisionNormalSection)
+							writer.appendVector(col.normal);
+						else
+							writer.appendVector(col.impactVelocity);
+					}
+				}
+			}
+			break;
+		case ObjectMovePullSection:
+		case ObjectMoveVelocitySection:
+		case ObjectMovePositionSection:
+			for (const TASLogger::ReaderPhysicsFrame &phy : tasLog.physicsFrameList) {
+				for (const TASLogger::ReaderObjectMove &obj : phy.objectMoveList) {
+					if (section == ObjectMovePullSection)
+						writer.appendUInt8(obj.pull);
+					else if (section == ObjectMoveVelocitySection)
+						writer.appendVector(obj.velocity);
+					else
+						writer.appendVector(obj.position);
+				}
+			}
+			break;
+		case ConsolePrintTextOffsetsSection: {
+			quint64 textOffset = 0;
+			writer.appendInteger<quint64>(textOffset);
+			for (const TASLogger::ReaderPhysicsFrame &phy : tasLog.physicsFrameList) {
+				for (const std::string &text : phy.consolePrintList) {
+					textOffset += text.size();
+					writer.appendInteger<quint64>(textOffset);
+				}
+			}
+			break;
+		}
+		case ConsolePrintTextSection:
+			for (const TASLogger::ReaderPhysicsFrame &phy : tasLog.physicsFrameList) {
+				for (const std::string &text : phy.consolePrintList)
+					writer.appendBytes(text.data(), text.size());
+			}
+			break;
+		case CommandBufferTextOffsetsSection: {
+			quint64 textOffset = 0;
+			writer.appendInteger<quint64>(textOffset);
+			for (const TASLogger::ReaderPhysicsFrame &phy : tasLog.physicsFrameList) {
+				textOffset += phy.commandBuffer.size();
+				writer.appendInteger<quint64>(textOffset);
+			}
+			break;
+		}
+		case CommandBufferTextSection:
+			for (const TASLogger::ReaderPhysicsFrame &phy : tasLog.physicsFrameList)
+				writer.appendBytes(phy.commandBuffer.data(), phy.commandBuffer.size());
+			break;
+		}
+		writer.pad();
+	}
+	writer.flush();
+
+	if (writer.wasCanceled()) {
+		if (errorMessage)
+			*errorMessage = "The export was canceled.";
+		return false;
+	}
+	if (writer.failed()) {
+		if (errorMessage)
+			*errorMessage = device->errorString();
+		return false;
+	}
+	return true;
+}
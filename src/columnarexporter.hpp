@@ -0,0 +1,98 @@
+#pragma once
+
+#include <QtCore>
+#include "logdocument.hpp"
+
+// Writes the frame data of a log in a self-describing columnar binary format, so that
+// external tools can map the file and read the arrays in place without parsing.
+//
+// All integers and floats are little-endian, and every section starts at a multiple of
+// 64 bytes from the start of the file, padded with zeros.
+//
+// The file begins with a 64-byte header:
+//
+//	offset	type		content
+//	0	char[8]		magic "QCR2COLS"
+//	8	u32		format version, currently 1
+//	12	u32		number of sections
+//	16	u64		number of rows
+//	24	u64		number of physics frames
+//	32	u64		offset of the section table
+//	40	u32		flags, bit 0 set if the player states are pre-PM
+//	44	u8[20]		reserved
+//
+// The section table has one 64-byte entry per section:
+//
+//	offset	type		content
+//	0	char[32]	name, padded with NULs
+//	32	u32		element type: 1 f32, 2 f64, 3 i32, 4 u32, 5 u64, 6 u8
+//	36	u32		values per element, e.g. 3 for vectors
+//	40	u64		offset of the section
+//	48	u64		number of elements
+//	56	u8[8]		reserved
+//
+// Sections with one element per row, in the row order of the log table:
+//
+//	<field>		f32	every log field under its expression name, e.g. "vx", NaN where
+//				a command frame field is absent
+//	time		f64	game time at the start of the physics frame of the row
+//	phy		u32	physics frame of the row
+//	cmd		u8	1 if the row has a command frame, otherwise 0
+//	seed		u32	shared seed, 0 on rows without a command frame
+//	idum		i32	non-shared RNG state
+//
+// Both player states of the command frame of each row, whichever the log fields are built
+// from, with NaN or 0 on rows without a command frame:
+//
+//	pre.position		f32 x 3
+//	pre.velocity		f32 x 3
+//	pre.basevelocity	f32 x 3
+//	pre.onground		u8
+//	pre.onladder		u8
+//	pre.duckstate		i32
+//	pre.waterlevel		i32
+//	post.*			the same sections for the post-PM state
+//
+// Events are stored as spans per row. The "<event>.rows" section has one more element
+// than there are rows, and the events of row r are the elements [rows[r], rows[r + 1]) of
+// every other "<event>." section. As in the log table, events of a physics frame belong to
+// its first row and collisions to the row of their command frame.
+//
+//	damage.rows			u64
+//	damage.amount			f32
+//	damage.bits			i32
+//	damage.direction		f32 x 3
+//	collision.rows			u64
+//	collision.entity		i32
+//	collision.normal		f32 x 3
+//	collision.impact_velocity	f32 x 3
+//	objmove.rows			u64
+//	objmove.pull			u8	1 for a pull, 0 for a push
+//	objmove.velocity		f32 x 3
+//	objmove.position		f32 x 3
+//	print.rows			u64
+//	print.text_offsets		u64	one more element than there are prints, the
+//					text of print i being the bytes
+//					[text_offsets[i], text_offsets[i + 1])
+//	print.text			u8	UTF-8 text of the console prints
+//
+// The command buffers are stored per physics frame, that of frame p being the bytes
+// [cmdbuf.text_offsets[p], cmdbuf.text_offsets[p + 1]) of cmdbuf.text:
+//
+//	cmdbuf.text_offsets		u64	one more element than there are physics frames
+//	cmdbuf.text			u8	text of the command buffers
+//
+// Readers should look sections up by name, since later versions may add sections.
+class ColumnarExporter
+{
+public:
+	ColumnarExporter(const LogDocument &document);
+
+	// Returns false if writing failed or the export was canceled. The sections are streamed
+	// through a fixed buffer, so the memory used does not depend on the size of the log.
+	bool write(QIODevice *device, QString *errorMessage,
+		const QAtomicInt *canceled = nullptr) const;
+
+private:
+	const LogDocument &document;
+};
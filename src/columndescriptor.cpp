@@ -0,0 +1,453 @@
+#include <cmath>
+#include "columndescriptor.hpp"
+
+static const float M_U = 360.0 / 65536;
+static const QString BaseVelFormat = "*%1";
+static const QColor CollisionColor(255, 233, 186);
+static const QColor CmdAbsentColor(240, 240, 240);
+static const QColor LadderColor(125, 58, 19);
+
+static const char FSULetterList[][2] = {{'B', 'F'}, {'L', 'R'}, {'D', 'U'}};
+
+// Accessors shared by several columns.
+
+template<Qt::GlobalColor Color>
+static QVariant fixedForeground(const FrameRef &, const ColumnOptions &)
+{
+	return QColor(Color);
+}
+
+static QVariant cmdAbsentBackground(const FrameRef &frame, const ColumnOptions &)
+{
+	if (!frame.cmdFrame)
+		return CmdAbsentColor;
+	return QVariant();
+}
+
+template<int Button, Qt::GlobalColor Color>
+static QVariant buttonBackground(const FrameRef &frame, const ColumnOptions &)
+{
+	if (!frame.cmdFrame)
+		return CmdAbsentColor;
+	if (!(frame.cmdFrame->buttons & Button))
+		return QVariant();
+	return QColor(Color);
+}
+
+static QVariant centerAlignment(const FrameRef &, const ColumnOptions &)
+{
+	return Qt::AlignCenter;
+}
+
+static QVariant objectMoveForeground(const FrameRef &frame, const ColumnOptions &)
+{
+	if (frame.phyFrame->objectMoveList.empty())
+		return QVariant();
+	return QColor(Qt::blue);
+}
+
+static QVariant objectMoveFont(const FrameRef &frame, const ColumnOptions &)
+{
+	static const QFont boldFont = QFont(QString(), -1, QFont::Bold);
+	if (frame.phyFrame->objectMoveList.empty())
+		return QVariant();
+	return boldFont;
+}
+
+static QVariant damageForeground(const FrameRef &frame, const ColumnOptions &)
+{
+	if (frame.phyFrame->damageList.empty())
+		return QVariant();
+	return QColor(Qt::white);
+}
+
+static QVariant damageBackground(const FrameRef &frame, const ColumnOptions &)
+{
+	if (!frame.cmdFrame)
+		return CmdAbsentColor;
+	if (frame.phyFrame->damageList.empty())
+		return QVariant();
+	return QColor(Qt::red);
+}
+
+static QVariant damageFont(const FrameRef &frame, const ColumnOptions &)
+{
+	static const QFont boldFont = QFont(QString(), -1, QFont::Bold);
+	if (frame.phyFrame->damageList.empty())
+		return QVariant();
+	return boldFont;
+}
+
+// Whether the player collided with a surface whose normal has a component along the axes.
+template<bool Horizontal>
+static QVariant collisionBackground(const FrameRef &frame, const ColumnOptions &)
+{
+	if (!frame.cmdFrame)
+		return CmdAbsentColor;
+	for (const TASLogger::ReaderCollision &col : frame.cmdFrame->collisionList) {
+		if (Horizontal ? col.normal[0] != 0.0 || col.normal[1] != 0.0 : col.normal[2] != 0.0)
+			return CollisionColor;
+	}
+	return QVariant();
+}
+
+template<int Axis>
+static QVariant fsuDisplay(const FrameRef &frame, const ColumnOptions &options)
+{
+	if (!frame.cmdFrame || frame.cmdFrame->FSU[Axis] == 0.0)
+		return QVariant();
+	if (options.showFSUValues)
+		return frame.cmdFrame->FSU[Axis];
+	return QString(QLatin1Char(FSULetterList[Axis][frame.cmdFrame->FSU[Axis] > 0]));
+}
+
+template<int Axis>
+static QVariant fsuForeground(const FrameRef &frame, const ColumnOptions &)
+{
+	if (!frame.cmdFrame || frame.cmdFrame->FSU[Axis] == 0.0)
+		return QVariant();
+	return QColor(Qt::white);
+}
+
+template<int Axis>
+static QVariant fsuBackground(const FrameRef &frame, const ColumnOptions &)
+{
+	if (!frame.cmdFrame)
+		return CmdAbsentColor;
+	if (frame.cmdFrame->FSU[Axis] == 0.0)
+		return QVariant();
+	return QColor(frame.cmdFrame->FSU[Axis] > 0 ? Qt::blue : Qt::red);
+}
+
+template<int Axis>
+static QVariant viewangleDisplay(const FrameRef &frame, const ColumnOptions &options)
+{
+	if (!frame.cmdFrame)
+		return QVariant();
+	if (options.showAnglemodUnit)
+		return QString("%1u").arg(frame.cmdFrame->viewangles[Axis] / M_U);
+	return frame.cmdFrame->viewangles[Axis];
+}
+
+template<int Axis>
+static QVariant punchangleBackground(const FrameRef &frame, const ColumnOptions &)
+{
+	if (!frame.cmdFrame)
+		return CmdAbsentColor;
+	if (frame.cmdFrame->punchangles[Axis] == 0.0)
+		return QVariant();
+	return QColor(Qt::yellow);
+}
+
+template<int Axis>
+static QVariant positionDisplay(const FrameRef &frame, const ColumnOptions &)
+{
+	if (!frame.cmdFrame)
+		return QVariant();
+	return frame.pmState->position[Axis];
+}
+
+// Accessors of single columns.
+
+static QVariant physicsFrameTimeDisplay(const FrameRef &frame, const ColumnOptions &options)
+{
+	if (options.hideMostCommonFrameTimes
+		&& frame.phyFrame->frameTime == options.mostCommonFrameTimes)
+		return QVariant();
+	return frame.phyFrame->frameTime;
+}
+
+static QVariant physicsFrameTimeForeground(const FrameRef &frame, const ColumnOptions &)
+{
+	return QColor(frame.phyFrame->consolePrintList.empty() ? Qt::darkGray : Qt::white);
+}
+
+static QVariant physicsFrameTimeBackground(const FrameRef &frame, const ColumnOptions &)
+{
+	if (frame.phyFrame->consolePrintList.empty())
+		return QVariant();
+	return QColor(Qt::darkGray);
+}
+
+static QVariant commandFrameTimeDisplay(const FrameRef &frame, const ColumnOptions &options)
+{
+	if (!frame.cmdFrame || (options.hideMostCommonFrameTimes
+		&& frame.cmdFrame->msec == options.mostCommonMsec))
+		return QVariant();
+	return frame.cmdFrame->msec;
+}
+
+static QVariant framebulkIdDisplay(const FrameRef &frame, const ColumnOptions &)
+{
+	if (!frame.cmdFrame)
+		return QVariant();
+	return frame.cmdFrame->framebulkId;
+}
+
+static QVariant horizontalSpeedDisplay(const FrameRef &frame, const ColumnOptions &)
+{
+	if (!frame.cmdFrame)
+		return QVariant();
+	const TASLogger::ReaderPlayerState *pmState = frame.pmState;
+	const bool hbasevelExist = pmState->baseVelocity[0] != 0.0
+		|| pmState->baseVelocity[1] != 0.0;
+	if (pmState->velocity[0] == 0.0 && pmState->velocity[1] == 0.0
+		&& !hbasevelExist
+		&& frame.phyFrame->objectMoveList.empty())
+		return QVariant();
+	const float hspeed = std::hypot(pmState->velocity[0], pmState->velocity[1]);
+	if (hbasevelExist)
+		return BaseVelFormat.arg(hspeed);
+	else
+		return hspeed;
+}
+
+static QVariant velocityAngleDisplay(const FrameRef &frame, const ColumnOptions &)
+{
+	const TASLogger::ReaderPlayerState *pmState = frame.pmState;
+	if (!frame.cmdFrame || (pmState->velocity[0] == 0.0 && pmState->velocity[1] == 0.0))
+		return QVariant();
+	return std::atan2(pmState->velocity[1], pmState->velocity[0]) * 180 / M_PI;
+}
+
+static QVariant verticalSpeedDisplay(const FrameRef &frame, const ColumnOptions &)
+{
+	const TASLogger::ReaderPlayerState *pmState = frame.pmState;
+	if (!frame.cmdFrame || (pmState->velocity[2] == 0.0 && pmState->baseVelocity[2] == 0.0))
+		return QVariant();
+	if (pmState->baseVelocity[2] != 0.0)
+		return BaseVelFormat.arg(pmState->velocity[2]);
+	else
+		return pmState->velocity[2];
+}
+
+static QVariant verticalSpeedForeground(const FrameRef &frame, const ColumnOptions &)
+{
+	if (!frame.cmdFrame || frame.pmState->velocity[2] == 0.0)
+		return QVariant();
+	return QColor(frame.pmState->velocity[2] > 0.0 ? Qt::blue : Qt::red);
+}
+
+static QVariant onGroundBackground(const FrameRef &frame, const ColumnOptions &)
+{
+	if (!frame.cmdFrame)
+		return CmdAbsentColor;
+	if (!frame.pmState->onGround)
+		return QVariant();
+	return QColor(Qt::green);
+}
+
+static QVariant duckStateBackground(const FrameRef &frame, const ColumnOptions &)
+{
+	if (!frame.cmdFrame)
+		return CmdAbsentColor;
+	if (frame.pmState->duckState == TASLogger::UNDUCKED)
+		return QVariant();
+	return QColor(frame.pmState->duckState == TASLogger::INDUCK ? Qt::gray : Qt::black);
+}
+
+static QVariant healthDisplay(const FrameRef &frame, const ColumnOptions &)
+{
+	if (!frame.cmdFrame)
+		return QVariant();
+	return frame.cmdFrame->health;
+}
+
+static QVariant armorDisplay(const FrameRef &frame, const ColumnOptions &)
+{
+	if (!frame.cmdFrame)
+		return QVariant();
+	return frame.cmdFrame->armor;
+}
+
+static QVariant onLadderBackground(const FrameRef &frame, const ColumnOptions &)
+{
+	if (!frame.cmdFrame)
+		return CmdAbsentColor;
+	if (!frame.pmState->onLadder)
+		return QVariant();
+	return LadderColor;
+}
+
+static QVariant waterLevelBackground(const FrameRef &frame, const ColumnOptions &)
+{
+	if (!frame.cmdFrame)
+		return CmdAbsentColor;
+	if (!frame.pmState->waterLevel)
+		return QVariant();
+	return QColor(frame.pmState->waterLevel == 1 ? Qt::blue : Qt::darkBlue);
+}
+
+static QVariant clientStateDisplay(const FrameRef &frame, const ColumnOptions &)
+{
+	return frame.phyFrame->clientState;
+}
+
+static QVariant clientStateForeground(const FrameRef &frame, const ColumnOptions &)
+{
+	if (frame.phyFrame->paused)
+		return QColor(Qt::white);
+	else
+		return QColor(frame.phyFrame->clientState == 5 ? Qt::darkGray : Qt::red);
+}
+
+static QVariant clientStateBackground(const FrameRef &frame, const ColumnOptions &)
+{
+	if (!frame.phyFrame->paused)
+		return QVariant();
+	return QColor(Qt::darkCyan);
+}
+
+static QVariant clientStateFont(const FrameRef &frame, const ColumnOptions &)
+{
+	static const QFont boldFont = QFont(QString(), -1, QFont::Bold);
+	if (frame.phyFrame->clientState == 5)
+		return QVariant();
+	return boldFont;
+}
+
+static QVariant frameTimeRemainderDisplay(const FrameRef &frame, const ColumnOptions &)
+{
+	if (!frame.cmdFrame)
+		return QVariant();
+	return QString::number(frame.cmdFrame->frameTimeRemainder, 'e', 3);
+}
+
+static QVariant frameTimeRemainderForeground(const FrameRef &frame, const ColumnOptions &)
+{
+	if (!frame.cmdFrame)
+		return QVariant();
+	return QColor(Qt::darkGray);
+}
+
+static QVariant entityFrictionBackground(const FrameRef &frame, const ColumnOptions &)
+{
+	if (!frame.cmdFrame)
+		return CmdAbsentColor;
+	if (frame.cmdFrame->entFriction == 1.0)
+		return QVariant();
+	return QColor(Qt::gray);
+}
+
+static QVariant entityGravityBackground(const FrameRef &frame, const ColumnOptions &)
+{
+	if (!frame.cmdFrame)
+		return CmdAbsentColor;
+	if (frame.cmdFrame->entGravity == 1.0)
+		return QVariant();
+	return QColor(Qt::gray);
+}
+
+static QVariant sharedSeedDisplay(const FrameRef &frame, const ColumnOptions &)
+{
+	if (!frame.cmdFrame)
+		return QVariant();
+	return frame.cmdFrame->sharedSeed;
+}
+
+static double sharedSeedSortKey(const FrameRef &frame)
+{
+	return frame.cmdFrame ? frame.cmdFrame->sharedSeed : NAN;
+}
+
+static QVariant nonSharedRNGParameterDisplay(const FrameRef &frame, const ColumnOptions &)
+{
+	return frame.phyFrame->rng.idum;
+}
+
+static double nonSharedRNGParameterSortKey(const FrameRef &frame)
+{
+	return frame.phyFrame->rng.idum;
+}
+
+static QVariant elapsedTimeDisplay(const FrameRef &frame, const ColumnOptions &)
+{
+	return frame.elapsedTime;
+}
+
+static double elapsedTimeSortKey(const FrameRef &frame)
+{
+	return frame.elapsedTime;
+}
+
+const ColumnDescriptor ColumnDescriptorList[] = {
+	{"ft", "Physics frametime", FrameTimeField, nullptr,
+		physicsFrameTimeDisplay, physicsFrameTimeForeground, physicsFrameTimeBackground,
+		nullptr, nullptr},
+	{"ms", "Command frametime", MsecField, nullptr,
+		commandFrameTimeDisplay, fixedForeground<Qt::darkGray>, cmdAbsentBackground,
+		nullptr, nullptr},
+	{"bid", "Framebulk ID", FramebulkIdField, nullptr,
+		framebulkIdDisplay, fixedForeground<Qt::darkGray>, cmdAbsentBackground,
+		nullptr, nullptr},
+	{"hspd", "Horizontal speed", HorizontalSpeedField, nullptr,
+		horizontalSpeedDisplay, objectMoveForeground, collisionBackground<true>,
+		objectMoveFont, nullptr},
+	{"vyaw", "Velocity yaw", VelocityYawField, nullptr,
+		velocityAngleDisplay, objectMoveForeground, collisionBackground<true>,
+		objectMoveFont, nullptr},
+	{"vspd", "Vertical speed", VelocityZField, nullptr,
+		verticalSpeedDisplay, verticalSpeedForeground, collisionBackground<false>,
+		nullptr, nullptr},
+	{"g", "Is on ground?", OnGroundField, nullptr,
+		nullptr, nullptr, onGroundBackground, nullptr, nullptr},
+	{"k", "Duck state", DuckStateField, nullptr,
+		nullptr, nullptr, duckStateBackground, nullptr, nullptr},
+	{"j", "Jump key", JumpField, nullptr,
+		nullptr, nullptr, buttonBackground<IN_JUMP, Qt::cyan>, nullptr, nullptr},
+	{"d", "Duck key", DuckField, nullptr,
+		nullptr, nullptr, buttonBackground<IN_DUCK, Qt::magenta>, nullptr, nullptr},
+	{"f", "Forward move", ForwardMoveField, nullptr,
+		fsuDisplay<0>, fsuForeground<0>, fsuBackground<0>, nullptr, centerAlignment},
+	{"s", "Side move", SideMoveField, nullptr,
+		fsuDisplay<1>, fsuForeground<1>, fsuBackground<1>, nullptr, centerAlignment},
+	{"u", "Up move", UpMoveField, nullptr,
+		fsuDisplay<2>, fsuForeground<2>, fsuBackground<2>, nullptr, centerAlignment},
+	{"y", "Yaw", YawField, nullptr,
+		viewangleDisplay<0>, nullptr, punchangleBackground<0>, nullptr, nullptr},
+	{"p", "Pitch", PitchField, nullptr,
+		viewangleDisplay<1>, nullptr, punchangleBackground<1>, nullptr, nullptr},
+	{"hp", "Health", HealthField, nullptr,
+		healthDisplay, damageForeground, damageBackground, damageFont, nullptr},
+	{"ap", "Armor", ArmorField, nullptr,
+		armorDisplay, damageForeground, damageBackground, damageFont, nullptr},
+	{"e", "Use key", UseField, nullptr,
+		nullptr, nullptr, buttonBackground<IN_USE, Qt::darkYellow>, nullptr, nullptr},
+	{"1", "Primary attack key", AttackField, nullptr,
+		nullptr, nullptr, buttonBackground<IN_ATTACK, Qt::darkYellow>, nullptr, nullptr},
+	{"2", "Second attack key", Attack2Field, nullptr,
+		nullptr, nullptr, buttonBackground<IN_ATTACK2, Qt::darkYellow>, nullptr, nullptr},
+	{"r", "Reload key", ReloadField, nullptr,
+		nullptr, nullptr, buttonBackground<IN_RELOAD, Qt::darkYellow>, nullptr, nullptr},
+	{"l", "Is on ladder?", OnLadderField, nullptr,
+		nullptr, nullptr, onLadderBackground, nullptr, nullptr},
+	{"w", "Water level", WaterLevelField, nullptr,
+		nullptr, nullptr, waterLevelBackground, nullptr, nullptr},
+	{"c", "Client state", ClientStateField, nullptr,
+		clientStateDisplay, clientStateForeground, clientStateBackground,
+		clientStateFont, nullptr},
+	{"rem", "Frametime remainder", FrameTimeRemainderField, nullptr,
+		frameTimeRemainderDisplay, frameTimeRemainderForeground, cmdAbsentBackground,
+		nullptr, nullptr},
+	{"ef", "Entity friction", EntityFrictionField, nullptr,
+		nullptr, nullptr, entityFrictionBackground, nullptr, nullptr},
+	{"eg", "Entity gravity", EntityGravityField, nullptr,
+		nullptr, nullptr, entityGravityBackground, nullptr, nullptr},
+	{"ss", "Shared seed", -1, sharedSeedSortKey,
+		sharedSeedDisplay, fixedForeground<Qt::darkGray>, cmdAbsentBackground,
+		nullptr, nullptr},
+	{"idum", "Non-shared RNG parameter", -1, nonSharedRNGParameterSortKey,
+		nonSharedRNGParameterDisplay, fixedForeground<Qt::darkGray>, cmdAbsentBackground,
+		nullptr, nullptr},
+	{"posz", "z position", PositionZField, nullptr,
+		positionDisplay<2>, nullptr, cmdAbsentBackground, nullptr, nullptr},
+	{"posx", "x position", PositionXField, nullptr,
+		positionDisplay<0>, nullptr, cmdAbsentBackground, nullptr, nullptr},
+	{"posy", "y position", PositionYField, nullptr,
+		positionDisplay<1>, nullptr, cmdAbsentBackground, nullptr, nullptr},
+	{"t", "Elapsed game time", -1, elapsedTimeSortKey,
+		elapsedTimeDisplay, nullptr, nullptr, nullptr, nullptr},
+};
+
+static_assert(sizeof(ColumnDescriptorList) / sizeof(ColumnDescriptorList[0])
+	== HorizontalHeaderCount, "Every column of HorizontalHeaderIndex needs a descriptor");
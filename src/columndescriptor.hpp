@@ -0,0 +1,73 @@
+#pragma once
+
+#include <QtWidgets>
+#include "logdocument.hpp"
+
+enum HorizontalHeaderIndex {
+	PhysicsFrameTimeHeader = 0,
+	CommandFrameTimeHeader,
+	FramebulkIdHeader,
+	HorizontalSpeedHeader,
+	VelocityAngleHeader,
+	VerticalSpeedHeader,
+	OnGroundHeader,
+	DuckStateHeader,
+	JumpHeader,
+	DuckHeader,
+	ForwardMoveHeader,
+	SideMoveHeader,
+	UpMoveHeader,
+	YawHeader,
+	PitchHeader,
+	HealthHeader,
+	ArmorHeader,
+	UseHeader,
+	AttackHeader,
+	Attack2Header,
+	ReloadHeader,
+	OnLadderHeader,
+	WaterLevelHeader,
+	ClientStateHeader,
+	FrameTimeRemainderHeader,
+	EntityFrictionHeader,
+	EntityGravityHeader,
+	SharedSeedHeader,
+	NonSharedRNGParameterHeader,
+	PositionZHeader,
+	PositionXHeader,
+	PositionYHeader,
+	ElapsedTimeHeader,
+	HorizontalHeaderCount
+};
+
+// The display options of the log table the cells depend on.
+struct ColumnOptions
+{
+	bool showAnglemodUnit = false;
+	bool showFSUValues = false;
+	bool hideMostCommonFrameTimes = false;
+	float mostCommonFrameTimes = 0;
+	int mostCommonMsec = 0;
+};
+
+typedef QVariant (*CellAccessor)(const FrameRef &frame, const ColumnOptions &options);
+typedef double (*SortKeyAccessor)(const FrameRef &frame);
+
+// Everything the log table knows about a column. A null accessor means the column has no data
+// for the role, so the row is not even looked up.
+struct ColumnDescriptor
+{
+	const char *name;
+	const char *description;
+	// The LogColumns field holding the values of the column, or -1.
+	int field;
+	// Sort key of the columns without a field, or null if the field is the sort key.
+	SortKeyAccessor sortKey;
+	CellAccessor display;
+	CellAccessor foreground;
+	CellAccessor background;
+	CellAccessor font;
+	CellAccessor alignment;
+};
+
+extern const ColumnDescriptor ColumnDescriptorList[];
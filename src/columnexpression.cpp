@@ -0,0 +1,418 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "columnexpression.hpp"
+
+static const int BatchSize = 4096;
+static const float NaN = std::numeric_limits<float>::quiet_NaN();
+
+static const QString PrevFunctionName = "prev";
+
+// Recursive descent parser appending the instructions of the expression to the program.
+class ColumnExpression::Parser
+{
+public:
+	Parser(const QString &text, QVector<Instruction> &program)
+		: text(text), program(program)
+	{
+	}
+
+	int parse(QString *errorMessage)
+	{
+		bool ok = parseSum();
+		skipSpace();
+		if (ok && pos < text.size())
+			ok = fail(QString("Unexpected '%1'").arg(text.mid(pos, 10)));
+		if (!ok && errorMessage)
+			*errorMessage = error;
+		return ok ? maxDepth : -1;
+	}
+
+private:
+	struct Function
+	{
+		const char *name;
+		int argumentCount;
+		OpCode op;
+	};
+
+	static const Function FunctionList[];
+
+	const QString &text;
+	QVector<Instruction> &program;
+	int pos = 0;
+	int rowOffset = 0;
+	int depth = 0;
+	int maxDepth = 0;
+	QString error;
+
+	bool fail(const QString &message)
+	{
+		if (error.isEmpty())
+			error = QString("%1 at column %2").arg(message).arg(pos + 1);
+		return false;
+	}
+
+	void skipSpace()
+	{
+		while (pos < text.size() && text.at(pos).isSpace())
+			++pos;
+	}
+
+	bool accept(char c)
+	{
+		skipSpace();
+		if (pos >= text.size() || text.at(pos) != QLatin1Char(c))
+			return false;
+		++pos;
+		return true;
+	}
+
+	void emitInstruction(OpCode op, int field = -1, float value = 0)
+	{
+		Instruction ins;
+		ins.op = op;
+		ins.field = field;
+		ins.rowOffset = rowOffset;
+		ins.value = value;
+		program.append(ins);
+
+		if (op == ConstantOp || op == FieldOp)
+			maxDepth = std::max(maxDepth, ++depth);
+		else if (op >= AddOp)
+			--depth;
+	}
+
+	bool parseSum()
+	{
+		if (!parseProduct())
+			return false;
+		for (;;) {
+			if (accept('+')) {
+				if (!parseProduct())
+					return false;
+				emitInstruction(AddOp);
+			} else if (accept('-')) {
+				if (!parseProduct())
+					return false;
+				emitInstruction(SubtractOp);
+			} else
+				return true;
+		}
+	}
+
+	bool parseProduct()
+	{
+		if (!parseUnary())
+			return false;
+		for (;;) {
+			if (accept('*')) {
+				if (!parseUnary())
+					return false;
+				emitInstruction(MultiplyOp);
+			} else if (accept('/')) {
+				if (!parseUnary())
+					return false;
+				emitInstruction(DivideOp);
+			} else
+				return true;
+		}
+	}
+
+	bool parseUnary()
+	{
+		if (accept('-')) {
+			if (!parseUnary())
+				return false;
+			emitInstruction(NegateOp);
+			return true;
+		}
+		if (accept('+'))
+			return parseUnary();
+		return parsePrimary();
+	}
+
+	bool isDigitAt(int i) const
+	{
+		return i < text.size() && text.at(i).isDigit();
+	}
+
+	bool parseNumber()
+	{
+		const int start = pos;
+		while (isDigitAt(pos) || (pos < text.size() && text.at(pos) == '.'))
+			++pos;
+		if (pos < text.size() && (text.at(pos) == 'e' || text.at(pos) == 'E')) {
+			const int sign = pos + 1 < text.size()
+				&& (text.at(pos + 1) == '-' || text.at(pos + 1) == '+') ? 1 : 0;
+			if (isDigitAt(pos + 1 + sign)) {
+				pos += 1 + sign;
+				while (isDigitAt(pos))
+					++pos;
+			}
+		}
+
+		bool ok = false;
+		const float value = text.mid(start, pos - start).toFloat(&ok);
+		if (!ok) {
+			pos = start;
+			return fail("Invalid number");
+		}
+		emitInstruction(ConstantOp, -1, value);
+		return true;
+	}
+
+	bool parseArguments(int count)
+	{
+		if (!accept('('))
+			return fail("Expected '('");
+		for (int i = 0; i < count; i++) {
+			if (i > 0 && !accept(','))
+				return fail("Expected ','");
+			if (!parseSum())
+				return false;
+		}
+		if (!accept(')'))
+			return fail("Expected ')'");
+		return true;
+	}
+
+	bool parsePrimary()
+	{
+		skipSpace();
+		if (pos >= text.size())
+			return fail("Unexpected end of expression");
+
+		if (text.at(pos).isDigit() || text.at(pos) == '.')
+			return parseNumber();
+
+		if (accept('(')) {
+			if (!parseSum())
+				return false;
+			if (!accept(')'))
+				return fail("Expected ')'");
+			return true;
+		}
+
+		const int start = pos;
+		while (pos < text.size() && (text.at(pos).isLetterOrNumber() || text.at(pos) == '_'))
+			++pos;
+		const QString name = text.mid(start, pos - start);
+		if (name.isEmpty())
+			return fail(QString("Unexpected '%1'").arg(text.at(pos)));
+
+		if (name == PrevFunctionName) {
+			++rowOffset;
+			const bool ok = parseArguments(1);
+			--rowOffset;
+			return ok;
+		}
+
+		for (const Function &function : FunctionList) {
+			if (name != QLatin1String(function.name))
+				continue;
+			if (!parseArguments(function.argumentCount))
+				return false;
+			emitInstruction(function.op);
+			return true;
+		}
+
+		const int field = findLogField(name);
+		if (field == -1) {
+			pos = start;
+			return fail(QString("Unknown name '%1'").arg(name));
+		}
+		emitInstruction(FieldOp, field);
+		return true;
+	}
+};
+
+const ColumnExpression::Parser::Function ColumnExpression::Parser::FunctionList[] = {
+	{"abs", 1, AbsOp},
+	{"sqrt", 1, SqrtOp},
+	{"sin", 1, SinOp},
+	{"cos", 1, CosOp},
+	{"tan", 1, TanOp},
+	{"floor", 1, FloorOp},
+	{"ceil", 1, CeilOp},
+	{"round", 1, RoundOp},
+	{"deg", 1, DegreesOp},
+	{"rad", 1, RadiansOp},
+	{"hypot", 2, HypotOp},
+	{"atan2", 2, Atan2Op},
+	{"min", 2, MinOp},
+	{"max", 2, MaxOp},
+	{"pow", 2, PowOp},
+};
+
+bool ColumnExpression::compile(const QString &text, QString *errorMessage)
+{
+	program.clear();
+	stackDepth = 0;
+	if (text.trimmed().isEmpty()) {
+		if (errorMessage)
+			*errorMessage = "Empty expression";
+		return false;
+	}
+
+	Parser parser(text, program);
+	stackDepth = parser.parse(errorMessage);
+	if (stackDepth == -1) {
+		program.clear();
+		stackDepth = 0;
+		return false;
+	}
+	return true;
+}
+
+void ColumnExpression::evaluateBatch(const LogColumns &columns, int first, int count,
+	QVector<QVector<float>> &stack) const
+{
+	int top = -1;
+	for (const Instruction &ins : program) {
+		if (ins.op == ConstantOp) {
+			float *out = stack[++top].data();
+			std::fill(out, out + count, ins.value);
+			continue;
+		}
+
+		if (ins.op == FieldOp) {
+			float *out = stack[++top].data();
+			const int shifted = first - ins.rowOffset;
+			int i = 0;
+			for (; i < count && shifted + i < 0; i++)
+				out[i] = NaN;
+			if (i < count) {
+				const float *in = columns.field(ins.field);
+				std::copy(in + shifted + i, in + shifted + count, out + i);
+			}
+			continue;
+		}
+
+		if (ins.op < AddOp) {
+			float *a = stack[top].data();
+			switch (ins.op) {
+			case NegateOp:
+				for (int i = 0; i < count; i++)
+					a[i] = -a[i];
+				break;
+			case AbsOp:
+				for (int i = 0; i < count; i++)
+					a[i] = std::fabs(a[i]);
+				break;
+			case SqrtOp:
+				for (int i = 0; i < count; i++)
+					a[i] = std::sqrt(a[i]);
+				break;
+			case SinOp:
+				for (int i = 0; i < count; i++)
+					a[i] = std::sin(a[i]);
+				break;
+			case CosOp:
+				for (int i = 0; i < count; i++)
+					a[i] = std::cos(a[i]);
+				break;
+			case TanOp:
+				for (int i = 0; i < count; i++)
+					a[i] = std::tan(a[i]);
+				break;
+			case FloorOp:
+				for (int i = 0; i < count; i++)
+					a[i] = std::floor(a[i]);
+				break;
+			case CeilOp:
+				for (int i = 0; i < count; i++)
+					a[i] = std::ceil(a[i]);
+				break;
+			case RoundOp:
+				for (int i = 0; i < count; i++)
+					a[i] = std::round(a[i]);
+				break;
+			case DegreesOp:
+				for (int i = 0; i < count; i++)
+					a[i] = a[i] * static_cast<float>(180 / M_PI);
+				break;
+			case RadiansOp:
+				for (int i = 0; i < count; i++)
+					a[i] = a[i] * static_cast<float>(M_PI / 180);
+				break;
+			default:
+				break;
+			}
+			continue;
+		}
+
+		float *a = stack[top - 1].data();
+		const float *b = stack[top].data();
+		--top;
+		switch (ins.op) {
+		case AddOp:
+			for (int i = 0; i < count; i++)
+				a[i] += b[i];
+			break;
+		case SubtractOp:
+			for (int i = 0; i < count; i++)
+				a[i] -= b[i];
+			break;
+		case MultiplyOp:
+			for (int i = 0; i < count; i++)
+				a[i] *= b[i];
+			break;
+		case DivideOp:
+			for (int i = 0; i < count; i++)
+				a[i] /= b[i];
+			break;
+		case HypotOp:
+			for (int i = 0; i < count; i++)
+				a[i] = std::sqrt(a[i] * a[i] + b[i] * b[i]);
+			break;
+		case Atan2Op:
+			for (int i = 0; i < count; i++)
+				a[i] = std::atan2(a[i], b[i]);
+			break;
+		// A comparison with NaN is false, so a blank b is picked explicitly. A blank a is
+		// kept by the comparison.
+		case MinOp:
+			for (int i = 0; i < count; i++)
+				a[i] = std::isnan(b[i]) || b[i] < a[i] ? b[i] : a[i];
+			break;
+		case MaxOp:
+			for (int i = 0; i < count; i++)
+				a[i] = std::isnan(b[i]) || b[i] > a[i] ? b[i] : a[i];
+			break;
+		case PowOp:
+			for (int i = 0; i < count; i++)
+				a[i] = std::pow(a[i], b[i]);
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+bool ColumnExpression::evaluate(const LogColumns &columns, QVector<float> &values,
+	const QAtomicInt *canceled, int firstRow) const
+{
+	const int rowCount = columns.rowCount();
+	values.resize(rowCount);
+	if (program.isEmpty()) {
+		std::fill(values.begin() + firstRow, values.end(), NaN);
+		return true;
+	}
+
+	QVector<QVector<float>> stack(stackDepth);
+	for (QVector<float> &slot : stack)
+		slot.resize(BatchSize);
+
+	for (int first = firstRow; first < rowCount; first += BatchSize) {
+		if (canceled && canceled->load())
+			return false;
+
+		const int count = std::min(BatchSize, rowCount - first);
+		evaluateBatch(columns, first, count, stack);
+		const float *result = stack.at(0).constData();
+		std::copy(result, result + count, values.data() + first);
+	}
+
+	return true;
+}
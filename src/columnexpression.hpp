@@ -0,0 +1,72 @@
+#pragma once
+
+#include <QtCore>
+#include "logcolumns.hpp"
+
+// Arithmetic expression over the log fields defining a computed column, such as
+// "hypot(vx, vy) - prev(hypot(vx, vy))" or "y - vyaw".
+//
+// An expression combines field names of LogFieldNameList and numbers with +, -, *, / and
+// parentheses, and calls the functions abs, sqrt, sin, cos, tan, floor, ceil, round (one
+// argument) and hypot, atan2, min, max, pow (two arguments). Angles are in radians, except
+// the deg and rad functions convert to and from degrees. prev(x) is x on the previous row.
+// Blank cells propagate as NaN.
+//
+// The expression is compiled once into a stack program. Each instruction runs over a batch
+// of rows at a time, so the program is interpreted once per batch rather than once per row
+// and the per-instruction loops vectorize.
+class ColumnExpression
+{
+public:
+	bool compile(const QString &text, QString *errorMessage);
+	inline bool isEmpty() const { return program.isEmpty(); }
+
+	// Evaluates the expression for every row from firstRow on into values. The earlier values
+	// are kept, as no row reads the rows after it. Returns false if canceled is set before the
+	// evaluation finishes.
+	bool evaluate(const LogColumns &columns, QVector<float> &values,
+		const QAtomicInt *canceled = nullptr, int firstRow = 0) const;
+
+private:
+	enum OpCode {
+		ConstantOp,
+		FieldOp,
+		NegateOp,
+		AbsOp,
+		SqrtOp,
+		SinOp,
+		CosOp,
+		TanOp,
+		FloorOp,
+		CeilOp,
+		RoundOp,
+		DegreesOp,
+		RadiansOp,
+		AddOp,
+		SubtractOp,
+		MultiplyOp,
+		DivideOp,
+		HypotOp,
+		Atan2Op,
+		MinOp,
+		MaxOp,
+		PowOp,
+	};
+
+	struct Instruction
+	{
+		OpCode op;
+		int field;
+		// Number of rows the field is read behind the current row.
+		int rowOffset;
+		float value;
+	};
+
+	class Parser;
+
+	QVector<Instruction> program;
+	int stackDepth = 0;
+
+	void evaluateBatch(const LogColumns &columns, int first, int count,
+		QVector<QVector<float>> &stack) const;
+};
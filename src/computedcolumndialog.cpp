@@ -0,0 +1,99 @@
+#include "computedcolumndialog.hpp"
+
+ComputedColumnDialog::ComputedColumnDialog(QWidget *parent, LogTableModel *model)
+	: QDialog(parent), logTableModel(model)
+{
+	setupUi();
+}
+
+void ComputedColumnDialog::setupUi()
+{
+	QGridLayout *gl = new QGridLayout(this);
+	setLayout(gl);
+
+	QLabel *nameLabel = new QLabel("Name:", this);
+	gl->addWidget(nameLabel, 0, 0, Qt::AlignRight);
+	nameEdit = new QLineEdit(this);
+	connect(nameEdit, SIGNAL(textEdited(const QString &)), this, SLOT(nameEdited()));
+	gl->addWidget(nameEdit, 0, 1);
+
+	QLabel *expressionLabel = new QLabel("Expression:", this);
+	gl->addWidget(expressionLabel, 1, 0, Qt::AlignRight);
+	expressionEdit = new QLineEdit(this);
+	expressionEdit->setMinimumWidth(360);
+	expressionEdit->setPlaceholderText("e.g. hypot(vx, vy) - prev(hypot(vx, vy))");
+	connect(expressionEdit, SIGNAL(textEdited(const QString &)),
+		this, SLOT(expressionEdited()));
+	gl->addWidget(expressionEdit, 1, 1);
+
+	errorLabel = new QLabel(this);
+	gl->addWidget(errorLabel, 2, 1);
+
+	buttonBox = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, this);
+	connect(buttonBox, SIGNAL(accepted()), this, SLOT(accept()));
+	connect(buttonBox, SIGNAL(rejected()), this, SLOT(reject()));
+	gl->addWidget(buttonBox, 3, 0, 1, 2);
+
+	setWindowTitle("Computed Column");
+}
+
+void ComputedColumnDialog::editColumn(int index)
+{
+	const ComputedColumns &columns = logTableModel->computedColumns();
+	columnIndex = index;
+	addedColumn = false;
+	if (index == -1) {
+		originalName = QString("x%1").arg(columns.count() + 1);
+		originalExpression.clear();
+	} else {
+		originalName = columns.name(index);
+		originalExpression = columns.expression(index);
+	}
+
+	nameEdit->setText(originalName);
+	expressionEdit->setText(originalExpression);
+	errorLabel->clear();
+	buttonBox->button(QDialogButtonBox::Ok)->setEnabled(index != -1);
+	expressionEdit->setFocus();
+}
+
+void ComputedColumnDialog::nameEdited()
+{
+	if (columnIndex != -1)
+		logTableModel->setComputedColumnName(columnIndex, nameEdit->text());
+}
+
+void ComputedColumnDialog::expressionEdited()
+{
+	QString errorMessage;
+	bool ok;
+	if (columnIndex == -1) {
+		ok = logTableModel->addComputedColumn(nameEdit->text(), expressionEdit->text(),
+			&errorMessage);
+		if (ok) {
+			columnIndex = logTableModel->computedColumns().count() - 1;
+			addedColumn = true;
+		}
+	} else {
+		ok = logTableModel->setComputedColumnExpression(columnIndex, expressionEdit->text(),
+			&errorMessage);
+	}
+
+	// The column keeps the last valid expression while the text does not compile.
+	errorLabel->setText(errorMessage);
+	buttonBox->button(QDialogButtonBox::Ok)->setEnabled(ok);
+}
+
+void ComputedColumnDialog::reject()
+{
+	if (addedColumn)
+		logTableModel->removeComputedColumn(columnIndex);
+	else if (columnIndex != -1) {
+		logTableModel->setComputedColumnName(columnIndex, originalName);
+		if (logTableModel->computedColumns().expression(columnIndex) != originalExpression)
+			logTableModel->setComputedColumnExpression(columnIndex, originalExpression,
+				nullptr);
+	}
+
+	QDialog::reject();
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <QtWidgets>
+#include "logtablemodel.hpp"
+
+// Dialog for defining a computed column. The column is updated as the expression is typed,
+// and cancelling the dialog restores the column as it was.
+class ComputedColumnDialog : public QDialog
+{
+	Q_OBJECT
+
+public:
+	ComputedColumnDialog(QWidget *parent, LogTableModel *model);
+
+	// Edits the computed column with the given index, or a new column if the index is -1.
+	void editColumn(int index);
+
+public slots:
+	void reject() override;
+
+private slots:
+	void nameEdited();
+	void expressionEdited();
+
+private:
+	LogTableModel *logTableModel;
+
+	int columnIndex = -1;
+	bool addedColumn = false;
+	QString originalName;
+	QString originalExpression;
+
+	QLineEdit *nameEdit;
+	QLineEdit *expressionEdit;
+	QLabel *errorLabel;
+	QDialogButtonBox *buttonBox;
+
+	void setupUi();
+};
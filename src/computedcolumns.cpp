@@ -0,0 +1,158 @@
+#include <limits>
+#include "computedcolumns.hpp"
+
+ComputedColumns::ComputedColumns(QObject *parent, const LogDocument *document)
+	: QObject(parent), document(document)
+{
+}
+
+ComputedColumns::~ComputedColumns()
+{
+	stop();
+}
+
+float ComputedColumns::value(int index, int row) const
+{
+	const Column &column = columnList.at(index);
+	if (row >= column.values.size())
+		return std::numeric_limits<float>::quiet_NaN();
+	return column.values.at(row);
+}
+
+void ComputedColumns::append(const QString &name, const QString &expression,
+	const ColumnExpression &program)
+{
+	Column column;
+	column.name = name;
+	column.expression = expression;
+	column.program = program;
+	column.watcher = new QFutureWatcher<QVector<float>>(this);
+	connect(column.watcher, SIGNAL(finished()), this, SLOT(evaluationFinished()));
+	columnList.append(column);
+
+	start(columnList.size() - 1);
+}
+
+void ComputedColumns::remove(int index)
+{
+	cancel(index);
+	delete columnList.at(index).watcher;
+	columnList.remove(index);
+}
+
+void ComputedColumns::setName(int index, const QString &name)
+{
+	columnList[index].name = name;
+}
+
+bool ComputedColumns::setExpression(int index, const QString &expression,
+	QString *errorMessage)
+{
+	ColumnExpression program;
+	if (!program.compile(expression, errorMessage))
+		return false;
+
+	Column &column = columnList[index];
+	column.expression = expression;
+	column.program = program;
+	start(index);
+	return true;
+}
+
+void ComputedColumns::cancel(int index)
+{
+	Column &column = columnList[index];
+	if (column.canceled)
+		column.canceled->store(1);
+	column.canceled.clear();
+	column.reader.clear();
+	column.ready = false;
+}
+
+void ComputedColumns::start(int index)
+{
+	cancel(index);
+
+	// Forget the evaluations that are done, keeping those still reading the columns.
+	QVector<QFuture<QVector<float>>> runningList;
+	for (const QFuture<QVector<float>> &future : futureList) {
+		if (!future.isFinished())
+			runningList.append(future);
+	}
+	futureList = runningList;
+
+	Column &column = columnList[index];
+	const QSharedPointer<QAtomicInt> canceled(new QAtomicInt(0));
+	column.canceled = canceled;
+	const DocumentReader reader = document->startReading();
+	column.reader = reader;
+
+	const ColumnExpression program = column.program;
+	const LogColumns *columns = &document->logColumns();
+	const QFuture<QVector<float>> future = QtConcurrent::run([program, columns, canceled,
+		reader]() {
+		QVector<float> values;
+		if (!program.evaluate(*columns, values, canceled.data()))
+			values.clear();
+		return values;
+	});
+	futureList.append(future);
+	column.watcher->setFuture(future);
+}
+
+void ComputedColumns::stop()
+{
+	for (Column &column : columnList) {
+		if (column.canceled)
+			column.canceled->store(1);
+		column.canceled.clear();
+		column.reader.clear();
+	}
+
+	for (QFuture<QVector<float>> &future : futureList)
+		future.waitForFinished();
+	futureList.clear();
+}
+
+void ComputedColumns::refresh()
+{
+	for (int i = 0; i < columnList.size(); i++) {
+		columnList[i].values.clear();
+		start(i);
+	}
+}
+
+void ComputedColumns::appendRows(int firstRow)
+{
+	for (int i = 0; i < columnList.size(); i++) {
+		Column &column = columnList[i];
+		if (!column.ready) {
+			start(i);
+			continue;
+		}
+		column.program.evaluate(document->logColumns(), column.values, nullptr, firstRow);
+	}
+}
+
+void ComputedColumns::evaluationFinished()
+{
+	for (int i = 0; i < columnList.size(); i++) {
+		Column &column = columnList[i];
+		if (column.watcher != sender())
+			continue;
+
+		// A result of a canceled evaluation belongs to an outdated expression or log.
+		if (!column.canceled || column.watcher->future().isCanceled())
+			return;
+		const QVector<float> values = column.watcher->result();
+		column.reader.clear();
+		if (values.size() != document->logColumns().rowCount())
+			return;
+
+		column.values = values;
+		column.ready = true;
+		column.canceled.clear();
+		emit columnReady(i);
+		return;
+	}
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <QtCore>
+#include <QtConcurrent>
+#include "logdocument.hpp"
+#include "columnexpression.hpp"
+
+// User-defined columns computed from the log fields. Each column is evaluated on a worker
+// thread whenever its expression or the log columns change, and its values are cached until
+// then. A column evaluated again for a new expression keeps showing its previous values until
+// the evaluation finishes, while one evaluated for new log columns reads as NaN meanwhile.
+class ComputedColumns : public QObject
+{
+	Q_OBJECT
+
+public:
+	ComputedColumns(QObject *parent, const LogDocument *document);
+	~ComputedColumns();
+
+	inline int count() const { return columnList.size(); }
+	inline QString name(int index) const { return columnList.at(index).name; }
+	inline QString expression(int index) const { return columnList.at(index).expression; }
+	inline bool isReady(int index) const { return columnList.at(index).ready; }
+	float value(int index, int row) const;
+
+	// Appends a column with the compiled program of the expression.
+	void append(const QString &name, const QString &expression,
+		const ColumnExpression &program);
+	void remove(int index);
+	void setName(int index, const QString &name);
+	bool setExpression(int index, const QString &expression, QString *errorMessage);
+
+	// Waits for the running evaluations and drops their results. This must be called before
+	// the log columns change.
+	void stop();
+
+	// Evaluates every column again after the log columns changed, dropping the values of the
+	// previous ones.
+	void refresh();
+
+	// Evaluates the rows from firstRow on, appended to the log columns, in place. Columns still
+	// waiting for an evaluation are evaluated again.
+	void appendRows(int firstRow);
+
+signals:
+	void columnReady(int index);
+
+private slots:
+	void evaluationFinished();
+
+private:
+	struct Column
+	{
+		QString name;
+		QString expression;
+		ColumnExpression program;
+		QVector<float> values;
+		bool ready = false;
+		QSharedPointer<QAtomicInt> canceled;
+		DocumentReader reader;
+		QFutureWatcher<QVector<float>> *watcher = nullptr;
+	};
+
+	const LogDocument *document;
+	QVector<Column> columnList;
+
+	// Every evaluation not waited for yet, including canceled ones still reading the columns.
+	QVector<QFuture<QVector<float>>> futureList;
+
+	void start(int index);
+	void cancel(int index);
+};
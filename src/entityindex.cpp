@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include "entityindex.hpp"
+
+float collisionImpactAngle(const TASLogger::ReaderCollision &col)
+{
+	const double ivel[3] = {
+		-col.impactVelocity[0], -col.impactVelocity[1], -col.impactVelocity[2]
+	};
+	const double impactMag = std::sqrt(ivel[0] * ivel[0] + ivel[1] * ivel[1] + ivel[2] * ivel[2]);
+	if (impactMag == 0.0)
+		return std::numeric_limits<float>::quiet_NaN();
+
+	const double dp = ivel[0] * col.normal[0] + ivel[1] * col.normal[1] + ivel[2] * col.normal[2];
+	return std::acos(dp / impactMag) * 180 / M_PI;
+}
+
+void EntityIndex::clear()
+{
+	entryList.clear();
+	rowList.clear();
+	entityToEntry.clear();
+}
+
+void EntityIndex::build(const TASLogger::TASLog &tasLog)
+{
+	clear();
+	append(tasLog, 0, 0);
+
+	for (QVector<int> &rows : rowList)
+		rows.squeeze();
+}
+
+void EntityIndex::append(const TASLogger::TASLog &tasLog, int firstFrame, int firstRow)
+{
+	bool entityAdded = false;
+	int row = firstRow;
+	for (size_t p = firstFrame; p < tasLog.physicsFrameList.size(); p++) {
+		const TASLogger::ReaderPhysicsFrame &phy = tasLog.physicsFrameList[p];
+		if (phy.commandFrameList.empty()) {
+			++row;
+			continue;
+		}
+
+		for (const TASLogger::ReaderCommandFrame &cmd : phy.commandFrameList) {
+			for (const TASLogger::ReaderCollision &col : cmd.collisionList) {
+				int index = entityToEntry.value(col.entity, -1);
+				if (index == -1) {
+					index = entryList.size();
+					entityToEntry.insert(col.entity, index);
+					EntityEntry entry;
+					entry.entity = col.entity;
+					entry.contactCount = 0;
+					entry.firstRow = row;
+					entry.minImpactAngle = std::numeric_limits<float>::quiet_NaN();
+					entry.maxImpactAngle = std::numeric_limits<float>::quiet_NaN();
+					entryList.append(entry);
+					rowList.append(QVector<int>());
+					entityAdded = true;
+				}
+
+				EntityEntry &entry = entryList[index];
+				++entry.contactCount;
+				entry.lastRow = row;
+				const float angle = collisionImpactAngle(col);
+				if (!std::isnan(angle)) {
+					if (std::isnan(entry.minImpactAngle) || angle < entry.minImpactAngle)
+						entry.minImpactAngle = angle;
+					if (std::isnan(entry.maxImpactAngle) || angle > entry.maxImpactAngle)
+						entry.maxImpactAngle = angle;
+				}
+
+				// Several contacts with the entity in one frame share the row.
+				QVector<int> &entityRows = rowList[index];
+				if (entityRows.isEmpty() || entityRows.last() != row)
+					entityRows.append(row);
+			}
+			++row;
+		}
+	}
+
+	if (entityAdded)
+		sortEntries();
+}
+
+// Orders the entries by entity ID again after new entities were appended to them.
+void EntityIndex::sortEntries()
+{
+	QVector<int> order(entryList.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(), [this](int a, int b) {
+		return entryList.at(a).entity < entryList.at(b).entity;
+	});
+
+	QVector<EntityEntry> entries;
+	QVector<QVector<int>> rows;
+	entries.reserve(order.size());
+	rows.reserve(order.size());
+	entityToEntry.clear();
+	for (const int index : order) {
+		entityToEntry.insert(entryList.at(index).entity, entries.size());
+		entries.append(entryList.at(index));
+		rows.append(rowList.at(index));
+	}
+	entryList.swap(entries);
+	rowList.swap(rows);
+}
+
+int EntityIndex::findEntity(int entity) const
+{
+	return entityToEntry.value(entity, -1);
+}
+
+int EntityIndex::findNext(int index, int row) const
+{
+	const QVector<int> &rows = rowList.at(index);
+	const auto it = std::upper_bound(rows.cbegin(), rows.cend(), row);
+	return it == rows.cend() ? -1 : *it;
+}
+
+int EntityIndex::findPrevious(int index, int row) const
+{
+	const QVector<int> &rows = rowList.at(index);
+	const auto it = std::lower_bound(rows.cbegin(), rows.cend(), row);
+	return it == rows.cbegin() ? -1 : *(it - 1);
+}
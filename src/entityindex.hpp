@@ -0,0 +1,53 @@
+#pragma once
+
+#include <QtCore>
+#include "taslogger/reader.hpp"
+
+struct EntityEntry
+{
+	int entity;
+	int contactCount;
+	int firstRow;
+	int lastRow;
+	// Range of the angles between the impact velocity and the surface normal, in degrees, or
+	// NaN if no contact had an impact velocity.
+	float minImpactAngle;
+	float maxImpactAngle;
+};
+
+// Returns the angle between the impact velocity of the collision and the surface normal, in
+// degrees, or NaN if there was no impact velocity.
+float collisionImpactAngle(const TASLogger::ReaderCollision &col);
+
+// Inverted index from the entities the player collided with to the rows of the contacts.
+// Entries are ordered by entity ID, and the rows of each entry are sorted.
+class EntityIndex
+{
+public:
+	void build(const TASLogger::TASLog &tasLog);
+	// Extends the index with the physics frames from firstFrame on, appended since the last
+	// build, whose first row is firstRow. Entities touched for the first time shift the
+	// indexes of the entries after them.
+	void append(const TASLogger::TASLog &tasLog, int firstFrame, int firstRow);
+	void clear();
+
+	inline int count() const { return entryList.size(); }
+	inline const EntityEntry &at(int index) const { return entryList.at(index); }
+	inline const QVector<int> &rows(int index) const { return rowList.at(index); }
+
+	// Returns the entry index for the entity, or -1 if the player never touched it.
+	int findEntity(int entity) const;
+
+	// Returns the first contact row of the entry after the given row, or -1 if there is none.
+	int findNext(int index, int row) const;
+
+	// Returns the last contact row of the entry before the given row, or -1 if there is none.
+	int findPrevious(int index, int row) const;
+
+private:
+	QVector<EntityEntry> entryList;
+	QVector<QVector<int>> rowList;
+	QHash<int, int> entityToEntry;
+
+	void sortEntries();
+};
@@ -0,0 +1,88 @@
+#include <cmath>
+#include "entitytablemodel.hpp"
+
+EntityTableModel::EntityTableModel(QObject *parent, const LogTableModel *model)
+	: QAbstractTableModel(parent), logTableModel(model)
+{
+}
+
+void EntityTableModel::logFileLoaded()
+{
+	beginResetModel();
+	modelRowCount = logTableModel->entityIndex().count();
+	endResetModel();
+}
+
+// The entities are listed by number, so new ones among them reset the model. Otherwise only
+// the counts and last contacts change.
+void EntityTableModel::logFramesAppended()
+{
+	if (logTableModel->entityIndex().count() != modelRowCount) {
+		logFileLoaded();
+		return;
+	}
+	if (modelRowCount > 0)
+		emit dataChanged(index(0, 0), index(modelRowCount - 1, EntityHeaderCount - 1));
+}
+
+int EntityTableModel::rowCount(const QModelIndex &) const
+{
+	return modelRowCount;
+}
+
+int EntityTableModel::columnCount(const QModelIndex &) const
+{
+	return EntityHeaderCount;
+}
+
+QVariant EntityTableModel::dataDisplay(int row, int column) const
+{
+	const EntityEntry &entry = logTableModel->entityIndex().at(row);
+
+	switch (column) {
+	case EntIdHeader:
+		if (!entry.entity)
+			return QStringLiteral("worldspawn");
+		return entry.entity;
+	case EntContactCountHeader:
+		return entry.contactCount;
+	case EntFirstRowHeader:
+		return entry.firstRow;
+	case EntLastRowHeader:
+		return entry.lastRow;
+	case EntMinImpactAngleHeader:
+		if (std::isnan(entry.minImpactAngle))
+			break;
+		return entry.minImpactAngle;
+	case EntMaxImpactAngleHeader:
+		if (std::isnan(entry.maxImpactAngle))
+			break;
+		return entry.maxImpactAngle;
+	}
+
+	return QVariant();
+}
+
+QVariant EntityTableModel::data(const QModelIndex &index, int role) const
+{
+	switch (role) {
+	case Qt::DisplayRole:
+		return dataDisplay(index.row(), index.column());
+	case Qt::TextAlignmentRole:
+		return int(Qt::AlignRight | Qt::AlignVCenter);
+	}
+
+	return QVariant();
+}
+
+QVariant EntityTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+	if (orientation == Qt::Horizontal) {
+		if (role == Qt::DisplayRole)
+			return EntityHeaderList[section][0];
+		else if (role == Qt::ToolTipRole)
+			return EntityHeaderList[section][1];
+	}
+
+	return QAbstractTableModel::headerData(section, orientation, role);
+}
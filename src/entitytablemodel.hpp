@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QtWidgets>
+#include "logtablemodel.hpp"
+
+enum EntityHeaderIndex {
+	EntIdHeader = 0,
+	EntContactCountHeader,
+	EntFirstRowHeader,
+	EntLastRowHeader,
+	EntMinImpactAngleHeader,
+	EntMaxImpactAngleHeader,
+};
+
+static const QString EntityHeaderList[][2] = {
+	{"ent", "Entity ID"},
+	{"contacts", "Number of collisions with the entity"},
+	{"first", "Row of the first contact"},
+	{"last", "Row of the last contact"},
+	{"min ang", "Smallest impact angle in degrees"},
+	{"max ang", "Largest impact angle in degrees"},
+};
+
+static const int EntityHeaderCount = sizeof(EntityHeaderList) / sizeof(EntityHeaderList[0]);
+
+// Per-entity summary of the collisions in the log, answered from the entity index of the log
+// table model.
+class EntityTableModel : public QAbstractTableModel
+{
+	Q_OBJECT
+
+public:
+	EntityTableModel(QObject *parent, const LogTableModel *model);
+
+	int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+	int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+	QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+	QVariant headerData(int section, Qt::Orientation orientation,
+		int role = Qt::DisplayRole) const override;
+
+public slots:
+	void logFileLoaded();
+	void logFramesAppended();
+
+private:
+	const LogTableModel *logTableModel;
+	// Rows the views know of, which lags behind the index while rows are inserted.
+	int modelRowCount = 0;
+
+	QVariant dataDisplay(int row, int column) const;
+};
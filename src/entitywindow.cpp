@@ -0,0 +1,70 @@
+#include "entitywindow.hpp"
+
+EntityWindow::EntityWindow(QWidget *parent, const LogTableModel *model)
+	: QDockWidget(parent), logTableModel(model)
+{
+	setupUi();
+}
+
+void EntityWindow::setupUi()
+{
+	setWindowTitle("Entities");
+	setObjectName("entityWindow");
+
+	entityTableView = new QTableView(this);
+	entityTableView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+	entityTableView->setSelectionBehavior(QAbstractItemView::SelectRows);
+	entityTableView->setSelectionMode(QAbstractItemView::SingleSelection);
+	entityTableView->verticalHeader()->hide();
+	entityTableView->verticalHeader()->setDefaultSectionSize(25);
+	entityTableView->horizontalHeader()->setDefaultSectionSize(70);
+	connect(entityTableView, SIGNAL(activated(const QModelIndex &)),
+		this, SLOT(rowActivated(const QModelIndex &)));
+	setWidget(entityTableView);
+
+	entityTableModel = new EntityTableModel(this, logTableModel);
+	connect(logTableModel, SIGNAL(logFileLoaded(bool)),
+		entityTableModel, SLOT(logFileLoaded()));
+	connect(logTableModel, SIGNAL(logFramesAppended(int)),
+		entityTableModel, SLOT(logFramesAppended()));
+	// After the model, so that the entry selected is that of the updated index.
+	connect(logTableModel, SIGNAL(logFramesAppended(int)), this, SLOT(logFramesAppended()));
+	entityTableView->setModel(entityTableModel);
+	entityTableView->setColumnWidth(EntIdHeader, 80);
+	connect(entityTableView->selectionModel(),
+		SIGNAL(currentRowChanged(const QModelIndex &, const QModelIndex &)),
+		this, SLOT(currentRowChanged(const QModelIndex &)));
+}
+
+int EntityWindow::currentEntry() const
+{
+	return entityTableView->currentIndex().row();
+}
+
+void EntityWindow::currentRowChanged(const QModelIndex &current)
+{
+	emit entitySelected(current.row());
+}
+
+void EntityWindow::rowActivated(const QModelIndex &index)
+{
+	if (!index.isValid())
+		return;
+
+	emit contactActivated(logTableModel->entityIndex().at(index.row()).firstRow);
+}
+
+// The appended frames may add contacts with the selected entity, which are highlighted too.
+void EntityWindow::logFramesAppended()
+{
+	if (!isHidden())
+		emit entitySelected(currentEntry());
+}
+
+void EntityWindow::closeEvent(QCloseEvent *event)
+{
+	emit aboutToClose();
+	// Closing the window does not trigger the menu action, which clears the highlighting.
+	emit entitySelected(-1);
+	QDockWidget::closeEvent(event);
+}
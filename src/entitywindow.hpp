@@ -0,0 +1,37 @@
+#pragma once
+
+#include <QtWidgets>
+#include "logtablemodel.hpp"
+#include "entitytablemodel.hpp"
+
+class EntityWindow : public QDockWidget
+{
+	Q_OBJECT
+
+public:
+	EntityWindow(QWidget *parent, const LogTableModel *model);
+
+	// Returns the entity index entry selected in the browser, or -1.
+	int currentEntry() const;
+
+signals:
+	void aboutToClose();
+	void entitySelected(int index);
+	void contactActivated(int row);
+
+protected:
+	void closeEvent(QCloseEvent *event) override;
+
+private slots:
+	void currentRowChanged(const QModelIndex &current);
+	void rowActivated(const QModelIndex &index);
+	void logFramesAppended();
+
+private:
+	const LogTableModel *logTableModel;
+
+	QTableView *entityTableView;
+	EntityTableModel *entityTableModel;
+
+	void setupUi();
+};
@@ -0,0 +1,99 @@
+#include <algorithm>
+#include "eventdensitypyramid.hpp"
+
+void EventDensityPyramid::clear()
+{
+	rows = 0;
+	levelList.clear();
+}
+
+void EventDensityPyramid::build(const TASLogger::TASLog &tasLog, float standardFrameTime,
+	bool prePlayerMove)
+{
+	clear();
+	append(tasLog, 0, standardFrameTime, prePlayerMove);
+}
+
+void EventDensityPyramid::append(const TASLogger::TASLog &tasLog, int firstFrame,
+	float standardFrameTime, bool prePlayerMove)
+{
+	const int firstRow = rows;
+	for (size_t p = firstFrame; p < tasLog.physicsFrameList.size(); p++)
+		rows += std::max<int>(1, tasLog.physicsFrameList[p].commandFrameList.size());
+
+	if (levelList.isEmpty())
+		levelList.append(QVector<quint32>());
+	const int buckets = (rows + BaseBucketSize - 1) / BaseBucketSize;
+	QVector<quint32> &base = levelList[0];
+	base.resize(buckets * DensityCategoryCount);
+
+	int row = firstRow;
+	for (size_t p = firstFrame; p < tasLog.physicsFrameList.size(); p++) {
+		const TASLogger::ReaderPhysicsFrame &phy = tasLog.physicsFrameList[p];
+		const int rowSpan = std::max<int>(1, phy.commandFrameList.size());
+		for (int i = 0; i < rowSpan; i++, row++) {
+			quint32 *counts = base.data() + (row / BaseBucketSize) * DensityCategoryCount;
+			counts[DamageDensity] += !phy.damageList.empty();
+			counts[ObjectMoveDensity] += !phy.objectMoveList.empty();
+			counts[ConsolePrintDensity] += !phy.consolePrintList.empty();
+			counts[FrameTimeDensity] += phy.frameTime != standardFrameTime;
+			if (phy.commandFrameList.empty())
+				continue;
+
+			const TASLogger::ReaderCommandFrame &cmd = phy.commandFrameList[i];
+			counts[CollisionDensity] += !cmd.collisionList.empty();
+			const TASLogger::ReaderPlayerState &pm = prePlayerMove ? cmd.prePMState
+				: cmd.postPMState;
+			counts[OnGroundDensity] += pm.onGround;
+		}
+	}
+
+	// Coarser buckets covering the new rows are summed again from the level below.
+	int firstBucket = firstRow / BaseBucketSize;
+	for (int k = 1; levelList.at(k - 1).size() > DensityCategoryCount; k++) {
+		if (k == levelList.size())
+			levelList.append(QVector<quint32>());
+		QVector<quint32> &level = levelList[k];
+		const QVector<quint32> &prev = levelList.at(k - 1);
+		const int prevBuckets = prev.size() / DensityCategoryCount;
+		level.resize(((prevBuckets + 1) / 2) * DensityCategoryCount);
+		firstBucket /= 2;
+		std::fill(level.begin() + firstBucket * DensityCategoryCount, level.end(), 0);
+		for (int b = firstBucket * 2; b < prevBuckets; b++) {
+			for (int c = 0; c < DensityCategoryCount; c++)
+				level[(b / 2) * DensityCategoryCount + c] += prev[b * DensityCategoryCount + c];
+		}
+	}
+}
+
+void EventDensityPyramid::sample(int count, QVector<float> &densities) const
+{
+	densities.fill(0, count * DensityCategoryCount);
+	if (!rows || count <= 0)
+		return;
+
+	// The coarsest level whose buckets are no larger than a range.
+	const double rowsPerRange = static_cast<double>(rows) / count;
+	int level = 0;
+	while (level + 1 < levelList.size() && (BaseBucketSize << (level + 1)) <= rowsPerRange)
+		++level;
+	const int bucketSize = BaseBucketSize << level;
+	const quint32 *counts = levelList.at(level).constData();
+
+	for (int i = 0; i < count; i++) {
+		const int start = static_cast<int>(i * rowsPerRange);
+		const int end = std::max(start + 1, static_cast<int>((i + 1) * rowsPerRange));
+		const int firstBucket = start / bucketSize;
+		const int lastBucket = (std::min(end, rows) - 1) / bucketSize;
+		const int covered = std::min(rows, (lastBucket + 1) * bucketSize)
+			- firstBucket * bucketSize;
+
+		float *out = densities.data() + i * DensityCategoryCount;
+		for (int b = firstBucket; b <= lastBucket; b++) {
+			for (int c = 0; c < DensityCategoryCount; c++)
+				out[c] += counts[b * DensityCategoryCount + c];
+		}
+		for (int c = 0; c < DensityCategoryCount; c++)
+			out[c] /= covered;
+	}
+}
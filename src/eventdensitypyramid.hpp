@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QtCore>
+#include "taslogger/reader.hpp"
+
+enum DensityCategory {
+	CollisionDensity = 0,
+	DamageDensity,
+	ObjectMoveDensity,
+	ConsolePrintDensity,
+	OnGroundDensity,
+	FrameTimeDensity,
+	DensityCategoryCount
+};
+
+// Multi-resolution counts of the rows having each category of event. Level 0 groups the
+// rows into buckets of BaseBucketSize rows, and every following level merges pairs of
+// buckets of the previous one, until a single bucket covers the whole log. Any number of
+// evenly spaced row ranges can then be counted by picking the level whose buckets are just
+// smaller than a range and summing a couple of buckets per range.
+class EventDensityPyramid
+{
+public:
+	static const int BaseBucketSize = 16;
+
+	// Frames whose frametime differs from standardFrameTime count as FrameTimeDensity, and
+	// OnGroundDensity follows the pre-PM or post-PM player states.
+	void build(const TASLogger::TASLog &tasLog, float standardFrameTime, bool prePlayerMove);
+	// Counts the physics frames from firstFrame on, appended since the last build with the
+	// same standard frametime, and sums the buckets of the coarser levels covering them again.
+	void append(const TASLogger::TASLog &tasLog, int firstFrame, float standardFrameTime,
+		bool prePlayerMove);
+	void clear();
+
+	inline int rowCount() const { return rows; }
+
+	// Fills densities with, for each of the count ranges splitting the log evenly, the
+	// fraction of rows having each category, laid out as
+	// densities[i * DensityCategoryCount + category].
+	void sample(int count, QVector<float> &densities) const;
+
+private:
+	int rows = 0;
+	// levelList[k][b * DensityCategoryCount + c] counts rows of category c in bucket b.
+	QVector<QVector<quint32>> levelList;
+};
@@ -0,0 +1,63 @@
+#include <algorithm>
+#include "eventindex.hpp"
+
+void EventIndex::clear()
+{
+	for (QVector<int> &rows : rowList)
+		rows.clear();
+}
+
+void EventIndex::build(const TASLogger::TASLog &tasLog)
+{
+	clear();
+	append(tasLog, 0, 0);
+
+	for (QVector<int> &rows : rowList)
+		rows.squeeze();
+}
+
+void EventIndex::append(const TASLogger::TASLog &tasLog, int firstFrame, int firstRow)
+{
+	int row = firstRow;
+	int lastClientState = firstFrame > 0
+		? tasLog.physicsFrameList[firstFrame - 1].clientState : -1;
+	for (size_t p = firstFrame; p < tasLog.physicsFrameList.size(); p++) {
+		const TASLogger::ReaderPhysicsFrame &phy = tasLog.physicsFrameList[p];
+		if (!phy.damageList.empty())
+			rowList[DamageEvent].append(row);
+		if (!phy.objectMoveList.empty())
+			rowList[ObjectMoveEvent].append(row);
+		if (!phy.consolePrintList.empty())
+			rowList[ConsolePrintEvent].append(row);
+		if (phy.paused)
+			rowList[PauseEvent].append(row);
+		if (lastClientState != -1 && phy.clientState != lastClientState)
+			rowList[ClientStateEvent].append(row);
+		lastClientState = phy.clientState;
+
+		if (phy.commandFrameList.empty()) {
+			++row;
+			continue;
+		}
+
+		for (const TASLogger::ReaderCommandFrame &cmd : phy.commandFrameList) {
+			if (!cmd.collisionList.empty())
+				rowList[CollisionEvent].append(row);
+			++row;
+		}
+	}
+}
+
+int EventIndex::findNext(int type, int row) const
+{
+	const QVector<int> &rows = rowList[type];
+	const auto it = std::upper_bound(rows.cbegin(), rows.cend(), row);
+	return it == rows.cend() ? -1 : *it;
+}
+
+int EventIndex::findPrevious(int type, int row) const
+{
+	const QVector<int> &rows = rowList[type];
+	const auto it = std::lower_bound(rows.cbegin(), rows.cend(), row);
+	return it == rows.cbegin() ? -1 : *(it - 1);
+}
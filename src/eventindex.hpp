@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QtCore>
+#include "taslogger/reader.hpp"
+
+enum EventType {
+	DamageEvent = 0,
+	CollisionEvent,
+	ObjectMoveEvent,
+	ConsolePrintEvent,
+	PauseEvent,
+	ClientStateEvent,
+	EventTypeCount
+};
+
+static const QString EventTypeNameList[] = {
+	"Damage",
+	"Collision",
+	"Object Move",
+	"Console Print",
+	"Pause",
+	"Client State Change",
+};
+
+// Sorted lists of the rows on which each type of event occurs. Events of physics frames are
+// attributed to the first row of the frame, collisions to the row of their command frame.
+class EventIndex
+{
+public:
+	void build(const TASLogger::TASLog &tasLog);
+	// Extends the index with the physics frames from firstFrame on, appended since the last
+	// build, whose first row is firstRow.
+	void append(const TASLogger::TASLog &tasLog, int firstFrame, int firstRow);
+	void clear();
+
+	inline const QVector<int> &rows(int type) const { return rowList[type]; }
+
+	// Returns the first event row after the given row, or -1 if there is none.
+	int findNext(int type, int row) const;
+
+	// Returns the last event row before the given row, or -1 if there is none.
+	int findPrevious(int type, int row) const;
+
+private:
+	QVector<int> rowList[EventTypeCount];
+};
@@ -0,0 +1,118 @@
+#include <algorithm>
+#include "eventminimap.hpp"
+
+static const int LaneWidth = 3;
+static const int LaneSpacing = 1;
+
+static const QColor DensityColorList[] = {
+	QColor(Qt::darkYellow),
+	QColor(Qt::red),
+	QColor(Qt::blue),
+	QColor(Qt::darkGray),
+	QColor(Qt::green),
+	QColor(Qt::magenta),
+};
+
+EventMinimap::EventMinimap(QWidget *parent, const LogTableModel *model)
+	: QWidget(parent), logTableModel(model)
+{
+	setFixedWidth(DensityCategoryCount * (LaneWidth + LaneSpacing) + LaneSpacing);
+	setToolTip("Collisions, damage, object moves, console prints, "
+		"ground contact and unusual frametimes");
+}
+
+QSize EventMinimap::sizeHint() const
+{
+	return QSize(width(), 100);
+}
+
+void EventMinimap::densityChanged()
+{
+	renderDensity();
+	update();
+}
+
+void EventMinimap::setVisibleRows(int firstRow, int lastRow)
+{
+	visibleFirstRow = firstRow;
+	visibleLastRow = lastRow;
+	update();
+}
+
+void EventMinimap::renderDensity()
+{
+	const EventDensityPyramid &pyramid = logTableModel->eventDensityPyramid();
+	const int h = height();
+	densityImage = QImage(width(), std::max(1, h), QImage::Format_ARGB32_Premultiplied);
+	densityImage.fill(palette().color(QPalette::Base));
+	if (!pyramid.rowCount() || h <= 0)
+		return;
+
+	pyramid.sample(h, densityList);
+
+	for (int y = 0; y < h; y++) {
+		QRgb *line = reinterpret_cast<QRgb *>(densityImage.scanLine(y));
+		const float *densities = densityList.constData() + y * DensityCategoryCount;
+		for (int c = 0; c < DensityCategoryCount; c++) {
+			if (densities[c] <= 0)
+				continue;
+
+			// Any occurrence stays visible, denser regions become more opaque.
+			const int alpha = 64 + static_cast<int>(191 * std::min(1.0f, densities[c]));
+			const QColor &color = DensityColorList[c];
+			const QRgb pixel = qPremultiply(qRgba(color.red(), color.green(), color.blue(),
+				alpha));
+			const int x0 = LaneSpacing + c * (LaneWidth + LaneSpacing);
+			for (int x = x0; x < x0 + LaneWidth; x++)
+				line[x] = pixel;
+		}
+	}
+}
+
+void EventMinimap::resizeEvent(QResizeEvent *event)
+{
+	renderDensity();
+	QWidget::resizeEvent(event);
+}
+
+void EventMinimap::paintEvent(QPaintEvent *)
+{
+	QPainter painter(this);
+	painter.drawImage(0, 0, densityImage);
+
+	const int rows = logTableModel->eventDensityPyramid().rowCount();
+	if (!rows || visibleLastRow < visibleFirstRow)
+		return;
+
+	const double scale = static_cast<double>(height()) / rows;
+	const int top = static_cast<int>(visibleFirstRow * scale);
+	const int bottom = std::max(top + 2, static_cast<int>((visibleLastRow + 1) * scale));
+	painter.setPen(palette().color(QPalette::Highlight));
+	painter.setBrush(Qt::NoBrush);
+	painter.drawRect(0, top, width() - 1, bottom - top - 1);
+}
+
+int EventMinimap::rowAtY(int y) const
+{
+	const int rows = logTableModel->eventDensityPyramid().rowCount();
+	if (!rows || height() <= 0)
+		return -1;
+	const int row = static_cast<int>(static_cast<double>(y) * rows / height());
+	return std::max(0, std::min(rows - 1, row));
+}
+
+void EventMinimap::mousePressEvent(QMouseEvent *event)
+{
+	const int row = rowAtY(event->pos().y());
+	if (row != -1)
+		emit rowClicked(row);
+	event->accept();
+}
+
+void EventMinimap::mouseMoveEvent(QMouseEvent *event)
+{
+	if (event->buttons() & Qt::LeftButton)
+		mousePressEvent(event);
+	else
+		event->ignore();
+}
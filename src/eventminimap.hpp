@@ -0,0 +1,40 @@
+#pragma once
+
+#include <QtWidgets>
+#include "logtablemodel.hpp"
+
+// Overview strip showing where events occur across the whole log, drawn from the event
+// density pyramid of the model so that repainting costs the same for any log size.
+class EventMinimap : public QWidget
+{
+	Q_OBJECT
+
+public:
+	EventMinimap(QWidget *parent, const LogTableModel *model);
+
+	QSize sizeHint() const override;
+
+public slots:
+	void setVisibleRows(int firstRow, int lastRow);
+	void densityChanged();
+
+signals:
+	void rowClicked(int row);
+
+protected:
+	void paintEvent(QPaintEvent *event) override;
+	void resizeEvent(QResizeEvent *event) override;
+	void mousePressEvent(QMouseEvent *event) override;
+	void mouseMoveEvent(QMouseEvent *event) override;
+
+private:
+	const LogTableModel *logTableModel;
+
+	QImage densityImage;
+	QVector<float> densityList;
+	int visibleFirstRow = 0;
+	int visibleLastRow = -1;
+
+	void renderDensity();
+	int rowAtY(int y) const;
+};
@@ -0,0 +1,154 @@
+#include "exportdialog.hpp"
+#include "settings.hpp"
+
+ExportDialog::ExportDialog(QWidget *parent)
+	: QDialog(parent)
+{
+	setupUi();
+}
+
+void ExportDialog::setupUi()
+{
+	QGridLayout *gl = new QGridLayout(this);
+	setLayout(gl);
+
+	QSettings settings;
+	const QStringList checkedList = settings.value(ExportColumnsKey).toStringList();
+
+	QLabel *columnsLabel = new QLabel("Columns:", this);
+	gl->addWidget(columnsLabel, 0, 0, Qt::AlignRight | Qt::AlignTop);
+	columnListWidget = new QListWidget(this);
+	columnListWidget->setUniformItemSizes(true);
+	for (int column = 0; column < ExportColumnCount; column++) {
+		const QString name = exportColumnName(column);
+		QListWidgetItem *item = new QListWidgetItem(name, columnListWidget);
+		const bool checked = checkedList.isEmpty() || checkedList.contains(name);
+		item->setCheckState(checked ? Qt::Checked : Qt::Unchecked);
+	}
+	connect(columnListWidget, SIGNAL(itemChanged(QListWidgetItem *)),
+		this, SLOT(columnChanged()));
+	gl->addWidget(columnListWidget, 0, 1);
+
+	QVBoxLayout *checkLayout = new QVBoxLayout;
+	checkAllButton = new QPushButton("Check All", this);
+	connect(checkAllButton, SIGNAL(clicked()), this, SLOT(checkAllColumns()));
+	checkLayout->addWidget(checkAllButton);
+	uncheckAllButton = new QPushButton("Uncheck All", this);
+	connect(uncheckAllButton, SIGNAL(clicked()), this, SLOT(uncheckAllColumns()));
+	checkLayout->addWidget(uncheckAllButton);
+	checkLayout->addStretch();
+	gl->addLayout(checkLayout, 0, 2);
+
+	QLabel *rowsLabel = new QLabel("Rows:", this);
+	gl->addWidget(rowsLabel, 1, 0, Qt::AlignRight | Qt::AlignTop);
+	QVBoxLayout *rowsLayout = new QVBoxLayout;
+	rowScopeGroup = new QButtonGroup(this);
+	const char *scopeNameList[] = {"All rows", "Visible rows, in the table order", "Selected rows"};
+	for (int scope = AllRowsScope; scope <= SelectedRowsScope; scope++) {
+		QRadioButton *button = new QRadioButton(scopeNameList[scope], this);
+		button->setProperty("available", scope == AllRowsScope);
+		rowScopeGroup->addButton(button, scope);
+		rowsLayout->addWidget(button);
+	}
+	rowScopeGroup->button(AllRowsScope)->setChecked(true);
+	gl->addLayout(rowsLayout, 1, 1, 1, 2);
+
+	QLabel *formatLabel = new QLabel("Format:", this);
+	gl->addWidget(formatLabel, 2, 0, Qt::AlignRight);
+	formatCombo = new QComboBox(this);
+	formatCombo->addItem("Comma-separated values (*.csv)", CsvFormat);
+	formatCombo->addItem("Tab-separated values (*.tsv)", TsvFormat);
+	formatCombo->addItem("Columnar binary, all columns and events (*.qcrcol)", ColumnarFormat);
+	formatCombo->setCurrentIndex(settings.value(ExportFormatKey, CsvFormat).toInt());
+	connect(formatCombo, SIGNAL(currentIndexChanged(int)), this, SLOT(formatChanged()));
+	gl->addWidget(formatCombo, 2, 1, 1, 2);
+
+	buttonBox = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, this);
+	buttonBox->button(QDialogButtonBox::Ok)->setText("Export...");
+	connect(buttonBox, SIGNAL(accepted()), this, SLOT(accept()));
+	connect(buttonBox, SIGNAL(rejected()), this, SLOT(reject()));
+	gl->addWidget(buttonBox, 3, 0, 1, 3);
+
+	formatChanged();
+	setWindowTitle("Export");
+}
+
+void ExportDialog::setRowScopesAvailable(bool visibleRows, bool selectedRows)
+{
+	rowScopeGroup->button(VisibleRowsScope)->setProperty("available", visibleRows);
+	rowScopeGroup->button(SelectedRowsScope)->setProperty("available", selectedRows);
+	if (!rowScopeGroup->checkedButton()->property("available").toBool())
+		rowScopeGroup->button(AllRowsScope)->setChecked(true);
+	formatChanged();
+}
+
+void ExportDialog::formatChanged()
+{
+	// The columnar format always holds the whole log.
+	const bool columnar = format() == ColumnarFormat;
+	columnListWidget->setEnabled(!columnar);
+	checkAllButton->setEnabled(!columnar);
+	uncheckAllButton->setEnabled(!columnar);
+	for (QAbstractButton *button : rowScopeGroup->buttons())
+		button->setEnabled(!columnar && button->property("available").toBool());
+	if (columnar)
+		rowScopeGroup->button(AllRowsScope)->setChecked(true);
+	columnChanged();
+}
+
+ExportFormat ExportDialog::format() const
+{
+	return static_cast<ExportFormat>(formatCombo->currentData().toInt());
+}
+
+ExportRowScope ExportDialog::rowScope() const
+{
+	return static_cast<ExportRowScope>(rowScopeGroup->checkedId());
+}
+
+QVector<int> ExportDialog::columnList() const
+{
+	QVector<int> columnList;
+	for (int column = 0; column < columnListWidget->count(); column++) {
+		if (columnListWidget->item(column)->checkState() == Qt::Checked)
+			columnList.append(column);
+	}
+	return columnList;
+}
+
+void ExportDialog::accept()
+{
+	QStringList checkedList;
+	for (const int column : columnList())
+		checkedList.append(exportColumnName(column));
+
+	QSettings settings;
+	settings.setValue(ExportColumnsKey, checkedList);
+	settings.setValue(ExportFormatKey, formatCombo->currentIndex());
+	QDialog::accept();
+}
+
+void ExportDialog::checkAllColumns()
+{
+	setAllColumnsChecked(true);
+}
+
+void ExportDialog::uncheckAllColumns()
+{
+	setAllColumnsChecked(false);
+}
+
+void ExportDialog::columnChanged()
+{
+	buttonBox->button(QDialogButtonBox::Ok)->setEnabled(
+		format() == ColumnarFormat || !columnList().isEmpty());
+}
+
+void ExportDialog::setAllColumnsChecked(bool checked)
+{
+	columnListWidget->blockSignals(true);
+	for (int column = 0; column < columnListWidget->count(); column++)
+		columnListWidget->item(column)->setCheckState(checked ? Qt::Checked : Qt::Unchecked);
+	columnListWidget->blockSignals(false);
+	columnChanged();
+}
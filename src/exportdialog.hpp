@@ -0,0 +1,48 @@
+#pragma once
+
+#include <QtWidgets>
+#include "logexporter.hpp"
+#include "columnarexporter.hpp"
+
+enum ExportRowScope {
+	AllRowsScope = 0,
+	VisibleRowsScope,
+	SelectedRowsScope
+};
+
+// Dialog choosing the columns, rows and format of an export. The columns and format are
+// remembered across exports.
+class ExportDialog : public QDialog
+{
+	Q_OBJECT
+
+public:
+	ExportDialog(QWidget *parent);
+
+	// Enables the row scopes that apply to the log table as it is.
+	void setRowScopesAvailable(bool visibleRows, bool selectedRows);
+
+	ExportFormat format() const;
+	ExportRowScope rowScope() const;
+	QVector<int> columnList() const;
+
+public slots:
+	void accept() override;
+
+private slots:
+	void checkAllColumns();
+	void uncheckAllColumns();
+	void columnChanged();
+	void formatChanged();
+
+private:
+	QListWidget *columnListWidget;
+	QPushButton *checkAllButton;
+	QPushButton *uncheckAllButton;
+	QComboBox *formatCombo;
+	QButtonGroup *rowScopeGroup;
+	QDialogButtonBox *buttonBox;
+
+	void setupUi();
+	void setAllColumnsChecked(bool checked);
+};
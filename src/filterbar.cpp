@@ -0,0 +1,173 @@
+#include "filterbar.hpp"
+
+FilterBar::FilterBar(QWidget *parent, const LogTableModel *model, LogProxyModel *proxyModel)
+	: QWidget(parent), logTableModel(model), logProxyModel(proxyModel)
+{
+	setupUi();
+}
+
+FilterBar::~FilterBar()
+{
+	stopFilter();
+}
+
+void FilterBar::setupUi()
+{
+	filterEdit = new QLineEdit(this);
+	filterEdit->setPlaceholderText("Filter rows, e.g. g && hspd > 320 || ent == 57");
+	filterEdit->setClearButtonEnabled(true);
+	connect(filterEdit, SIGNAL(returnPressed()), this, SLOT(applyFilter()));
+
+	statusLabel = new QLabel(this);
+
+	closeButton = new QToolButton(this);
+	closeButton->setAutoRaise(true);
+	closeButton->setIcon(style()->standardIcon(QStyle::SP_TitleBarCloseButton));
+	closeButton->setToolTip("Close the filter bar");
+	connect(closeButton, SIGNAL(clicked()), this, SLOT(closeBar()));
+
+	QHBoxLayout *layout = new QHBoxLayout(this);
+	layout->setContentsMargins(2, 2, 2, 2);
+	layout->addWidget(new QLabel("Filter:", this));
+	layout->addWidget(filterEdit, 1);
+	layout->addWidget(statusLabel);
+	layout->addWidget(closeButton);
+	setLayout(layout);
+
+	connect(&filterWatcher, SIGNAL(finished()), this, SLOT(filterFinished()));
+	connect(logProxyModel, SIGNAL(rowMapChanged()), this, SLOT(updateStatus()));
+
+	// Direct connection, as explained in LogProxyModel.
+	connect(logTableModel, SIGNAL(logColumnsAboutToChange()),
+		this, SLOT(logColumnsAboutToChange()), Qt::DirectConnection);
+	connect(logTableModel, SIGNAL(logColumnsChanged()), this, SLOT(logColumnsChanged()));
+	connect(logTableModel, SIGNAL(logFramesAppended(int)), this, SLOT(logFramesAppended(int)));
+}
+
+void FilterBar::focusFilter()
+{
+	filterEdit->setFocus();
+	filterEdit->selectAll();
+}
+
+void FilterBar::clearFilter()
+{
+	filterEdit->clear();
+	applyFilter();
+}
+
+void FilterBar::applyFilter()
+{
+	// The filter shown keeps being applied to the appended rows until the new one compiles.
+	RowFilter filter;
+	QString errorMessage;
+	if (!filter.compile(filterEdit->text(), &errorMessage)) {
+		statusLabel->setText(errorMessage);
+		return;
+	}
+
+	rowFilter = filter;
+	startFilter();
+}
+
+RowFilterSource FilterBar::filterSource() const
+{
+	const RowFilterSource source = {
+		&logTableModel->tasLog(),
+		&logTableModel->logColumns(),
+		&logTableModel->eventIndex(),
+		&logTableModel->gameTimeIndex(),
+	};
+	return source;
+}
+
+void FilterBar::startFilter()
+{
+	stopFilter();
+
+	if (rowFilter.isEmpty()) {
+		logProxyModel->clearFilterRows();
+		updateStatus();
+		return;
+	}
+
+	if (logTableModel->rowCount() == 0)
+		return;
+
+	const RowFilterSource source = filterSource();
+	const RowFilter filter = rowFilter;
+	const QSharedPointer<QAtomicInt> canceled(new QAtomicInt(0));
+	filterCanceled = canceled;
+	const DocumentReader reader = logTableModel->logDocument().startReading();
+	filterReader = reader;
+
+	statusLabel->setText("Filtering...");
+	filterTimer.start();
+	filterWatcher.setFuture(QtConcurrent::run([filter, source, canceled, reader]() {
+		return filter.evaluate(source, 0, canceled.data());
+	}));
+}
+
+void FilterBar::stopFilter()
+{
+	if (filterCanceled)
+		filterCanceled->store(1);
+	filterCanceled.clear();
+	// A canceled filter stops at its next chunk of rows.
+	filterWatcher.waitForFinished();
+	filterReader.clear();
+}
+
+void FilterBar::filterFinished()
+{
+	// The result of a canceled filter belongs to an outdated filter or log.
+	if (!filterCanceled || filterCanceled->load())
+		return;
+	filterCanceled.clear();
+	filterReader.clear();
+
+	const qint64 elapsed = filterTimer.elapsed();
+	logProxyModel->setFilterRows(filterWatcher.result());
+	statusLabel->setText(QString("%1 of %2 rows (%3 ms)")
+		.arg(logProxyModel->rowCount()).arg(logTableModel->rowCount()).arg(elapsed));
+}
+
+void FilterBar::updateStatus()
+{
+	if (!logProxyModel->hasFilter())
+		statusLabel->clear();
+}
+
+void FilterBar::logColumnsAboutToChange()
+{
+	stopFilter();
+}
+
+void FilterBar::logColumnsChanged()
+{
+	// The player move state changes the values of the fields, so the filter is run again.
+	if (!rowFilter.isEmpty())
+		startFilter();
+}
+
+void FilterBar::logFramesAppended(int firstRow)
+{
+	if (rowFilter.isEmpty())
+		return;
+	// The filter did not run on a log without rows.
+	if (!logProxyModel->hasFilter()) {
+		startFilter();
+		return;
+	}
+
+	logProxyModel->appendFilterRows(rowFilter.evaluate(filterSource(), firstRow));
+	statusLabel->setText(QString("%1 of %2 rows")
+		.arg(logProxyModel->rowCount()).arg(logTableModel->rowCount()));
+}
+
+void FilterBar::closeBar()
+{
+	clearFilter();
+	hide();
+	emit aboutToClose();
+}
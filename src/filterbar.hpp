@@ -0,0 +1,56 @@
+#pragma once
+
+#include <QtWidgets>
+#include <QtConcurrent>
+#include "logtablemodel.hpp"
+#include "logproxymodel.hpp"
+#include "rowfilter.hpp"
+
+// Bar above the log table for typing a row filter. The filter runs on a worker thread and
+// its result is handed to the proxy model as a row map.
+class FilterBar : public QWidget
+{
+	Q_OBJECT
+
+public:
+	FilterBar(QWidget *parent, const LogTableModel *model, LogProxyModel *proxyModel);
+	~FilterBar();
+
+	// Cancels a running filter, waiting for it to stop reading the log, and drops its result.
+	void stopFilter();
+
+signals:
+	void aboutToClose();
+
+public slots:
+	void focusFilter();
+	void clearFilter();
+	void closeBar();
+
+private slots:
+	void applyFilter();
+	void logColumnsAboutToChange();
+	void logColumnsChanged();
+	void logFramesAppended(int firstRow);
+	void filterFinished();
+	void updateStatus();
+
+private:
+	const LogTableModel *logTableModel;
+	LogProxyModel *logProxyModel;
+
+	QLineEdit *filterEdit;
+	QLabel *statusLabel;
+	QToolButton *closeButton;
+
+	RowFilter rowFilter;
+	QFutureWatcher<QVector<int>> filterWatcher;
+	// Set to cancel the running filter, whose result is then dropped.
+	QSharedPointer<QAtomicInt> filterCanceled;
+	DocumentReader filterReader;
+	QElapsedTimer filterTimer;
+
+	void setupUi();
+	void startFilter();
+	RowFilterSource filterSource() const;
+};
@@ -0,0 +1,59 @@
+#include <algorithm>
+#include <cmath>
+#include "framebulkindex.hpp"
+
+void FramebulkIndex::clear()
+{
+	entryList.clear();
+}
+
+void FramebulkIndex::build(const TASLogger::TASLog &tasLog)
+{
+	clear();
+	append(tasLog, 0, 0);
+}
+
+void FramebulkIndex::append(const TASLogger::TASLog &tasLog, int firstFrame, int firstRow)
+{
+	int row = firstRow;
+	int index = entryList.size() - 1;
+	for (size_t p = firstFrame; p < tasLog.physicsFrameList.size(); p++) {
+		const TASLogger::ReaderPhysicsFrame &phy = tasLog.physicsFrameList[p];
+		if (phy.commandFrameList.empty()) {
+			++row;
+			continue;
+		}
+
+		for (const TASLogger::ReaderCommandFrame &cmd : phy.commandFrameList) {
+			const TASLogger::ReaderPlayerState &pm = cmd.postPMState;
+			const float hspeed = std::hypot(pm.velocity[0], pm.velocity[1]);
+			const int id = cmd.framebulkId;
+
+			// A framebulk run again later starts an entry of its own, so entries never overlap.
+			if (index == -1 || entryList.at(index).framebulkId != id) {
+				FramebulkEntry entry;
+				entry.framebulkId = id;
+				entry.firstRow = row;
+				std::copy(pm.position, pm.position + 3, entry.startPosition);
+				entry.minHorizontalSpeed = hspeed;
+				entry.maxHorizontalSpeed = hspeed;
+				index = entryList.size();
+				entryList.append(entry);
+			}
+
+			FramebulkEntry &entry = entryList[index];
+			entry.lastRow = row;
+			std::copy(pm.position, pm.position + 3, entry.endPosition);
+			entry.minHorizontalSpeed = std::min(entry.minHorizontalSpeed, hspeed);
+			entry.maxHorizontalSpeed = std::max(entry.maxHorizontalSpeed, hspeed);
+			++row;
+		}
+	}
+}
+
+int FramebulkIndex::findByRow(int row) const
+{
+	const auto it = std::upper_bound(entryList.cbegin(), entryList.cend(), row,
+		[](int r, const FramebulkEntry &entry) { return r < entry.firstRow; });
+	return static_cast<int>(it - entryList.cbegin()) - 1;
+}
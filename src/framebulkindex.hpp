@@ -0,0 +1,37 @@
+#pragma once
+
+#include <QtCore>
+#include "taslogger/reader.hpp"
+
+struct FramebulkEntry
+{
+	int framebulkId;
+	int firstRow;
+	int lastRow;
+	float startPosition[3];
+	float endPosition[3];
+	float minHorizontalSpeed;
+	float maxHorizontalSpeed;
+};
+
+// Maps every run of a framebulk in the log to the rows it spans. A new entry starts whenever
+// the framebulk ID differs from that of the previous command frame, so the entries are
+// disjoint and ordered by their first row, which is also the order they were executed in.
+class FramebulkIndex
+{
+public:
+	void build(const TASLogger::TASLog &tasLog);
+	// Extends the index with the physics frames from firstFrame on, appended since the last
+	// build, whose first row is firstRow. The last entry continues if its framebulk does.
+	void append(const TASLogger::TASLog &tasLog, int firstFrame, int firstRow);
+	void clear();
+
+	inline int count() const { return entryList.size(); }
+	inline const FramebulkEntry &at(int index) const { return entryList.at(index); }
+
+	// Returns the index of the last entry starting at or before the row, or -1.
+	int findByRow(int row) const;
+
+private:
+	QVector<FramebulkEntry> entryList;
+};
@@ -0,0 +1,115 @@
+#include "framebulktablemodel.hpp"
+
+static const QString PositionFormat = "%1 %2 %3";
+
+FramebulkTableModel::FramebulkTableModel(QObject *parent, const LogTableModel *model)
+	: QAbstractTableModel(parent), logTableModel(model)
+{
+}
+
+void FramebulkTableModel::logFileLoaded()
+{
+	beginResetModel();
+	modelRowCount = logTableModel->framebulkIndex().count();
+	endResetModel();
+}
+
+// The last framebulk may continue in the appended frames, and new ones follow it.
+void FramebulkTableModel::logFramesAppended()
+{
+	if (modelRowCount > 0)
+		emit dataChanged(index(modelRowCount - 1, 0),
+			index(modelRowCount - 1, FramebulkHeaderCount - 1));
+	const int count = logTableModel->framebulkIndex().count();
+	if (count > modelRowCount) {
+		beginInsertRows(QModelIndex(), modelRowCount, count - 1);
+		modelRowCount = count;
+		endInsertRows();
+	}
+}
+
+// The distances and speeds follow the player states shown.
+void FramebulkTableModel::logColumnsChanged()
+{
+	if (modelRowCount > 0)
+		emit dataChanged(index(0, 0), index(modelRowCount - 1, FramebulkHeaderCount - 1));
+}
+
+int FramebulkTableModel::rowCount(const QModelIndex &) const
+{
+	return modelRowCount;
+}
+
+int FramebulkTableModel::columnCount(const QModelIndex &) const
+{
+	return FramebulkHeaderCount;
+}
+
+QVariant FramebulkTableModel::dataDisplay(int row, int column) const
+{
+	const FramebulkEntry &entry = logTableModel->framebulkIndex().at(row);
+	const RowPrefixSums &sums = logTableModel->rowPrefixSums();
+
+	switch (column) {
+	case FBIdHeader:
+		return entry.framebulkId;
+	case FBFrameCountHeader:
+		return sums.commandFrameCount(entry.firstRow, entry.lastRow);
+	case FBDurationHeader:
+		return logTableModel->duration(entry.firstRow, entry.lastRow);
+	case FBStartPositionHeader:
+		return PositionFormat.arg(entry.startPosition[0])
+			.arg(entry.startPosition[1]).arg(entry.startPosition[2]);
+	case FBEndPositionHeader:
+		return PositionFormat.arg(entry.endPosition[0])
+			.arg(entry.endPosition[1]).arg(entry.endPosition[2]);
+	case FBDistanceHeader:
+		return sums.distance(entry.firstRow, entry.lastRow);
+	case FBMinHorizontalSpeedHeader:
+		return entry.minHorizontalSpeed;
+	case FBMaxHorizontalSpeedHeader:
+		return entry.maxHorizontalSpeed;
+	case FBAvgHorizontalSpeedHeader: {
+		const int count = sums.commandFrameCount(entry.firstRow, entry.lastRow);
+		return sums.horizontalSpeedSum(entry.firstRow, entry.lastRow) / count;
+	}
+	case FBCollisionsHeader: {
+		const int count = sums.collisionCount(entry.firstRow, entry.lastRow);
+		if (!count)
+			break;
+		return count;
+	}
+	case FBDamageHeader: {
+		const double dmg = sums.damageTaken(entry.firstRow, entry.lastRow);
+		if (dmg == 0.0)
+			break;
+		return dmg;
+	}
+	}
+
+	return QVariant();
+}
+
+QVariant FramebulkTableModel::data(const QModelIndex &index, int role) const
+{
+	switch (role) {
+	case Qt::DisplayRole:
+		return dataDisplay(index.row(), index.column());
+	case Qt::TextAlignmentRole:
+		return int(Qt::AlignRight | Qt::AlignVCenter);
+	}
+
+	return QVariant();
+}
+
+QVariant FramebulkTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+	if (orientation == Qt::Horizontal) {
+		if (role == Qt::DisplayRole)
+			return FramebulkHeaderList[section][0];
+		else if (role == Qt::ToolTipRole)
+			return FramebulkHeaderList[section][1];
+	}
+
+	return QAbstractTableModel::headerData(section, orientation, role);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <QtWidgets>
+#include "logtablemodel.hpp"
+
+enum FramebulkHeaderIndex {
+	FBIdHeader = 0,
+	FBFrameCountHeader,
+	FBDurationHeader,
+	FBStartPositionHeader,
+	FBEndPositionHeader,
+	FBDistanceHeader,
+	FBMinHorizontalSpeedHeader,
+	FBMaxHorizontalSpeedHeader,
+	FBAvgHorizontalSpeedHeader,
+	FBCollisionsHeader,
+	FBDamageHeader,
+};
+
+static const QString FramebulkHeaderList[][2] = {
+	{"bid", "Framebulk ID"},
+	{"frames", "Number of command frames"},
+	{"time", "Duration in seconds"},
+	{"start", "Position at the first frame"},
+	{"end", "Position at the last frame"},
+	{"dist", "Distance travelled"},
+	{"min hspd", "Minimum horizontal speed"},
+	{"max hspd", "Maximum horizontal speed"},
+	{"avg hspd", "Average horizontal speed"},
+	{"col", "Number of collisions"},
+	{"dmg", "Damage taken"},
+};
+
+static const int FramebulkHeaderCount =
+	sizeof(FramebulkHeaderList) / sizeof(FramebulkHeaderList[0]);
+
+// Per-framebulk summary of the log. Every cell is answered in constant time from the
+// framebulk index, the row prefix sums and the game time of the log table model.
+class FramebulkTableModel : public QAbstractTableModel
+{
+	Q_OBJECT
+
+public:
+	FramebulkTableModel(QObject *parent, const LogTableModel *model);
+
+	int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+	int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+	QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+	QVariant headerData(int section, Qt::Orientation orientation,
+		int role = Qt::DisplayRole) const override;
+
+public slots:
+	void logFileLoaded();
+	void logFramesAppended();
+	void logColumnsChanged();
+
+private:
+	const LogTableModel *logTableModel;
+	// Rows the views know of, which lags behind the index while rows are inserted.
+	int modelRowCount = 0;
+
+	QVariant dataDisplay(int row, int column) const;
+};
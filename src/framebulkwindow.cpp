@@ -0,0 +1,54 @@
+#include "framebulkwindow.hpp"
+
+FramebulkWindow::FramebulkWindow(QWidget *parent, const LogTableModel *model)
+	: QDockWidget(parent), logTableModel(model)
+{
+	setupUi();
+}
+
+void FramebulkWindow::setupUi()
+{
+	setWindowTitle("Framebulks");
+	setObjectName("framebulkWindow");
+
+	framebulkTableView = new QTableView(this);
+	framebulkTableView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+	framebulkTableView->setSelectionBehavior(QAbstractItemView::SelectRows);
+	framebulkTableView->setSelectionMode(QAbstractItemView::SingleSelection);
+	framebulkTableView->verticalHeader()->hide();
+	framebulkTableView->verticalHeader()->setDefaultSectionSize(25);
+	framebulkTableView->horizontalHeader()->setDefaultSectionSize(70);
+	connect(framebulkTableView, SIGNAL(clicked(const QModelIndex &)),
+		this, SLOT(rowActivated(const QModelIndex &)));
+	connect(framebulkTableView, SIGNAL(activated(const QModelIndex &)),
+		this, SLOT(rowActivated(const QModelIndex &)));
+	setWidget(framebulkTableView);
+
+	framebulkTableModel = new FramebulkTableModel(this, logTableModel);
+	connect(logTableModel, SIGNAL(logFileLoaded(bool)),
+		framebulkTableModel, SLOT(logFileLoaded()));
+	connect(logTableModel, SIGNAL(logFramesAppended(int)),
+		framebulkTableModel, SLOT(logFramesAppended()));
+	connect(logTableModel, SIGNAL(logColumnsChanged()),
+		framebulkTableModel, SLOT(logColumnsChanged()));
+	framebulkTableView->setModel(framebulkTableModel);
+	framebulkTableView->setColumnWidth(FBIdHeader, 50);
+	framebulkTableView->setColumnWidth(FBFrameCountHeader, 50);
+	framebulkTableView->setColumnWidth(FBStartPositionHeader, 160);
+	framebulkTableView->setColumnWidth(FBEndPositionHeader, 160);
+}
+
+void FramebulkWindow::rowActivated(const QModelIndex &index)
+{
+	if (!index.isValid())
+		return;
+
+	const FramebulkEntry &entry = logTableModel->framebulkIndex().at(index.row());
+	emit framebulkActivated(entry.firstRow, entry.lastRow);
+}
+
+void FramebulkWindow::closeEvent(QCloseEvent *event)
+{
+	emit aboutToClose();
+	QDockWidget::closeEvent(event);
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <QtWidgets>
+#include "logtablemodel.hpp"
+#include "framebulktablemodel.hpp"
+
+class FramebulkWindow : public QDockWidget
+{
+	Q_OBJECT
+
+public:
+	FramebulkWindow(QWidget *parent, const LogTableModel *model);
+
+signals:
+	void aboutToClose();
+	void framebulkActivated(int firstRow, int lastRow);
+
+protected:
+	void closeEvent(QCloseEvent *event) override;
+
+private slots:
+	void rowActivated(const QModelIndex &index);
+
+private:
+	const LogTableModel *logTableModel;
+
+	QTableView *framebulkTableView;
+	FramebulkTableModel *framebulkTableModel;
+
+	void setupUi();
+};
@@ -0,0 +1,301 @@
+#include <algorithm>
+#include "framebyteindex.hpp"
+
+static const qint64 CopyChunkSize = 1 << 20;
+
+static inline bool isSpace(uchar c)
+{
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static const uchar *skipSpace(const uchar *p, const uchar *end)
+{
+	while (p != end && isSpace(*p))
+		++p;
+	return p;
+}
+
+// Returns the end of the string starting at p, or null if it is not terminated.
+static const uchar *skipString(const uchar *p, const uchar *end)
+{
+	for (++p; p != end; ++p) {
+		if (*p == '\\') {
+			if (++p == end)
+				return nullptr;
+		} else if (*p == '"')
+			return p + 1;
+	}
+	return nullptr;
+}
+
+// Returns the end of the value starting at p, or null if it is not terminated. Scalars are
+// not validated, since the parser accepts or rejects them anyway.
+static const uchar *skipValue(const uchar *p, const uchar *end)
+{
+	if (p == end)
+		return nullptr;
+	if (*p == '"')
+		return skipString(p, end);
+	if (*p != '{' && *p != '[') {
+		while (p != end && *p != ',' && *p != '}' && *p != ']' && !isSpace(*p))
+			++p;
+		// A scalar running into the end of the file may still be being written.
+		return p != end ? p : nullptr;
+	}
+
+	int depth = 0;
+	while (p != end) {
+		if (*p == '"') {
+			p = skipString(p, end);
+			if (!p)
+				return nullptr;
+			continue;
+		}
+		if (*p == '{' || *p == '[')
+			depth++;
+		else if ((*p == '}' || *p == ']') && --depth == 0)
+			return p + 1;
+		++p;
+	}
+	return nullptr;
+}
+
+void FrameByteIndex::clear()
+{
+	fileName.clear();
+	memberList.clear();
+	frameMemberIndex = -1;
+	frameBeginList.clear();
+	frameEndList.clear();
+	frameArrayClosed = false;
+	scanOffset = 0;
+	checkRange = ByteRange{0, 0};
+	checkBytes.clear();
+}
+
+bool FrameByteIndex::build(const QString &fileName, int physicsFrameCount)
+{
+	clear();
+
+	QFile file(fileName);
+	if (!file.open(QIODevice::ReadOnly) || file.size() == 0)
+		return false;
+	const uchar *data = file.map(0, file.size());
+	if (!data)
+		return false;
+
+	frameBeginList.reserve(physicsFrameCount);
+	frameEndList.reserve(physicsFrameCount);
+	if (!scan(data, data + file.size(), false) || frameBeginList.size() != physicsFrameCount) {
+		clear();
+		return false;
+	}
+
+	this->fileName = fileName;
+	updateCheckBytes(data);
+	return true;
+}
+
+bool FrameByteIndex::buildIncomplete(const QString &fileName)
+{
+	clear();
+
+	QFile file(fileName);
+	if (!file.open(QIODevice::ReadOnly) || file.size() == 0)
+		return false;
+	const uchar *data = file.map(0, file.size());
+	if (!data)
+		return false;
+
+	if (!scan(data, data + file.size(), true)) {
+		clear();
+		return false;
+	}
+
+	this->fileName = fileName;
+	updateCheckBytes(data);
+	return true;
+}
+
+int FrameByteIndex::update()
+{
+	if (!isValid())
+		return -1;
+
+	QFile file(fileName);
+	if (!file.open(QIODevice::ReadOnly) || !continuesIndexedContent(file))
+		return -1;
+	if (frameArrayClosed)
+		return 0;
+	const uchar *data = file.map(0, file.size());
+	if (!data)
+		return -1;
+
+	const int oldFrameCount = frameCount();
+	if (!scanFrames(data, data + file.size()))
+		return -1;
+	updateCheckBytes(data);
+	return frameCount() - oldFrameCount;
+}
+
+// Scans the top-level members up to the end of the object. An incomplete scan stops after
+// the last complete frame, ignoring whatever follows.
+bool FrameByteIndex::scan(const uchar *data, const uchar *end, bool incomplete)
+{
+	const uchar *p = skipSpace(data, end);
+	if (p == end || *p != '{')
+		return false;
+	p = skipSpace(p + 1, end);
+
+	while (p != end && *p == '"') {
+		const uchar *memberBegin = p;
+		p = skipString(p, end);
+		if (!p)
+			return false;
+		const uchar *keyEnd = p;
+		p = skipSpace(p, end);
+		if (p == end || *p != ':')
+			return false;
+		p = skipSpace(p + 1, end);
+
+		if (p != end && *p == '[' && frameMemberIndex == -1) {
+			frameMemberIndex = memberList.size();
+			const ByteRange key = {memberBegin - data, keyEnd - data};
+			memberList.append(key);
+			scanOffset = p + 1 - data;
+			if (!scanFrames(data, end))
+				return false;
+			if (!frameArrayClosed)
+				return incomplete;
+			p = data + scanOffset;
+		} else {
+			p = skipValue(p, end);
+			if (!p)
+				return false;
+			const ByteRange member = {memberBegin - data, p - data};
+			memberList.append(member);
+		}
+
+		p = skipSpace(p, end);
+		if (p == end)
+			return incomplete && frameMemberIndex != -1;
+		if (*p == '}')
+			return frameMemberIndex != -1;
+		if (*p != ',')
+			return false;
+		p = skipSpace(p + 1, end);
+	}
+	return incomplete && frameMemberIndex != -1;
+}
+
+// Scans frames from the scan offset on, stopping at the end of the array or at the first
+// incomplete frame. Returns false on a syntax error.
+bool FrameByteIndex::scanFrames(const uchar *data, const uchar *end)
+{
+	const uchar *p = data + scanOffset;
+	while (true) {
+		p = skipSpace(p, end);
+		if (p == end)
+			return true;
+		if (*p == ']') {
+			frameArrayClosed = true;
+			scanOffset = p + 1 - data;
+			return true;
+		}
+		if (!frameBeginList.isEmpty()) {
+			if (*p != ',')
+				return false;
+			p = skipSpace(p + 1, end);
+		}
+
+		const uchar *frameBegin = p;
+		p = skipValue(p, end);
+		if (!p)
+			return true;
+		frameBeginList.append(frameBegin - data);
+		frameEndList.append(p - data);
+		scanOffset = p - data;
+	}
+}
+
+void FrameByteIndex::updateCheckBytes(const uchar *data)
+{
+	if (frameBeginList.isEmpty())
+		checkRange = memberList.at(frameMemberIndex);
+	else
+		checkRange = ByteRange{frameBeginList.last(), frameEndList.last()};
+	checkBytes = QByteArray(reinterpret_cast<const char *>(data) + checkRange.begin,
+		checkRange.end - checkRange.begin);
+}
+
+bool FrameByteIndex::continuesIndexedContent(QFile &file) const
+{
+	if (file.size() < scanOffset || !file.seek(checkRange.begin))
+		return false;
+	return file.read(checkRange.end - checkRange.begin) == checkBytes;
+}
+
+bool FrameByteIndex::writeFrames(QIODevice *device, const QVector<int> &frameList,
+	QString *errorMessage, const QAtomicInt *canceled) const
+{
+	auto fail = [errorMessage](const QString &message) -> bool {
+		if (errorMessage)
+			*errorMessage = message;
+		return false;
+	};
+
+	QFile file(fileName);
+	if (!file.open(QIODevice::ReadOnly))
+		return fail(file.errorString());
+	if (!continuesIndexedContent(file))
+		return fail("The log file has changed since it was loaded.");
+
+	QByteArray buffer(CopyChunkSize, Qt::Uninitialized);
+	auto copy = [&](qint64 begin, qint64 end) -> bool {
+		if (!file.seek(begin))
+			return fail(file.errorString());
+		while (begin < end) {
+			if (canceled && canceled->load())
+				return fail("Saving was canceled.");
+			const qint64 size = std::min(end - begin, CopyChunkSize);
+			if (file.read(buffer.data(), size) != size)
+				return fail(file.errorString());
+			if (device->write(buffer.constData(), size) != size)
+				return fail(device->errorString());
+			begin += size;
+		}
+		return true;
+	};
+	auto put = [&](const char *text) -> bool {
+		const qint64 size = qstrlen(text);
+		return device->write(text, size) == size || fail(device->errorString());
+	};
+
+	if (!put("{"))
+		return false;
+	for (int i = 0; i < memberList.size(); i++) {
+		if (i > 0 && !put(","))
+			return false;
+		if (!copy(memberList.at(i).begin, memberList.at(i).end))
+			return false;
+		if (i != frameMemberIndex)
+			continue;
+
+		if (!put(":["))
+			return false;
+		for (int first = 0; first < frameList.size(); ) {
+			int last = first;
+			while (last + 1 < frameList.size() && frameList.at(last + 1) == frameList.at(last) + 1)
+				last++;
+			if (first > 0 && !put(","))
+				return false;
+			// Adjacent frames are contiguous in the file, separators included.
+			if (!copy(frameBeginList.at(frameList.at(first)), frameEndList.at(frameList.at(last))))
+				return false;
+			first = last + 1;
+		}
+		if (!put("]"))
+			return false;
+	}
+	return put("}");
+}
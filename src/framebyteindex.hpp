@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QtCore>
+
+// Byte ranges of the physics frames in the log file, so that a range of frames can be saved
+// as a smaller log by copying the raw bytes, and frames appended by the game can be parsed
+// on their own. The taslogger parser does not report offsets, so the file is scanned for the
+// JSON structure once it has been parsed: the physics frames are the elements of the one
+// top-level array, and every other top-level member, such as the tool version, build number
+// and game mod, is kept as a header.
+class FrameByteIndex
+{
+public:
+	// Returns false if the file cannot be mapped or does not hold the expected number of
+	// physics frames, leaving the index invalid.
+	bool build(const QString &fileName, int physicsFrameCount);
+
+	// Indexes a log that may still be written to, up to its last complete physics frame.
+	// Returns false if not even the header members and the start of the frames are there.
+	bool buildIncomplete(const QString &fileName);
+
+	// Indexes the physics frames completed since the last scan. Returns the number of new
+	// frames, or -1 if the file no longer continues the indexed content, e.g. because the
+	// game started writing it over.
+	int update();
+
+	void clear();
+
+	inline bool isValid() const { return frameMemberIndex != -1; }
+	inline int frameCount() const { return frameBeginList.size(); }
+
+	// Writes a log with the header members and the given ascending physics frames, copying
+	// them from the file without re-serializing. Runs of adjacent frames are copied at once.
+	bool writeFrames(QIODevice *device, const QVector<int> &frameList, QString *errorMessage,
+		const QAtomicInt *canceled = nullptr) const;
+
+private:
+	struct ByteRange
+	{
+		qint64 begin;
+		qint64 end;
+	};
+
+	QString fileName;
+	// Raw top-level members in file order. The frame array member holds only its key.
+	QVector<ByteRange> memberList;
+	int frameMemberIndex = -1;
+	QVector<qint64> frameBeginList;
+	QVector<qint64> frameEndList;
+	// Whether the frame array was closed, after which the game appends nothing more.
+	bool frameArrayClosed = false;
+	// Where scanning resumes, just after the last complete frame.
+	qint64 scanOffset = 0;
+	// Copy of the last indexed bytes, compared to tell an appended file from a new one.
+	ByteRange checkRange = {0, 0};
+	QByteArray checkBytes;
+
+	bool scan(const uchar *data, const uchar *end, bool incomplete);
+	bool scanFrames(const uchar *data, const uchar *end);
+	void updateCheckBytes(const uchar *data);
+	bool continuesIndexedContent(QFile &file) const;
+};
@@ -2,7 +2,7 @@
 #include "frameinspectorwindow.hpp"
 #include "settings.hpp"
 
-static const int ListWidgetFixedWidth = 60;
+static const int ListViewFixedWidth = 60;
 static const float M_U = 360.0 / 65536;
 static const QString NotAppl = "N/A";
 static const QString DegreesFormat = "%1˚";
@@ -48,6 +48,9 @@ void FrameInspectorWindow::setupUi()
 	QVBoxLayout *mainLayout = new QVBoxLayout(this);
 	setLayout(mainLayout);
 
+	sparklinePanel = new SparklinePanel(this, logTableModel);
+	mainLayout->addWidget(sparklinePanel);
+
 	tabWidget = new QTabWidget(this);
 	connect(tabWidget, SIGNAL(currentChanged(int)), this, SLOT(tabChanged(int)));
 	mainLayout->addWidget(tabWidget);
@@ -59,6 +62,20 @@ void FrameInspectorWindow::setupUi()
 	setupVelocityTab();
 	setupConsolePrintTab();
 	setupCommandBufferTab();
+
+	// The list models reference the log in place.
+	connect(logTableModel, SIGNAL(logColumnsAboutToChange()),
+		this, SLOT(logColumnsAboutToChange()));
+}
+
+void FrameInspectorWindow::setupEventListView(QListView *view, QAbstractItemModel *model,
+	const char *slot)
+{
+	view->setFixedWidth(ListViewFixedWidth);
+	view->setUniformItemSizes(true);
+	view->setModel(model);
+	connect(view->selectionModel(),
+		SIGNAL(currentChanged(const QModelIndex &, const QModelIndex &)), this, slot);
 }
 
 void FrameInspectorWindow::setupViewanglesTab()
@@ -116,9 +133,13 @@ void FrameInspectorWindow::setupConsolePrintTab()
 	QVBoxLayout *lay = new QVBoxLayout(consolePrintTab);
 	consolePrintTab->setLayout(lay);
 
-	consolePrintListWidget = new QListWidget(consolePrintTab);
-	consolePrintListWidget->setWordWrap(true);
-	lay->addWidget(consolePrintListWidget);
+	consolePrintListModel = new ConsolePrintListModel(this, logTableModel);
+	consolePrintListView = new QListView(consolePrintTab);
+	// Long prints are elided with the full text in the tooltip, since wrapped items would
+	// have to be measured one by one.
+	consolePrintListView->setUniformItemSizes(true);
+	consolePrintListView->setModel(consolePrintListModel);
+	lay->addWidget(consolePrintListView);
 }
 
 void FrameInspectorWindow::setupVelocityTab()
@@ -191,10 +212,10 @@ void FrameInspectorWindow::setupObjectMoveTab()
 	QGridLayout *lay = new QGridLayout(objectMoveTab);
 	objectMoveTab->setLayout(lay);
 
-	objectMoveListWidget = new QListWidget(objectMoveTab);
-	objectMoveListWidget->setFixedWidth(ListWidgetFixedWidth);
-	connect(objectMoveListWidget, SIGNAL(currentRowChanged(int)),
-		this, SLOT(objListCurrentRowChanged(int)));
+	objectMoveListModel = new EventNumberListModel(this);
+	objectMoveListView = new QListView(objectMoveTab);
+	setupEventListView(objectMoveListView, objectMoveListModel,
+		SLOT(objListCurrentChanged(const QModelIndex &)));
 
 	objPullLabel = new QLabel("Action:", objectMoveTab);
 	objVelXLabel = new QLabel("Velocity X:", objectMoveTab);
@@ -226,7 +247,7 @@ void FrameInspectorWindow::setupObjectMoveTab()
 	objPosYText->setTextInteractionFlags(Qt::TextSelectableByMouse);
 	objPosZText->setTextInteractionFlags(Qt::TextSelectableByMouse);
 
-	lay->addWidget(objectMoveListWidget, 0, 0, 10, 1);
+	lay->addWidget(objectMoveListView, 0, 0, 10, 1);
 
 	lay->addWidget(objPullLabel, 0, 1, Qt::AlignRight);
 	lay->addWidget(objVelXLabel, 1, 1, Qt::AlignRight);
@@ -274,10 +295,10 @@ void FrameInspectorWindow::setupDamageTab()
 	QGridLayout *lay = new QGridLayout(damageTab);
 	damageTab->setLayout(lay);
 
-	damageListWidget = new QListWidget(damageTab);
-	damageListWidget->setFixedWidth(ListWidgetFixedWidth);
-	connect(damageListWidget, SIGNAL(currentRowChanged(int)),
-		this, SLOT(damageListCurrentRowChanged(int)));
+	damageListModel = new EventNumberListModel(this);
+	damageListView = new QListView(damageTab);
+	setupEventListView(damageListView, damageListModel,
+		SLOT(damageListCurrentChanged(const QModelIndex &)));
 
 	dmgAmountLabel = new QLabel("Magnitude:", this);
 	dmgDirYawLabel = new QLabel("Dmg. dir. yaw:", this);
@@ -295,7 +316,7 @@ void FrameInspectorWindow::setupDamageTab()
 	dmgTypeText->setTextInteractionFlags(Qt::TextSelectableByMouse);
 	dmgTypeText->setWordWrap(true);
 
-	lay->addWidget(damageListWidget, 0, 0, 5, 1);
+	lay->addWidget(damageListView, 0, 0, 5, 1);
 
 	lay->addWidget(dmgAmountLabel, 0, 1, Qt::AlignRight);
 	lay->addWidget(dmgTypeLabel, 1, 1, Qt::AlignRight | Qt::AlignTop);
@@ -319,10 +340,10 @@ void FrameInspectorWindow::setupCollisionTab()
 	QGridLayout *lay = new QGridLayout(collisionTab);
 	collisionTab->setLayout(lay);
 
-	collisionListWidget = new QListWidget(collisionTab);
-	collisionListWidget->setFixedWidth(ListWidgetFixedWidth);
-	connect(collisionListWidget, SIGNAL(currentRowChanged(int)),
-		this, SLOT(colListCurrentRowChanged(int)));
+	collisionListModel = new EventNumberListModel(this);
+	collisionListView = new QListView(collisionTab);
+	setupEventListView(collisionListView, collisionListModel,
+		SLOT(colListCurrentChanged(const QModelIndex &)));
 
 	colEntityLabel = new QLabel("Entity:", collisionTab);
 	colImpactAngLabel = new QLabel("Impact angle:", collisionTab);
@@ -339,7 +360,7 @@ void FrameInspectorWindow::setupCollisionTab()
 	colNYawText->setTextInteractionFlags(Qt::TextSelectableByMouse);
 	colNPitchText->setTextInteractionFlags(Qt::TextSelectableByMouse);
 
-	lay->addWidget(collisionListWidget, 0, 0, 5, 1);
+	lay->addWidget(collisionListView, 0, 0, 5, 1);
 
 	lay->addWidget(colEntityLabel, 0, 1, Qt::AlignRight);
 	lay->addWidget(colNYawLabel, 1, 1, Qt::AlignRight);
@@ -368,14 +389,15 @@ void FrameInspectorWindow::inspectFrame()
 void FrameInspectorWindow::inspectFrame(int row)
 {
 	lastRow = row;
+	sparklinePanel->setCurrentRow(row);
 	if (row == -1)
 		return;
 
 	const QWidget *currentWidget = tabWidget->widget(tabWidget->currentIndex());
-	TASLogger::ReaderPhysicsFrame phyFrame;
-	TASLogger::ReaderCommandFrame *cmdFrame;
-	TASLogger::ReaderPlayerState *pmState;
-	logTableModel->getFrameData(row, phyFrame, &cmdFrame, &pmState);
+	const FrameRef frame = logTableModel->frameAt(row);
+	const TASLogger::ReaderPhysicsFrame &phyFrame = *frame.phyFrame;
+	const TASLogger::ReaderCommandFrame *cmdFrame = frame.cmdFrame;
+	const TASLogger::ReaderPlayerState *pmState = frame.pmState;
 
 	if (currentWidget == viewanglesTab) {
 		if (cmdFrame) {
@@ -395,13 +417,9 @@ void FrameInspectorWindow::inspectFrame(int row)
 			punchRollText->setText(NotAppl);
 		}
 	} else if (currentWidget == consolePrintTab) {
-		consolePrintListWidget->clear();
-		if (phyFrame.consolePrintList.empty())
-			return;
-
-		for (const std::string &msg : phyFrame.consolePrintList)
-			consolePrintListWidget->addItem(QString::fromStdString(msg).trimmed());
-		consolePrintListWidget->setCurrentRow(0);
+		consolePrintListModel->setRow(row);
+		if (!phyFrame.consolePrintList.empty())
+			currentEvent(consolePrintListView);
 	} else if (currentWidget == velocityTab) {
 		if (cmdFrame) {
 			const float hspeed = std::hypot(pmState->velocity[0], pmState->velocity[1]);
@@ -437,12 +455,10 @@ void FrameInspectorWindow::inspectFrame(int row)
 			bvelZText->setText(NotAppl);
 		}
 	} else if (currentWidget == objectMoveTab) {
-		objectMoveListWidget->clear();
-		if (!phyFrame.objectMoveList.empty()) {
-			for (size_t i = 1; i <= phyFrame.objectMoveList.size(); i++)
-				objectMoveListWidget->addItem(QString::number(i));
-			objectMoveListWidget->setCurrentRow(0);
-		} else {
+		objectMoveListModel->setCount(phyFrame.objectMoveList.size());
+		if (!phyFrame.objectMoveList.empty())
+			showObjectMove(phyFrame.objectMoveList.at(currentEvent(objectMoveListView)));
+		else {
 			objPullText->setText(NotAppl);
 			objVelXText->setText(NotAppl);
 			objVelYText->setText(NotAppl);
@@ -460,24 +476,20 @@ void FrameInspectorWindow::inspectFrame(int row)
 			: QString::fromStdString(phyFrame.commandBuffer)
 		);
 	} else if (currentWidget == damageTab) {
-		damageListWidget->clear();
-		if (!phyFrame.damageList.empty()) {
-			for (size_t i = 1; i <= phyFrame.damageList.size(); i++)
-				damageListWidget->addItem(QString::number(i));
-			damageListWidget->setCurrentRow(0);
-		} else {
+		damageListModel->setCount(phyFrame.damageList.size());
+		if (!phyFrame.damageList.empty())
+			showDamage(phyFrame.damageList.at(currentEvent(damageListView)));
+		else {
 			dmgAmountText->setText(NotAppl);
 			dmgDirYawText->setText(NotAppl);
 			dmgDirPitchText->setText(NotAppl);
 			dmgTypeText->setText(NotAppl);
 		}
 	} else if (currentWidget == collisionTab) {
-		collisionListWidget->clear();
-		if (cmdFrame && !cmdFrame->collisionList.empty()) {
-			for (size_t i = 1; i <= cmdFrame->collisionList.size(); i++)
-				collisionListWidget->addItem(QString::number(i));
-			collisionListWidget->setCurrentRow(0);
-		} else {
+		collisionListModel->setCount(cmdFrame ? cmdFrame->collisionList.size() : 0);
+		if (cmdFrame && !cmdFrame->collisionList.empty())
+			showCollision(cmdFrame->collisionList.at(currentEvent(collisionListView)));
+		else {
 			colEntityText->setText(NotAppl);
 			colImpactAngText->setText(NotAppl);
 			colNYawText->setText(NotAppl);
@@ -491,17 +503,33 @@ void FrameInspectorWindow::tabChanged(int)
 	inspectFrame();
 }
 
-void FrameInspectorWindow::objListCurrentRowChanged(int index)
+void FrameInspectorWindow::logColumnsAboutToChange()
+{
+	sparklinePanel->setCurrentRow(-1);
+	consolePrintListModel->setRow(-1);
+	objectMoveListModel->setCount(0);
+	damageListModel->setCount(0);
+	collisionListModel->setCount(0);
+}
+
+// Keeps the selected event when stepping through frames with as many events, and returns it.
+int FrameInspectorWindow::currentEvent(QListView *view)
 {
-	if (index == -1)
+	if (!view->currentIndex().isValid())
+		view->setCurrentIndex(view->model()->index(0, 0));
+	return view->currentIndex().row();
+}
+
+void FrameInspectorWindow::objListCurrentChanged(const QModelIndex &current)
+{
+	if (!current.isValid() || lastRow == -1)
 		return;
 
-	TASLogger::ReaderPhysicsFrame phyFrame;
-	TASLogger::ReaderCommandFrame *cmdFrame;
-	TASLogger::ReaderPlayerState *pmState;
-	logTableModel->getFrameData(lastRow, phyFrame, &cmdFrame, &pmState);
-	const TASLogger::ReaderObjectMove &obj = phyFrame.objectMoveList.at(index);
+	showObjectMove(logTableModel->frameAt(lastRow).phyFrame->objectMoveList.at(current.row()));
+}
 
+void FrameInspectorWindow::showObjectMove(const TASLogger::ReaderObjectMove &obj)
+{
 	objPullText->setText(obj.pull ? QStringLiteral("Pull") : QStringLiteral("Push"));
 	objVelXText->setText(QString::number(obj.velocity[0]));
 	objVelYText->setText(QString::number(obj.velocity[1]));
@@ -518,17 +546,16 @@ void FrameInspectorWindow::objListCurrentRowChanged(int index)
 	objPosZText->setText(QString::number(obj.position[2]));
 }
 
-void FrameInspectorWindow::damageListCurrentRowChanged(int index)
+void FrameInspectorWindow::damageListCurrentChanged(const QModelIndex &current)
 {
-	if (index == -1)
+	if (!current.isValid() || lastRow == -1)
 		return;
 
-	TASLogger::ReaderPhysicsFrame phyFrame;
-	TASLogger::ReaderCommandFrame *cmdFrame;
-	TASLogger::ReaderPlayerState *pmState;
-	logTableModel->getFrameData(lastRow, phyFrame, &cmdFrame, &pmState);
-	const TASLogger::ReaderDamage &dmg = phyFrame.damageList.at(index);
+	showDamage(logTableModel->frameAt(lastRow).phyFrame->damageList.at(current.row()));
+}
 
+void FrameInspectorWindow::showDamage(const TASLogger::ReaderDamage &dmg)
+{
 	const float distance = std::sqrt(
 		dmg.direction[0] * dmg.direction[0]
 		+ dmg.direction[1] * dmg.direction[1]
@@ -565,38 +592,26 @@ void FrameInspectorWindow::damageListCurrentRowChanged(int index)
 		: typeList.join(QStringLiteral(", ")));
 }
 
-void FrameInspectorWindow::colListCurrentRowChanged(int index)
+void FrameInspectorWindow::colListCurrentChanged(const QModelIndex &current)
 {
-	if (index == -1)
+	const TASLogger::ReaderCommandFrame *cmdFrame
+		= lastRow != -1 ? logTableModel->frameAt(lastRow).cmdFrame : nullptr;
+	if (!current.isValid() || !cmdFrame)
 		return;
 
-	TASLogger::ReaderPhysicsFrame phyFrame;
-	TASLogger::ReaderCommandFrame *cmdFrame;
-	TASLogger::ReaderPlayerState *pmState;
-	logTableModel->getFrameData(lastRow, phyFrame, &cmdFrame, &pmState);
-	const TASLogger::ReaderCollision &col = cmdFrame->collisionList.at(index);
+	showCollision(cmdFrame->collisionList.at(current.row()));
+}
 
+void FrameInspectorWindow::showCollision(const TASLogger::ReaderCollision &col)
+{
 	colEntityText->setText(!col.entity ? QStringLiteral("worldspawn")
 		: QString::number(col.entity));
 
-	if (col.impactVelocity[0] == 0.0 && col.impactVelocity[1] == 0.0
-		&& col.impactVelocity[2] == 0.0)
+	const float ang = collisionImpactAngle(col);
+	if (std::isnan(ang))
 		colImpactAngText->setText(NotAppl);
-	else {
-		const double ivel[3] = {
-			-col.impactVelocity[0], -col.impactVelocity[1], -col.impactVelocity[2]
-		};
-		const double dp = ivel[0] * col.normal[0]
-			+ ivel[1] * col.normal[1]
-			+ ivel[2] * col.normal[2];
-		const double impactMag = std::sqrt(
-			ivel[0] * ivel[0]
-			+ ivel[1] * ivel[1]
-			+ ivel[2] * ivel[2]
-		);
-		const float ang = std::acos(dp / impactMag) * 180 / M_PI;
+	else
 		colImpactAngText->setText(DegreesFormat.arg(ang));
-	}
 
 	if (col.normal[0] == 0.0 && col.normal[1] == 0.0)
 		colNYawText->setText(NotAppl);
@@ -2,6 +2,8 @@
 
 #include <QtWidgets>
 #include "logtablemodel.hpp"
+#include "inspectorlistmodel.hpp"
+#include "sparklinepanel.hpp"
 
 class FrameInspectorWindow : public QWidget
 {
@@ -26,14 +28,16 @@ protected:
 
 private slots:
 	void tabChanged(int index);
-	void damageListCurrentRowChanged(int index);
-	void objListCurrentRowChanged(int index);
-	void colListCurrentRowChanged(int index);
+	void damageListCurrentChanged(const QModelIndex &current);
+	void objListCurrentChanged(const QModelIndex &current);
+	void colListCurrentChanged(const QModelIndex &current);
+	void logColumnsAboutToChange();
 
 private:
 	int lastRow = -1;
 	const LogTableModel *logTableModel;
 
+	SparklinePanel *sparklinePanel;
 	QTabWidget *tabWidget;
 	QWidget *damageTab;
 	QWidget *velocityTab;
@@ -57,7 +61,8 @@ private:
 	QLabel *punchPitchText;
 	QLabel *punchRollText;
 
-	QListWidget *consolePrintListWidget;
+	QListView *consolePrintListView;
+	ConsolePrintListModel *consolePrintListModel;
 
 	QLabel *velXLabel;
 	QLabel *velYLabel;
@@ -79,7 +84,8 @@ private:
 	QLabel *bvelYText;
 	QLabel *bvelZText;
 
-	QListWidget *objectMoveListWidget;
+	QListView *objectMoveListView;
+	EventNumberListModel *objectMoveListModel;
 
 	QLabel *objPullLabel;
 	QLabel *objVelXLabel;
@@ -103,7 +109,8 @@ private:
 
 	QTextEdit *commandBufferText;
 
-	QListWidget *damageListWidget;
+	QListView *damageListView;
+	EventNumberListModel *damageListModel;
 
 	QLabel *dmgAmountLabel;
 	QLabel *dmgDirYawLabel;
@@ -115,7 +122,8 @@ private:
 	QLabel *dmgDirPitchText;
 	QLabel *dmgTypeText;
 
-	QListWidget *collisionListWidget;
+	QListView *collisionListView;
+	EventNumberListModel *collisionListModel;
 
 	QLabel *colEntityLabel;
 	QLabel *colImpactAngLabel;
@@ -134,4 +142,10 @@ private:
 	void setupCommandBufferTab();
 	void setupDamageTab();
 	void setupCollisionTab();
+	void setupEventListView(QListView *view, QAbstractItemModel *model, const char *slot);
+
+	int currentEvent(QListView *view);
+	void showObjectMove(const TASLogger::ReaderObjectMove &obj);
+	void showDamage(const TASLogger::ReaderDamage &dmg);
+	void showCollision(const TASLogger::ReaderCollision &col);
 };
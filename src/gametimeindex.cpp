@@ -0,0 +1,80 @@
+#include <algorithm>
+#include "gametimeindex.hpp"
+
+void GameTimeIndex::clear()
+{
+	elapsedTime.clear();
+	firstRow.clear();
+	commandFrames.clear();
+}
+
+void GameTimeIndex::build(const TASLogger::TASLog &tasLog)
+{
+	clear();
+
+	const int count = tasLog.physicsFrameList.size();
+	elapsedTime.reserve(count + 1);
+	firstRow.reserve(count + 1);
+	commandFrames.reserve(count + 1);
+	append(tasLog, 0);
+}
+
+void GameTimeIndex::append(const TASLogger::TASLog &tasLog, int firstFrame)
+{
+	// The trailing elements are where the appended frames start.
+	double time = 0;
+	int row = 0;
+	int cmds = 0;
+	if (!elapsedTime.isEmpty()) {
+		time = elapsedTime.takeLast();
+		row = firstRow.takeLast();
+		cmds = commandFrames.takeLast();
+	}
+
+	for (size_t p = firstFrame; p < tasLog.physicsFrameList.size(); p++) {
+		const TASLogger::ReaderPhysicsFrame &phy = tasLog.physicsFrameList[p];
+		elapsedTime.append(time);
+		firstRow.append(row);
+		commandFrames.append(cmds);
+		time += phy.frameTime;
+		row += std::max<int>(1, phy.commandFrameList.size());
+		cmds += phy.commandFrameList.size();
+	}
+	elapsedTime.append(time);
+	firstRow.append(row);
+	commandFrames.append(cmds);
+}
+
+int GameTimeIndex::findPhysicsFrame(double time) const
+{
+	const int count = physicsFrameCount();
+	if (count <= 0)
+		return -1;
+
+	const auto it = std::upper_bound(elapsedTime.cbegin(), elapsedTime.cbegin() + count, time);
+	return std::max(0, static_cast<int>(it - elapsedTime.cbegin()) - 1);
+}
+
+int GameTimeIndex::findPhysicsFrameByRow(int row) const
+{
+	const auto it = std::upper_bound(firstRow.cbegin(), firstRow.cend(), row);
+	return static_cast<int>(it - firstRow.cbegin()) - 1;
+}
+
+int GameTimeIndex::findCommandFrameRow(int cmdIndex) const
+{
+	if (cmdIndex < 0 || cmdIndex >= commandFrameCount())
+		return -1;
+
+	// The physics frame p satisfies commandFrames[p] <= cmdIndex < commandFrames[p + 1].
+	const auto it = std::upper_bound(commandFrames.cbegin(), commandFrames.cend(), cmdIndex);
+	const int phy = static_cast<int>(it - commandFrames.cbegin()) - 1;
+	return firstRow.at(phy) + cmdIndex - commandFrames.at(phy);
+}
+
+int GameTimeIndex::commandFrameIndex(int phyIndex, int row) const
+{
+	const int offset = row - firstRow.at(phyIndex);
+	const int cmds = commandFrames.at(phyIndex + 1) - commandFrames.at(phyIndex);
+	return commandFrames.at(phyIndex) + std::min(offset, cmds) - (cmds ? 0 : 1);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <algorithm>
+#include <QtCore>
+#include "taslogger/reader.hpp"
+
+// Maps game time, physics frame numbers and command frame numbers to table rows. All
+// vectors are prefix arrays over physicsFrameList with one extra trailing element.
+class GameTimeIndex
+{
+public:
+	void build(const TASLogger::TASLog &tasLog);
+	// Extends the index with the physics frames from firstFrame on, appended since the last
+	// build.
+	void append(const TASLogger::TASLog &tasLog, int firstFrame);
+	void clear();
+
+	inline int physicsFrameCount() const { return std::max(0, elapsedTime.size() - 1); }
+	inline int commandFrameCount() const
+	{
+		return commandFrames.isEmpty() ? 0 : commandFrames.last();
+	}
+	inline double totalTime() const { return elapsedTime.isEmpty() ? 0 : elapsedTime.last(); }
+
+	// Game time at the start of the physics frame.
+	inline double timeAt(int phyIndex) const { return elapsedTime.at(phyIndex); }
+	inline int physicsFrameRow(int phyIndex) const { return firstRow.at(phyIndex); }
+
+	// Returns the physics frame being simulated at the given time, clamped to the log.
+	int findPhysicsFrame(double time) const;
+
+	// Returns the physics frame the row belongs to.
+	int findPhysicsFrameByRow(int row) const;
+
+	// Returns the row of the zero-based command frame number.
+	int findCommandFrameRow(int cmdIndex) const;
+
+	// Returns the zero-based command frame number of the row, or of the last command frame
+	// before it if the row has none.
+	int commandFrameIndex(int phyIndex, int row) const;
+
+private:
+	QVector<double> elapsedTime;
+	QVector<int> firstRow;
+	QVector<int> commandFrames;
+};
@@ -0,0 +1,76 @@
+#include "inspectorlistmodel.hpp"
+
+ConsolePrintListModel::ConsolePrintListModel(QObject *parent, const LogTableModel *model)
+	: QAbstractListModel(parent), logTableModel(model)
+{
+}
+
+const std::vector<std::string> *ConsolePrintListModel::printList() const
+{
+	return row != -1 ? &logTableModel->frameAt(row).phyFrame->consolePrintList : nullptr;
+}
+
+void ConsolePrintListModel::setRow(int newRow)
+{
+	if (newRow == row)
+		return;
+
+	const std::vector<std::string> *oldList = printList();
+	const std::vector<std::string> *list = newRow != -1
+		? &logTableModel->frameAt(newRow).phyFrame->consolePrintList : nullptr;
+	const bool empty = !list || list->empty();
+	const bool wasEmpty = !oldList || oldList->empty();
+	if ((empty && wasEmpty) || (list && oldList && *list == *oldList)) {
+		row = newRow;
+		return;
+	}
+
+	beginResetModel();
+	row = newRow;
+	endResetModel();
+}
+
+int ConsolePrintListModel::rowCount(const QModelIndex &parent) const
+{
+	const std::vector<std::string> *list = printList();
+	if (parent.isValid() || !list)
+		return 0;
+	return static_cast<int>(list->size());
+}
+
+QVariant ConsolePrintListModel::data(const QModelIndex &index, int role) const
+{
+	if (role != Qt::DisplayRole && role != Qt::ToolTipRole)
+		return QVariant();
+	return QString::fromStdString(printList()->at(index.row())).trimmed();
+}
+
+EventNumberListModel::EventNumberListModel(QObject *parent)
+	: QAbstractListModel(parent)
+{
+}
+
+void EventNumberListModel::setCount(int newCount)
+{
+	if (newCount > count) {
+		beginInsertRows(QModelIndex(), count, newCount - 1);
+		count = newCount;
+		endInsertRows();
+	} else if (newCount < count) {
+		beginRemoveRows(QModelIndex(), newCount, count - 1);
+		count = newCount;
+		endRemoveRows();
+	}
+}
+
+int EventNumberListModel::rowCount(const QModelIndex &parent) const
+{
+	return parent.isValid() ? 0 : count;
+}
+
+QVariant EventNumberListModel::data(const QModelIndex &index, int role) const
+{
+	if (role != Qt::DisplayRole)
+		return QVariant();
+	return index.row() + 1;
+}
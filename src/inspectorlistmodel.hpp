@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <QtCore>
+#include "logtablemodel.hpp"
+
+// Console prints of the inspected row. Only the row is stored and its prints are looked up on
+// each access, since appending frames to a followed log moves the frames.
+class ConsolePrintListModel : public QAbstractListModel
+{
+	Q_OBJECT
+
+public:
+	ConsolePrintListModel(QObject *parent, const LogTableModel *model);
+
+	// Resets the model only if the prints differ from the shown ones. -1 clears the list.
+	void setRow(int newRow);
+
+	int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+	QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+private:
+	const LogTableModel *logTableModel;
+	int row = -1;
+
+	const std::vector<std::string> *printList() const;
+};
+
+// Numbers the damages, object moves or collisions of the inspected frame from one. Only the
+// count is stored, so stepping between frames with as many events changes nothing.
+class EventNumberListModel : public QAbstractListModel
+{
+	Q_OBJECT
+
+public:
+	EventNumberListModel(QObject *parent);
+
+	void setCount(int newCount);
+
+	int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+	QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+private:
+	int count = 0;
+};
@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "logcolumns.hpp"
+
+static const float NaN = std::numeric_limits<float>::quiet_NaN();
+
+struct LogFieldAlias
+{
+	const char *name;
+	LogField field;
+};
+
+static const LogFieldAlias LogFieldAliasList[] = {
+	{"vspd", VelocityZField},
+	{"yaw", YawField},
+	{"pitch", PitchField},
+};
+
+int findLogField(const QString &name)
+{
+	for (int i = 0; i < LogFieldCount; i++) {
+		if (LogFieldNameList[i] == name)
+			return i;
+	}
+	for (const LogFieldAlias &alias : LogFieldAliasList) {
+		if (name == QLatin1String(alias.name))
+			return alias.field;
+	}
+	return -1;
+}
+
+void LogColumns::clear()
+{
+	for (QVector<float> &values : fieldList)
+		values.clear();
+}
+
+void LogColumns::build(const TASLogger::TASLog &tasLog, bool prePlayerMove)
+{
+	clear();
+	append(tasLog, 0, prePlayerMove);
+}
+
+void LogColumns::append(const TASLogger::TASLog &tasLog, int firstFrame, bool prePlayerMove)
+{
+	int row = rowCount();
+	int rows = row;
+	for (size_t p = firstFrame; p < tasLog.physicsFrameList.size(); p++)
+		rows += std::max<int>(1, tasLog.physicsFrameList[p].commandFrameList.size());
+
+	float *f[LogFieldCount];
+	for (int i = 0; i < LogFieldCount; i++) {
+		fieldList[i].resize(rows);
+		f[i] = fieldList[i].data();
+	}
+
+	for (size_t p = firstFrame; p < tasLog.physicsFrameList.size(); p++) {
+		const TASLogger::ReaderPhysicsFrame &phy = tasLog.physicsFrameList[p];
+		if (phy.commandFrameList.empty()) {
+			for (int i = 0; i < LogFieldCount; i++)
+				f[i][row] = NaN;
+			f[FrameTimeField][row] = phy.frameTime;
+			f[ClientStateField][row] = phy.clientState;
+			++row;
+			continue;
+		}
+
+		for (const TASLogger::ReaderCommandFrame &cmd : phy.commandFrameList) {
+			const TASLogger::ReaderPlayerState &pm = prePlayerMove ? cmd.prePMState
+				: cmd.postPMState;
+
+			f[FrameTimeField][row] = phy.frameTime;
+			f[MsecField][row] = cmd.msec;
+			f[FramebulkIdField][row] = cmd.framebulkId;
+			f[VelocityXField][row] = pm.velocity[0];
+			f[VelocityYField][row] = pm.velocity[1];
+			f[VelocityZField][row] = pm.velocity[2];
+			f[HorizontalSpeedField][row] = std::hypot(pm.velocity[0], pm.velocity[1]);
+			f[VelocityYawField][row] = pm.velocity[0] == 0.0 && pm.velocity[1] == 0.0 ? NaN
+				: std::atan2(pm.velocity[1], pm.velocity[0]) * 180 / M_PI;
+			f[OnGroundField][row] = pm.onGround;
+			f[DuckStateField][row] = pm.duckState;
+			f[JumpField][row] = (cmd.buttons & IN_JUMP) != 0;
+			f[DuckField][row] = (cmd.buttons & IN_DUCK) != 0;
+			f[ForwardMoveField][row] = cmd.FSU[0];
+			f[SideMoveField][row] = cmd.FSU[1];
+			f[UpMoveField][row] = cmd.FSU[2];
+			f[YawField][row] = cmd.viewangles[0];
+			f[PitchField][row] = cmd.viewangles[1];
+			f[HealthField][row] = cmd.health;
+			f[ArmorField][row] = cmd.armor;
+			f[UseField][row] = (cmd.buttons & IN_USE) != 0;
+			f[AttackField][row] = (cmd.buttons & IN_ATTACK) != 0;
+			f[Attack2Field][row] = (cmd.buttons & IN_ATTACK2) != 0;
+			f[ReloadField][row] = (cmd.buttons & IN_RELOAD) != 0;
+			f[OnLadderField][row] = pm.onLadder;
+			f[WaterLevelField][row] = pm.waterLevel;
+			f[ClientStateField][row] = phy.clientState;
+			f[FrameTimeRemainderField][row] = cmd.frameTimeRemainder;
+			f[EntityFrictionField][row] = cmd.entFriction;
+			f[EntityGravityField][row] = cmd.entGravity;
+			f[PositionXField][row] = pm.position[0];
+			f[PositionYField][row] = pm.position[1];
+			f[PositionZField][row] = pm.position[2];
+			++row;
+		}
+	}
+}
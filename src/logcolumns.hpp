@@ -0,0 +1,112 @@
+#pragma once
+
+#include <QtCore>
+#include "taslogger/reader.hpp"
+
+// Numeric per-row fields of the log. Fields of command frames are NaN on rows without one.
+enum LogField {
+	FrameTimeField = 0,
+	MsecField,
+	FramebulkIdField,
+	VelocityXField,
+	VelocityYField,
+	VelocityZField,
+	HorizontalSpeedField,
+	VelocityYawField,
+	OnGroundField,
+	DuckStateField,
+	JumpField,
+	DuckField,
+	ForwardMoveField,
+	SideMoveField,
+	UpMoveField,
+	YawField,
+	PitchField,
+	HealthField,
+	ArmorField,
+	UseField,
+	AttackField,
+	Attack2Field,
+	ReloadField,
+	OnLadderField,
+	WaterLevelField,
+	ClientStateField,
+	FrameTimeRemainderField,
+	EntityFrictionField,
+	EntityGravityField,
+	PositionXField,
+	PositionYField,
+	PositionZField,
+	LogFieldCount
+};
+
+// Names of the fields in user expressions.
+static const QString LogFieldNameList[] = {
+	"ft",
+	"ms",
+	"bid",
+	"vx",
+	"vy",
+	"vz",
+	"hspd",
+	"vyaw",
+	"g",
+	"k",
+	"j",
+	"d",
+	"f",
+	"s",
+	"u",
+	"y",
+	"p",
+	"hp",
+	"ap",
+	"e",
+	"attack",
+	"attack2",
+	"r",
+	"l",
+	"w",
+	"c",
+	"rem",
+	"ef",
+	"eg",
+	"posx",
+	"posy",
+	"posz",
+};
+
+// Returns the field with the given expression name, or -1. The vertical speed column name
+// "vspd" and the longer names "yaw" and "pitch" are accepted as well.
+int findLogField(const QString &name);
+
+const int IN_ATTACK = 1 << 0;
+const int IN_JUMP = 1 << 1;
+const int IN_DUCK = 1 << 2;
+const int IN_FORWARD = 1 << 3;
+const int IN_BACK = 1 << 4;
+const int IN_USE = 1 << 5;
+const int IN_LEFT = 1 << 7;
+const int IN_RIGHT = 1 << 8;
+const int IN_MOVELEFT = 1 << 9;
+const int IN_MOVERIGHT = 1 << 10;
+const int IN_ATTACK2 = 1 << 11;
+const int IN_RELOAD = 1 << 13;
+
+// Column-oriented copy of the numeric content of the log, one contiguous array per field,
+// so that analyses over millions of rows never have to walk the frame structures.
+class LogColumns
+{
+public:
+	void build(const TASLogger::TASLog &tasLog, bool prePlayerMove);
+	// Appends the rows of the physics frames from firstFrame on, appended since the last build.
+	void append(const TASLogger::TASLog &tasLog, int firstFrame, bool prePlayerMove);
+	void clear();
+
+	inline int rowCount() const { return fieldList[0].size(); }
+	inline const float *field(int field) const { return fieldList[field].constData(); }
+	inline float value(int field, int row) const { return fieldList[field].at(row); }
+
+private:
+	QVector<float> fieldList[LogFieldCount];
+};
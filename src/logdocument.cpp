@@ -0,0 +1,209 @@
+#include <cstdio>
+#include <iterator>
+#include "logdocument.hpp"
+
+LogFileError LogDocument::load(const QString &fileName, bool allowIncomplete)
+{
+	const QByteArray nameBytes = fileName.toLatin1();
+	FILE *file = fopen(nameBytes.data(), "rb");
+	if (!file)
+		return LFErrorCannotOpen;
+
+	const rapidjson::ParseResult res = TASLogger::ParseFile(file, _tasLog);
+	fclose(file);
+
+	if (res) {
+		// Without the byte ranges, saving frames as a new log and appending are unavailable.
+		_frameByteIndex.build(fileName, _tasLog.physicsFrameList.size());
+	} else {
+		// The trailing frame and the closing brackets may still be missing.
+		_tasLog = TASLogger::TASLog();
+		if (!allowIncomplete || !_frameByteIndex.buildIncomplete(fileName)
+			|| !parseFrames(0, _tasLog)) {
+			// Left empty rather than with indexes of the previous log.
+			_tasLog = TASLogger::TASLog();
+			_frameByteIndex.clear();
+			buildIndexes();
+			return LFErrorInvalidLogFile;
+		}
+	}
+
+	buildIndexes();
+	return LFErrorNone;
+}
+
+bool LogDocument::appendFrames()
+{
+	const int firstFrame = _frameByteIndex.frameCount();
+	const int newFrameCount = _frameByteIndex.update();
+	if (newFrameCount < 0)
+		return false;
+	if (newFrameCount == 0)
+		return true;
+
+	TASLogger::TASLog appended;
+	if (!parseFrames(firstFrame, appended))
+		return false;
+	_tasLog.physicsFrameList.insert(_tasLog.physicsFrameList.end(),
+		std::make_move_iterator(appended.physicsFrameList.begin()),
+		std::make_move_iterator(appended.physicsFrameList.end()));
+
+	appendToIndexes(firstFrame);
+	return true;
+}
+
+DocumentReader LogDocument::startReading() const
+{
+	DocumentReader token = reader.toStrongRef();
+	if (!token) {
+		// The token only tracks the readers and does not own the document.
+		token = DocumentReader(this, [](const LogDocument *) {});
+		reader = token;
+	}
+	return token;
+}
+
+// Parses the indexed frames from the first one on, written with the header members into a
+// temporary log, since the parser only reads whole files.
+bool LogDocument::parseFrames(int firstFrame, TASLogger::TASLog &tasLog) const
+{
+	QVector<int> frameList;
+	frameList.reserve(_frameByteIndex.frameCount() - firstFrame);
+	for (int frame = firstFrame; frame < _frameByteIndex.frameCount(); frame++)
+		frameList.append(frame);
+
+	QTemporaryFile tempFile;
+	if (!tempFile.open() || !_frameByteIndex.writeFrames(&tempFile, frameList, nullptr))
+		return false;
+	tempFile.close();
+
+	FILE *file = fopen(QFile::encodeName(tempFile.fileName()).constData(), "rb");
+	if (!file)
+		return false;
+	const rapidjson::ParseResult res = TASLogger::ParseFile(file, tasLog);
+	fclose(file);
+	return res && tasLog.physicsFrameList.size() == static_cast<size_t>(frameList.size());
+}
+
+void LogDocument::buildIndexes()
+{
+	populateCommandToPhysicsIndex();
+	_framebulkIndex.build(_tasLog);
+	_gameTimeIndex.build(_tasLog);
+	_eventIndex.build(_tasLog);
+	_entityIndex.build(_tasLog);
+	frameTimeCounts.clear();
+	msecCounts.clear();
+	countFrameTimes(0);
+	buildLogColumns();
+}
+
+// Extends the indexes with the rows of the appended physics frames, without going over the
+// earlier rows again.
+void LogDocument::appendToIndexes(int firstFrame)
+{
+	const int firstRow = rowCount();
+	appendCommandToPhysicsIndex(firstFrame);
+	_rowPrefixSums.append(_tasLog, firstFrame, _prePlayerMove);
+	_framebulkIndex.append(_tasLog, firstFrame, firstRow);
+	_gameTimeIndex.append(_tasLog, firstFrame);
+	_eventIndex.append(_tasLog, firstFrame, firstRow);
+	_entityIndex.append(_tasLog, firstFrame, firstRow);
+
+	const float oldFrameTime = _mostCommonFrameTime;
+	countFrameTimes(firstFrame);
+	// The densities are relative to the most common frame time.
+	if (_mostCommonFrameTime != oldFrameTime)
+		_eventDensityPyramid.build(_tasLog, _mostCommonFrameTime, _prePlayerMove);
+	else
+		_eventDensityPyramid.append(_tasLog, firstFrame, _mostCommonFrameTime, _prePlayerMove);
+
+	_logColumns.append(_tasLog, firstFrame, _prePlayerMove);
+	_rangeStatistics.append();
+	_spatialIndex.append(_logColumns, firstRow);
+}
+
+void LogDocument::setPrePlayerMove(bool pre)
+{
+	_prePlayerMove = pre;
+	buildLogColumns();
+}
+
+void LogDocument::populateCommandToPhysicsIndex()
+{
+	commandToPhysicsIndex.clear();
+	commandToPhysicsIndex.reserve(_tasLog.physicsFrameList.size());
+	appendCommandToPhysicsIndex(0);
+}
+
+void LogDocument::appendCommandToPhysicsIndex(int firstFrame)
+{
+	for (size_t phy = firstFrame; phy < _tasLog.physicsFrameList.size(); phy++) {
+		const auto &f = _tasLog.physicsFrameList.at(phy);
+		commandToPhysicsIndex.append(phy);
+		for (size_t j = 1; j < f.commandFrameList.size(); j++)
+			commandToPhysicsIndex.append(phy);
+	}
+}
+
+template<class T>
+static T findMostCommonElement(const std::unordered_map<T, size_t> &table)
+{
+	size_t occurrence = 0;
+	T element{};
+	for (const auto pair : table) {
+		if (pair.second > occurrence) {
+			occurrence = pair.second;
+			element = pair.first;
+		}
+	}
+	return element;
+}
+
+// Adds the physics frames from firstFrame on to the counts and finds the most common values.
+void LogDocument::countFrameTimes(int firstFrame)
+{
+	for (size_t p = firstFrame; p < _tasLog.physicsFrameList.size(); p++) {
+		const TASLogger::ReaderPhysicsFrame &phy = _tasLog.physicsFrameList[p];
+		++frameTimeCounts[phy.frameTime];
+		for (const TASLogger::ReaderCommandFrame &cmd : phy.commandFrameList)
+			++msecCounts[cmd.msec];
+	}
+	_mostCommonFrameTime = findMostCommonElement(frameTimeCounts);
+	_mostCommonMsec = findMostCommonElement(msecCounts);
+}
+
+void LogDocument::buildLogColumns()
+{
+	_logColumns.build(_tasLog, _prePlayerMove);
+	_rowPrefixSums.build(_tasLog, _prePlayerMove);
+	_eventDensityPyramid.build(_tasLog, _mostCommonFrameTime, _prePlayerMove);
+	_rangeStatistics.build(_logColumns);
+	_spatialIndex.build(_logColumns);
+}
+
+double LogDocument::duration(int first, int last) const
+{
+	const int firstPhy = commandToPhysicsIndex.at(first);
+	const double start = first == _gameTimeIndex.physicsFrameRow(firstPhy)
+		? _gameTimeIndex.timeAt(firstPhy) : _gameTimeIndex.timeAt(firstPhy + 1);
+	return _gameTimeIndex.timeAt(commandToPhysicsIndex.at(last) + 1) - start;
+}
+
+FrameRef LogDocument::frameAt(int row) const
+{
+	const int phy = commandToPhysicsIndex.at(row);
+	const TASLogger::ReaderPhysicsFrame &phyFrame = _tasLog.physicsFrameList[phy];
+
+	FrameRef frame;
+	frame.phyFrame = &phyFrame;
+	frame.cmdFrame = nullptr;
+	frame.pmState = nullptr;
+	frame.elapsedTime = _gameTimeIndex.timeAt(phy);
+	if (!phyFrame.commandFrameList.empty()) {
+		frame.cmdFrame = &phyFrame.commandFrameList[row - _gameTimeIndex.physicsFrameRow(phy)];
+		frame.pmState = _prePlayerMove ? &frame.cmdFrame->prePMState
+			: &frame.cmdFrame->postPMState;
+	}
+	return frame;
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <unordered_map>
+#include <QtCore>
+#include "taslogger/reader.hpp"
+#include "logcolumns.hpp"
+#include "rowprefixsums.hpp"
+#include "rangestatistics.hpp"
+#include "spatialindex.hpp"
+#include "gametimeindex.hpp"
+#include "eventindex.hpp"
+#include "entityindex.hpp"
+#include "eventdensitypyramid.hpp"
+#include "framebulkindex.hpp"
+#include "framebyteindex.hpp"
+
+enum LogFileError
+{
+	LFErrorNone,
+	LFErrorCannotOpen,
+	LFErrorInvalidLogFile
+};
+
+// The frames shown by a row, referenced in place. The command frame and player state are null
+// for physics frames without command frames.
+struct FrameRef
+{
+	const TASLogger::ReaderPhysicsFrame *phyFrame;
+	const TASLogger::ReaderCommandFrame *cmdFrame;
+	const TASLogger::ReaderPlayerState *pmState;
+	double elapsedTime;
+};
+
+class LogDocument;
+// Held by workers reading the document on other threads, while appending frames would move
+// the vectors they read.
+typedef QSharedPointer<const LogDocument> DocumentReader;
+
+// A parsed log with the indexes built over its rows. It does not depend on widgets, so logs
+// can be loaded on worker threads without a display, as the batch mode does.
+class LogDocument
+{
+public:
+	// Loads the log. A log still being written by the game is only accepted if incomplete
+	// logs are allowed, in which case it is loaded up to its last complete physics frame.
+	LogFileError load(const QString &fileName, bool allowIncomplete = false);
+
+	// Parses the physics frames appended to the log file since it was loaded and extends the
+	// indexes with their rows. Returns false if the file no longer continues the loaded log,
+	// which must then be loaded again. Must not be called while the document is being read.
+	bool appendFrames();
+
+	// Returns a token to hold while reading the document on another thread.
+	DocumentReader startReading() const;
+	// Whether a token returned by startReading() is still held.
+	inline bool isBeingRead() const { return !reader.isNull(); }
+
+	// Rebuilds the log columns, the row prefix sums and the event densities from the pre-PM
+	// or post-PM player states.
+	void setPrePlayerMove(bool pre);
+	inline bool prePlayerMove() const { return _prePlayerMove; }
+
+	inline int rowCount() const { return commandToPhysicsIndex.size(); }
+	inline int physicsFrameIndex(int row) const { return commandToPhysicsIndex.at(row); }
+
+	// Returns the frames of the row without copying them.
+	FrameRef frameAt(int row) const;
+
+	// Game time spent by the rows in [first, last], in constant time. A physics frame
+	// contributes its frametime through the first row belonging to it.
+	double duration(int first, int last) const;
+
+	inline float mostCommonFrameTime() const { return _mostCommonFrameTime; }
+	inline int mostCommonMsec() const { return _mostCommonMsec; }
+
+	inline const TASLogger::TASLog &tasLog() const { return _tasLog; }
+	inline const RowPrefixSums &rowPrefixSums() const { return _rowPrefixSums; }
+	inline const FramebulkIndex &framebulkIndex() const { return _framebulkIndex; }
+	inline const LogColumns &logColumns() const { return _logColumns; }
+	inline const RangeStatistics &rangeStatistics() const { return _rangeStatistics; }
+	inline const SpatialIndex &spatialIndex() const { return _spatialIndex; }
+	inline const GameTimeIndex &gameTimeIndex() const { return _gameTimeIndex; }
+	inline const EventIndex &eventIndex() const { return _eventIndex; }
+	inline const EntityIndex &entityIndex() const { return _entityIndex; }
+	inline const FrameByteIndex &frameByteIndex() const { return _frameByteIndex; }
+	inline const EventDensityPyramid &eventDensityPyramid() const
+	{
+		return _eventDensityPyramid;
+	}
+
+private:
+	TASLogger::TASLog _tasLog;
+	QVector<int> commandToPhysicsIndex;
+	RowPrefixSums _rowPrefixSums;
+	FramebulkIndex _framebulkIndex;
+	LogColumns _logColumns;
+	RangeStatistics _rangeStatistics;
+	SpatialIndex _spatialIndex;
+	GameTimeIndex _gameTimeIndex;
+	EventIndex _eventIndex;
+	EntityIndex _entityIndex;
+	EventDensityPyramid _eventDensityPyramid;
+	FrameByteIndex _frameByteIndex;
+	bool _prePlayerMove = false;
+	float _mostCommonFrameTime = 0;
+	int _mostCommonMsec = 0;
+	// Occurrences of the frame times and msec values, updated with the appended frames.
+	std::unordered_map<float, size_t> frameTimeCounts;
+	std::unordered_map<uint8_t, size_t> msecCounts;
+	mutable QWeakPointer<const LogDocument> reader;
+
+	bool parseFrames(int firstFrame, TASLogger::TASLog &tasLog) const;
+	void buildIndexes();
+	void appendToIndexes(int firstFrame);
+	void populateCommandToPhysicsIndex();
+	void appendCommandToPhysicsIndex(int firstFrame);
+	void countFrameTimes(int firstFrame);
+	void buildLogColumns();
+};
@@ -0,0 +1,211 @@
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include "logexporter.hpp"
+
+static const float M_U = 360.0 / 65536;
+static const int BufferSize = 1 << 20;
+// Longest cell the formatting can produce, e.g. "-1.23457e+38".
+static const int MaxCellSize = 32;
+
+static const char *ExportExtraColumnNameList[] = {"time", "phy", "seed", "idum"};
+static const char FSULetterList[][2] = {{'B', 'F'}, {'L', 'R'}, {'D', 'U'}};
+
+static const double PowerOfTenList[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10
+};
+
+QString exportFileExtension(ExportFormat format)
+{
+	switch (format) {
+	case TsvFormat:
+		return "tsv";
+	case ColumnarFormat:
+		return "qcrcol";
+	default:
+		return "csv";
+	}
+}
+
+QString exportColumnName(int column)
+{
+	if (column < LogFieldCount)
+		return LogFieldNameList[column];
+	return ExportExtraColumnNameList[column - LogFieldCount];
+}
+
+int findExportColumn(const QString &name)
+{
+	const int field = findLogField(name);
+	if (field != -1)
+		return field;
+	for (int column = LogFieldCount; column < ExportColumnCount; column++) {
+		if (name == QLatin1String(ExportExtraColumnNameList[column - LogFieldCount]))
+			return column;
+	}
+	return -1;
+}
+
+static char *formatInteger(char *p, quint64 value)
+{
+	char digits[20];
+	int count = 0;
+	do {
+		digits[count++] = '0' + value % 10;
+		value /= 10;
+	} while (value);
+	while (count)
+		*p++ = digits[--count];
+	return p;
+}
+
+static char *formatInteger(char *p, qint64 value)
+{
+	if (value < 0) {
+		*p++ = '-';
+		return formatInteger(p, static_cast<quint64>(-(value + 1)) + 1);
+	}
+	return formatInteger(p, static_cast<quint64>(value));
+}
+
+// Formats like printf("%g"), with six significant digits. Values printed in fixed notation
+// are rounded with integer arithmetic, the rest fall back to snprintf.
+static char *formatNumber(char *p, double value)
+{
+	if (value == 0) {
+		*p++ = '0';
+		return p;
+	}
+	if (value < 0) {
+		*p++ = '-';
+		value = -value;
+	}
+	if (value < 1e6 && value == std::floor(value))
+		return formatInteger(p, static_cast<quint64>(value));
+
+	int exponent = static_cast<int>(std::floor(std::log10(value)));
+	if (exponent >= -4 && exponent < 6) {
+		int decimals = 5 - exponent;
+		quint64 scaled = std::llround(value * PowerOfTenList[decimals]);
+		// Rounding carried into a seventh digit, e.g. 9.999996.
+		if (scaled >= 1000000 && decimals > 0) {
+			decimals--;
+			scaled = std::llround(value * PowerOfTenList[decimals]);
+		}
+		if (scaled < 1000000) {
+			const quint64 unit = static_cast<quint64>(PowerOfTenList[decimals]);
+			quint64 fraction = scaled % unit;
+			p = formatInteger(p, scaled / unit);
+			if (fraction) {
+				while (fraction % 10 == 0) {
+					fraction /= 10;
+					decimals--;
+				}
+				*p++ = '.';
+				char *end = p + decimals;
+				for (char *digit = end; digit != p; fraction /= 10)
+					*--digit = '0' + fraction % 10;
+				p = end;
+			}
+			return p;
+		}
+	}
+
+	return p + snprintf(p, MaxCellSize, "%g", value);
+}
+
+LogExporter::LogExporter(const LogDocument &document, const ExportOptions &options)
+	: document(document), options(options)
+{
+}
+
+char *LogExporter::formatCell(char *p, int column, int row) const
+{
+	switch (column) {
+	case ElapsedTimeColumn:
+		return formatNumber(p, document.gameTimeIndex().timeAt(document.physicsFrameIndex(row)));
+	case PhysicsFrameColumn:
+		return formatInteger(p, static_cast<qint64>(document.physicsFrameIndex(row)));
+	case SharedSeedColumn: {
+		const TASLogger::ReaderCommandFrame *cmdFrame = document.frameAt(row).cmdFrame;
+		return cmdFrame ? formatInteger(p, static_cast<qint64>(cmdFrame->sharedSeed)) : p;
+	}
+	case NonSharedRNGColumn:
+		return formatInteger(p, static_cast<qint64>(document.frameAt(row).phyFrame->rng.idum));
+	}
+
+	const float value = document.logColumns().value(column, row);
+	if (std::isnan(value))
+		return p;
+
+	switch (column) {
+	case YawField:
+	case PitchField:
+		return formatNumber(p, options.anglemodUnit ? value / M_U : value);
+	case ForwardMoveField:
+	case SideMoveField:
+	case UpMoveField:
+		if (options.fsuValues)
+			return formatNumber(p, value);
+		if (value != 0)
+			*p++ = FSULetterList[column - ForwardMoveField][value > 0];
+		return p;
+	default:
+		return formatNumber(p, value);
+	}
+}
+
+bool LogExporter::write(QIODevice *device, QString *errorMessage,
+	const QAtomicInt *canceled) const
+{
+	const char separator = options.format == TsvFormat ? '\t' : ',';
+	const int columnCount = options.columnList.size();
+	const int maxRowSize = columnCount * (MaxCellSize + 1) + 1;
+
+	QByteArray buffer(BufferSize + maxRowSize, Qt::Uninitialized);
+	char *const begin = buffer.data();
+	char *p = begin;
+
+	auto flush = [&]() {
+		if (device->write(begin, p - begin) != p - begin) {
+			if (errorMessage)
+				*errorMessage = device->errorString();
+			return false;
+		}
+		p = begin;
+		return true;
+	};
+
+	for (int i = 0; i < columnCount; i++) {
+		if (i > 0)
+			*p++ = separator;
+		const QByteArray name = exportColumnName(options.columnList.at(i)).toUtf8();
+		memcpy(p, name.constData(), name.size());
+		p += name.size();
+	}
+	*p++ = '\n';
+
+	const bool allRows = options.rowList.isEmpty();
+	const int rowCount = allRows ? document.rowCount() : options.rowList.size();
+	for (int i = 0; i < rowCount; i++) {
+		const int row = allRows ? i : options.rowList.at(i);
+		for (int j = 0; j < columnCount; j++) {
+			if (j > 0)
+				*p++ = separator;
+			p = formatCell(p, options.columnList.at(j), row);
+		}
+		*p++ = '\n';
+
+		if (p - begin >= BufferSize) {
+			if (canceled && canceled->load()) {
+				if (errorMessage)
+					*errorMessage = "The export was canceled.";
+				return false;
+			}
+			if (!flush())
+				return false;
+		}
+	}
+
+	return flush();
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QtCore>
+#include "logdocument.hpp"
+
+enum ExportFormat {
+	CsvFormat = 0,
+	TsvFormat,
+	// Every column and row in the binary format of ColumnarExporter.
+	ColumnarFormat
+};
+
+// Columns exported besides the log fields, numbered after them.
+enum ExportExtraColumn {
+	ElapsedTimeColumn = LogFieldCount,
+	PhysicsFrameColumn,
+	SharedSeedColumn,
+	NonSharedRNGColumn,
+	ExportColumnCount
+};
+
+struct ExportOptions
+{
+	ExportFormat format = CsvFormat;
+	// LogField or ExportExtraColumn values, in the order of the exported columns.
+	QVector<int> columnList;
+	// Rows to export in the order written, or all rows if empty.
+	QVector<int> rowList;
+	bool anglemodUnit = false;
+	// Whether the moves are written as values rather than as their F/B, L/R and D/U letters.
+	bool fsuValues = false;
+};
+
+// Returns the file name extension of the format, without the dot.
+QString exportFileExtension(ExportFormat format);
+
+// Returns the header name of the export column.
+QString exportColumnName(int column);
+
+// Returns the export column with the given name, or -1. Log fields are found by their
+// expression names.
+int findExportColumn(const QString &name);
+
+// Writes the rows of the log as CSV or TSV. The cells are formatted straight from the log
+// columns into a large buffer that is flushed to the device whenever it fills, so the memory
+// used does not depend on the number of rows. Numbers are written with six significant
+// digits, as the log table shows them, and blank cells are left empty.
+class LogExporter
+{
+public:
+	LogExporter(const LogDocument &document, const ExportOptions &options);
+
+	// Returns false if writing failed or the export was canceled.
+	bool write(QIODevice *device, QString *errorMessage,
+		const QAtomicInt *canceled = nullptr) const;
+
+private:
+	const LogDocument &document;
+	ExportOptions options;
+
+	char *formatCell(char *p, int column, int row) const;
+};
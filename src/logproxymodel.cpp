@@ -0,0 +1,440 @@
+#include <algorithm>
+#include "logproxymodel.hpp"
+
+// Rows gained by the row map in more runs than this are shown by resetting the model rather
+// than inserting each run.
+static const int MaxInsertedRuns = 32;
+
+LogProxyModel::LogProxyModel(QObject *parent)
+	: QAbstractProxyModel(parent)
+{
+}
+
+void LogProxyModel::setSourceModel(QAbstractItemModel *model)
+{
+	beginResetModel();
+
+	if (sourceModel())
+		disconnect(sourceModel(), nullptr, this, nullptr);
+
+	QAbstractProxyModel::setSourceModel(model);
+	dropRowMap();
+
+	connect(model, SIGNAL(dataChanged(const QModelIndex &, const QModelIndex &,
+			const QVector<int> &)),
+		this, SLOT(sourceDataChanged(const QModelIndex &, const QModelIndex &,
+			const QVector<int> &)));
+	connect(model, SIGNAL(headerDataChanged(Qt::Orientation, int, int)),
+		this, SLOT(sourceHeaderDataChanged(Qt::Orientation, int, int)));
+	connect(model, SIGNAL(rowsAboutToBeInserted(const QModelIndex &, int, int)),
+		this, SLOT(sourceRowsAboutToBeInserted(const QModelIndex &, int, int)));
+	connect(model, SIGNAL(rowsInserted(const QModelIndex &, int, int)),
+		this, SLOT(sourceRowsInserted()));
+	connect(model, SIGNAL(rowsAboutToBeRemoved(const QModelIndex &, int, int)),
+		this, SLOT(sourceRowsAboutToBeRemoved(const QModelIndex &, int, int)));
+	connect(model, SIGNAL(rowsRemoved(const QModelIndex &, int, int)),
+		this, SLOT(sourceRowsRemoved()));
+	connect(model, SIGNAL(columnsAboutToBeInserted(const QModelIndex &, int, int)),
+		this, SLOT(sourceColumnsAboutToBeInserted(const QModelIndex &, int, int)));
+	connect(model, SIGNAL(columnsInserted(const QModelIndex &, int, int)),
+		this, SLOT(sourceColumnsInserted()));
+	connect(model, SIGNAL(columnsAboutToBeRemoved(const QModelIndex &, int, int)),
+		this, SLOT(sourceColumnsAboutToBeRemoved(const QModelIndex &, int, int)));
+	connect(model, SIGNAL(columnsRemoved(const QModelIndex &, int, int)),
+		this, SLOT(sourceColumnsRemoved()));
+	connect(model, SIGNAL(modelAboutToBeReset()), this, SLOT(sourceAboutToBeReset()));
+	connect(model, SIGNAL(modelReset()), this, SLOT(sourceReset()));
+
+	endResetModel();
+}
+
+void LogProxyModel::setFilterRows(const QVector<int> &rows)
+{
+	filtered = true;
+	filterRows = rows;
+	updateRowMap();
+}
+
+void LogProxyModel::clearFilterRows()
+{
+	if (!filtered)
+		return;
+	filtered = false;
+	filterRows.clear();
+	updateRowMap();
+}
+
+void LogProxyModel::appendFilterRows(const QVector<int> &rows)
+{
+	if (!filtered) {
+		setFilterRows(rows);
+		return;
+	}
+	filterRows += rows;
+	insertRowMap();
+}
+
+void LogProxyModel::setSortPermutation(const QVector<int> &permutation)
+{
+	sorted = true;
+	sortPermutation = permutation;
+	updateRowMap();
+}
+
+void LogProxyModel::clearSortPermutation()
+{
+	if (!sorted)
+		return;
+	sorted = false;
+	sortPermutation.clear();
+	updateRowMap();
+}
+
+void LogProxyModel::extendSortPermutation(const QVector<int> &permutation)
+{
+	if (!sorted) {
+		setSortPermutation(permutation);
+		return;
+	}
+	sortPermutation = permutation;
+	insertRowMap();
+}
+
+QVector<int> LogProxyModel::buildRowMap() const
+{
+	if (!sorted)
+		return filterRows;
+	if (!filtered)
+		return sortPermutation;
+
+	QVector<quint8> keep(sourceModel()->rowCount(), 0);
+	for (int row : filterRows)
+		keep[row] = 1;
+	QVector<int> rowMap;
+	rowMap.reserve(filterRows.size());
+	for (int row : sortPermutation) {
+		if (keep.at(row))
+			rowMap.append(row);
+	}
+	return rowMap;
+}
+
+void LogProxyModel::updateRowMap()
+{
+	beginResetModel();
+
+	mapped = filtered || sorted;
+	proxyToSource = buildRowMap();
+	updateSourceToProxy();
+
+	endResetModel();
+	emit rowMapChanged();
+}
+
+// Inserts the rows the row map gained, so that the views keep their selection and scrolling.
+// The rows it held must keep their order.
+void LogProxyModel::insertRowMap()
+{
+	const QVector<int> rowMap = buildRowMap();
+	QVector<int> runFirstList;
+	QVector<int> runCountList;
+	for (int i = 0; i < rowMap.size(); i++) {
+		if (sourceToProxy.at(rowMap.at(i)) != -1)
+			continue;
+		if (!runFirstList.isEmpty() && runFirstList.last() + runCountList.last() == i)
+			runCountList.last()++;
+		else {
+			runFirstList.append(i);
+			runCountList.append(1);
+		}
+	}
+
+	int insertedCount = 0;
+	for (int count : runCountList)
+		insertedCount += count;
+	if (runFirstList.size() > MaxInsertedRuns
+		|| rowMap.size() - insertedCount != proxyToSource.size()) {
+		updateRowMap();
+		return;
+	}
+	if (runFirstList.isEmpty())
+		return;
+
+	// Each run is inserted at its final position, as the runs before it are already there.
+	// The source to proxy map is only rebuilt once every run is in, so it is stale while the
+	// views take the insertions, which only map proxy rows to source rows.
+	for (int r = 0; r < runFirstList.size(); r++) {
+		const int first = runFirstList.at(r);
+		const int count = runCountList.at(r);
+		beginInsertRows(QModelIndex(), first, first + count - 1);
+		proxyToSource.insert(first, count, -1);
+		std::copy(rowMap.cbegin() + first, rowMap.cbegin() + first + count,
+			proxyToSource.begin() + first);
+		endInsertRows();
+	}
+	updateSourceToProxy();
+	emit rowMapChanged();
+}
+
+void LogProxyModel::updateSourceToProxy()
+{
+	sourceToProxy.clear();
+	runStartList.clear();
+	if (mapped) {
+		sourceToProxy.fill(-1, sourceModel()->rowCount());
+		for (int i = 0; i < proxyToSource.size(); i++)
+			sourceToProxy[proxyToSource.at(i)] = i;
+	}
+	if (sorted) {
+		for (int i = 0; i < proxyToSource.size(); i++) {
+			if (i == 0 || proxyToSource.at(i) != proxyToSource.at(i - 1) + 1)
+				runStartList.append(i);
+		}
+	}
+}
+
+void LogProxyModel::dropRowMap()
+{
+	mapped = false;
+	filtered = false;
+	sorted = false;
+	filterRows.clear();
+	sortPermutation.clear();
+	proxyToSource.clear();
+	sourceToProxy.clear();
+	runStartList.clear();
+}
+
+int LogProxyModel::sourceRow(int proxyRow) const
+{
+	if (proxyRow < 0)
+		return -1;
+	return mapped ? proxyToSource.at(proxyRow) : proxyRow;
+}
+
+int LogProxyModel::proxyRow(int sourceRow) const
+{
+	if (sourceRow < 0)
+		return -1;
+	return mapped ? sourceToProxy.at(sourceRow) : sourceRow;
+}
+
+int LogProxyModel::lastVisibleSourceRow(int sourceRow) const
+{
+	// Sorting alone hides no rows.
+	if (!filtered)
+		return sourceRow;
+	const auto it = std::upper_bound(filterRows.cbegin(), filterRows.cend(), sourceRow);
+	return it != filterRows.cbegin() ? *(it - 1) : -1;
+}
+
+QVector<QPair<int, int>> LogProxyModel::sourceSpans(int firstProxyRow, int lastProxyRow) const
+{
+	QVector<QPair<int, int>> spanList;
+	if (!mapped) {
+		spanList.append(qMakePair(firstProxyRow, lastProxyRow));
+		return spanList;
+	}
+
+	if (!sorted) {
+		// The ascending filter rows are consecutive while they keep the same offset from their
+		// proxy rows, and the offset never decreases, so the end of each run is searched for.
+		for (int row = firstProxyRow; row <= lastProxyRow; ) {
+			const int offset = proxyToSource.at(row) - row;
+			int low = row + 1;
+			int high = lastProxyRow + 1;
+			while (low < high) {
+				const int middle = low + (high - low) / 2;
+				if (proxyToSource.at(middle) - middle == offset)
+					low = middle + 1;
+				else
+					high = middle;
+			}
+			spanList.append(qMakePair(proxyToSource.at(row), proxyToSource.at(low - 1)));
+			row = low;
+		}
+		return spanList;
+	}
+
+	auto run = std::upper_bound(runStartList.cbegin(), runStartList.cend(), firstProxyRow) - 1;
+	for (; run != runStartList.cend() && *run <= lastProxyRow; ++run) {
+		const int first = std::max(*run, firstProxyRow);
+		const int next = run + 1 != runStartList.cend() ? *(run + 1) : proxyToSource.size();
+		const int last = std::min(next - 1, lastProxyRow);
+		spanList.append(qMakePair(proxyToSource.at(first), proxyToSource.at(last)));
+	}
+	return spanList;
+}
+
+int LogProxyModel::nearestProxyRow(int sourceRow) const
+{
+	if (!mapped)
+		return std::min(sourceRow, rowCount() - 1);
+	if (!filtered)
+		return proxyRow(sourceRow);
+	if (filterRows.isEmpty())
+		return -1;
+
+	const auto it = std::lower_bound(filterRows.cbegin(), filterRows.cend(), sourceRow);
+	return proxyRow(it != filterRows.cend() ? *it : filterRows.last());
+}
+
+QModelIndex LogProxyModel::mapToSource(const QModelIndex &proxyIndex) const
+{
+	if (!proxyIndex.isValid() || !sourceModel())
+		return QModelIndex();
+	return sourceModel()->index(sourceRow(proxyIndex.row()), proxyIndex.column());
+}
+
+QModelIndex LogProxyModel::mapFromSource(const QModelIndex &sourceIndex) const
+{
+	if (!sourceIndex.isValid())
+		return QModelIndex();
+	const int row = proxyRow(sourceIndex.row());
+	if (row == -1)
+		return QModelIndex();
+	return createIndex(row, sourceIndex.column());
+}
+
+QModelIndex LogProxyModel::index(int row, int column, const QModelIndex &parent) const
+{
+	if (parent.isValid() || row < 0 || column < 0
+		|| row >= rowCount() || column >= columnCount())
+		return QModelIndex();
+	return createIndex(row, column);
+}
+
+QModelIndex LogProxyModel::parent(const QModelIndex &) const
+{
+	return QModelIndex();
+}
+
+int LogProxyModel::rowCount(const QModelIndex &parent) const
+{
+	if (parent.isValid() || !sourceModel())
+		return 0;
+	return mapped ? proxyToSource.size() : sourceModel()->rowCount();
+}
+
+int LogProxyModel::columnCount(const QModelIndex &parent) const
+{
+	if (parent.isValid() || !sourceModel())
+		return 0;
+	return sourceModel()->columnCount();
+}
+
+QVariant LogProxyModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+	// Vertical headers keep the numbers of the source rows.
+	if (orientation == Qt::Vertical)
+		return sourceModel()->headerData(sourceRow(section), orientation, role);
+	return sourceModel()->headerData(section, orientation, role);
+}
+
+void LogProxyModel::sourceDataChanged(const QModelIndex &topLeft,
+	const QModelIndex &bottomRight, const QVector<int> &roles)
+{
+	if (!mapped) {
+		emit dataChanged(mapFromSource(topLeft), mapFromSource(bottomRight), roles);
+		return;
+	}
+
+	if (rowCount() == 0)
+		return;
+	emit dataChanged(index(0, topLeft.column()),
+		index(rowCount() - 1, bottomRight.column()), roles);
+}
+
+void LogProxyModel::sourceHeaderDataChanged(Qt::Orientation orientation, int first, int last)
+{
+	if (orientation == Qt::Horizontal || !mapped)
+		emit headerDataChanged(orientation, first, last);
+	else if (rowCount() > 0)
+		emit headerDataChanged(orientation, 0, rowCount() - 1);
+}
+
+// Row changes in the source invalidate the row map, so the proxy falls back to showing all
+// rows. The changes are forwarded as they are otherwise. Rows appended to the source keep
+// the row map and stay hidden until the filter or the sort adds them.
+
+void LogProxyModel::sourceRowsAboutToBeInserted(const QModelIndex &, int first, int last)
+{
+	if (mapped && first == sourceModel()->rowCount())
+		appendingRows = true;
+	else if (mapped)
+		beginResetModel();
+	else
+		beginInsertRows(QModelIndex(), first, last);
+}
+
+void LogProxyModel::sourceRowsInserted()
+{
+	if (appendingRows) {
+		appendingRows = false;
+		const int count = sourceModel()->rowCount() - sourceToProxy.size();
+		sourceToProxy.insert(sourceToProxy.size(), count, -1);
+		return;
+	}
+	if (!mapped) {
+		endInsertRows();
+		return;
+	}
+
+	dropRowMap();
+	endResetModel();
+	emit rowMapChanged();
+}
+
+void LogProxyModel::sourceRowsAboutToBeRemoved(const QModelIndex &, int first, int last)
+{
+	if (mapped)
+		beginResetModel();
+	else
+		beginRemoveRows(QModelIndex(), first, last);
+}
+
+void LogProxyModel::sourceRowsRemoved()
+{
+	if (!mapped) {
+		endRemoveRows();
+		return;
+	}
+
+	dropRowMap();
+	endResetModel();
+	emit rowMapChanged();
+}
+
+void LogProxyModel::sourceColumnsAboutToBeInserted(const QModelIndex &, int first, int last)
+{
+	beginInsertColumns(QModelIndex(), first, last);
+}
+
+void LogProxyModel::sourceColumnsInserted()
+{
+	endInsertColumns();
+}
+
+void LogProxyModel::sourceColumnsAboutToBeRemoved(const QModelIndex &, int first, int last)
+{
+	beginRemoveColumns(QModelIndex(), first, last);
+}
+
+void LogProxyModel::sourceColumnsRemoved()
+{
+	endRemoveColumns();
+}
+
+void LogProxyModel::sourceAboutToBeReset()
+{
+	beginResetModel();
+}
+
+void LogProxyModel::sourceReset()
+{
+	const bool wasMapped = mapped;
+	dropRowMap();
+	endResetModel();
+	if (wasMapped)
+		emit rowMapChanged();
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <QtWidgets>
+
+// Proxy between the log table model and its view that shows a subset of the source rows in
+// some order through a plain row vector. The row map combines the rows kept by the filter
+// with the order of the sort permutation. Without either, the proxy passes every row through.
+//
+// The filter rows and the sort permutation are computed on worker threads by the filter bar
+// and the row sorter. Both connect to logColumnsAboutToChange() directly, since their workers
+// must be stopped before the log table model changes the data they read.
+class LogProxyModel : public QAbstractProxyModel
+{
+	Q_OBJECT
+
+public:
+	LogProxyModel(QObject *parent = nullptr);
+
+	void setSourceModel(QAbstractItemModel *model) override;
+
+	// Shows only the given source rows, which must be in ascending order.
+	void setFilterRows(const QVector<int> &rows);
+	void clearFilterRows();
+	inline bool hasFilter() const { return filtered; }
+	// Shows the given source rows too, which must be in ascending order and follow the rows
+	// already shown, such as the matching rows of those appended to the source.
+	void appendFilterRows(const QVector<int> &rows);
+
+	// Shows the rows in the order of the permutation of every source row.
+	void setSortPermutation(const QVector<int> &permutation);
+	void clearSortPermutation();
+	inline bool isSorted() const { return sorted; }
+	// Replaces the permutation by one that keeps the order of the rows it held and places the
+	// rows appended to the source among them.
+	void extendSortPermutation(const QVector<int> &permutation);
+
+	inline bool hasRowMap() const { return mapped; }
+
+	int sourceRow(int proxyRow) const;
+
+	// Returns the proxy row of the source row, or -1 if it is hidden.
+	int proxyRow(int sourceRow) const;
+
+	// Returns the runs of consecutive source rows shown by the proxy rows, as pairs of the
+	// first and last source row in proxy order.
+	QVector<QPair<int, int>> sourceSpans(int firstProxyRow, int lastProxyRow) const;
+
+	// Returns the last visible source row at or before the given one, or -1 if there is none.
+	int lastVisibleSourceRow(int sourceRow) const;
+
+	// Returns the proxy row of the first visible source row at or after the given one,
+	// falling back to the last visible source row.
+	int nearestProxyRow(int sourceRow) const;
+
+	QModelIndex mapToSource(const QModelIndex &proxyIndex) const override;
+	QModelIndex mapFromSource(const QModelIndex &sourceIndex) const override;
+	QModelIndex index(int row, int column,
+		const QModelIndex &parent = QModelIndex()) const override;
+	QModelIndex parent(const QModelIndex &child) const override;
+	int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+	int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+	QVariant headerData(int section, Qt::Orientation orientation,
+		int role = Qt::DisplayRole) const override;
+
+signals:
+	void rowMapChanged();
+
+private slots:
+	void sourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+		const QVector<int> &roles);
+	void sourceHeaderDataChanged(Qt::Orientation orientation, int first, int last);
+	void sourceRowsAboutToBeInserted(const QModelIndex &parent, int first, int last);
+	void sourceRowsInserted();
+	void sourceRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+	void sourceRowsRemoved();
+	void sourceColumnsAboutToBeInserted(const QModelIndex &parent, int first, int last);
+	void sourceColumnsInserted();
+	void sourceColumnsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+	void sourceColumnsRemoved();
+	void sourceAboutToBeReset();
+	void sourceReset();
+
+private:
+	bool mapped = false;
+	bool filtered = false;
+	bool sorted = false;
+	// Whether the rows being inserted in the source are appended to a mapped proxy.
+	bool appendingRows = false;
+	QVector<int> filterRows;
+	QVector<int> sortPermutation;
+	QVector<int> proxyToSource;
+	QVector<int> sourceToProxy;
+	// Proxy rows starting a run of consecutive source rows, kept while sorted.
+	QVector<int> runStartList;
+
+	QVector<int> buildRowMap() const;
+	void updateRowMap();
+	void insertRowMap();
+	void updateSourceToProxy();
+	void dropRowMap();
+};
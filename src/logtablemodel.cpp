@@ -1,622 +1,396 @@
-#include <cstdio>
+#include <algorithm>
 #include <cmath>
 #include <limits>
-#include <unordered_map>
 #include "logtablemodel.hpp"
 
-static const float M_U = 360.0 / 65536;
-static const QString BaseVelFormat = "*%1";
+static const QColor HighlightColor(255, 200, 120);
+// Interval at which the appended frames are parsed while the game keeps writing.
+static const int FollowInterval = 250;
 
 LogTableModel::LogTableModel(QObject *parent)
 	: QAbstractTableModel(parent)
 {
+	_computedColumns = new ComputedColumns(this, &document);
+	connect(_computedColumns, SIGNAL(columnReady(int)), this, SLOT(computedColumnReady(int)));
+	connect(&textSearchWatcher, SIGNAL(finished()), this, SLOT(textSearchIndexBuilt()));
+
+	followTimer.setSingleShot(true);
+	followTimer.setInterval(FollowInterval);
+	connect(&followTimer, SIGNAL(timeout()), this, SLOT(appendLogFrames()));
+	connect(&fileWatcher, SIGNAL(fileChanged(const QString &)), this, SLOT(logFileChanged()));
 }
 
-void LogTableModel::populateCommandToPhysicsIndex()
+LogTableModel::~LogTableModel()
 {
-	commandToPhysicsIndex.clear();
-	commandToPhysicsIndex.reserve(_tasLog.physicsFrameList.size());
-	for (size_t phy = 0; phy < _tasLog.physicsFrameList.size(); phy++) {
-		const auto &f = _tasLog.physicsFrameList.at(phy);
-		commandToPhysicsIndex.append(phy);
-		for (size_t j = 1; j < f.commandFrameList.size(); j++)
-			commandToPhysicsIndex.append(phy);
-	}
+	// The evaluations and the text search indexing read the log, which is destroyed before
+	// the child objects.
+	_computedColumns->stop();
+	stopTextSearchIndex();
 }
 
 LogFileError LogTableModel::openLogFile(const QString &fileName)
 {
 	_logFileName = fileName;
 
-	const QByteArray nameBytes = fileName.toLatin1();
-	FILE *file = fopen(nameBytes.data(), "rb");
-	if (!file)
+	// The workers read the log, so they are only stopped once it is about to be replaced.
+	if (!QFileInfo(fileName).isReadable())
 		return LFErrorCannotOpen;
 
-	const rapidjson::ParseResult res = TASLogger::ParseFile(file, _tasLog);
-	fclose(file);
+	if (following) {
+		if (!fileWatcher.files().isEmpty())
+			fileWatcher.removePaths(fileWatcher.files());
+		fileWatcher.addPath(fileName);
+	}
 
-	if (!res)
-		return LFErrorInvalidLogFile;
+	_computedColumns->stop();
+	stopTextSearchIndex();
+	emit logColumnsAboutToChange();
+	return loadDocument();
+}
 
-	removeRows(0, commandToPhysicsIndex.size());
+// Loads the log file into the document once the workers reading it have stopped.
+LogFileError LogTableModel::loadDocument()
+{
+	const int oldRowCount = rowCount();
+	followedFileSize = QFileInfo(_logFileName).size();
+	const LogFileError res = document.load(_logFileName, following);
+	if (res == LFErrorCannotOpen) {
+		// The document is unchanged.
+		if (logLoaded) {
+			_computedColumns->refresh();
+			startTextSearchIndex();
+		}
+		emit logColumnsChanged();
+		return res;
+	}
 
-	populateCommandToPhysicsIndex();
+	removeRows(0, oldRowCount);
+	_highlightedRows.clear();
+	if (res != LFErrorNone) {
+		logLoaded = false;
+		emit logColumnsChanged();
+		emit logFileLoaded(false);
+		return res;
+	}
+
+	columnOptions.mostCommonFrameTimes = document.mostCommonFrameTime();
+	columnOptions.mostCommonMsec = document.mostCommonMsec();
+	_computedColumns->refresh();
+	startTextSearchIndex();
 
 	logLoaded = true;
-	insertRows(0, commandToPhysicsIndex.size());
+	insertRows(0, document.rowCount());
 
+	emit logColumnsChanged();
 	emit logFileLoaded(true);
 
 	return LFErrorNone;
 }
 
+void LogTableModel::setFollowing(bool enable)
+{
+	following = enable;
+	followTimer.stop();
+	if (!fileWatcher.files().isEmpty())
+		fileWatcher.removePaths(fileWatcher.files());
+	if (!enable || _logFileName.isEmpty())
+		return;
+
+	fileWatcher.addPath(_logFileName);
+	// Catch up with what was written before following, or load a log rejected as incomplete.
+	followedFileSize = -1;
+	followTimer.start();
+}
+
+void LogTableModel::logFileChanged()
+{
+	// The timer is not restarted, so a game writing continuously is followed at its interval.
+	if (!followTimer.isActive())
+		followTimer.start();
+}
+
+void LogTableModel::appendLogFrames()
+{
+	if (!following)
+		return;
+	// Files replaced rather than written to are dropped from the watcher.
+	if (!fileWatcher.files().contains(_logFileName))
+		fileWatcher.addPath(_logFileName);
+
+	const qint64 fileSize = QFileInfo(_logFileName).size();
+	if (fileSize == followedFileSize)
+		return;
+	// Appending moves the frames the workers read, so it waits for them rather than canceling
+	// a sort or an export.
+	if (document.isBeingRead()) {
+		followTimer.start();
+		return;
+	}
+
+	const int oldRowCount = rowCount();
+	const int oldFrameCount = static_cast<int>(document.tasLog().physicsFrameList.size());
+	if (!logLoaded || !document.appendFrames()) {
+		// Nothing could be loaded before, or the game started writing the log over.
+		_computedColumns->stop();
+		stopTextSearchIndex();
+		emit logColumnsAboutToChange();
+		loadDocument();
+		return;
+	}
+	followedFileSize = fileSize;
+
+	const int newRowCount = document.rowCount();
+	if (newRowCount == oldRowCount)
+		return;
+
+	if (_textSearchIndexReady)
+		_textSearchIndex.append(document.tasLog(), oldFrameCount);
+	_computedColumns->appendRows(oldRowCount);
+	insertRows(oldRowCount, newRowCount - oldRowCount);
+	// The frame times shown as blanks may change with the new frames.
+	if (columnOptions.mostCommonFrameTimes != document.mostCommonFrameTime()
+		|| columnOptions.mostCommonMsec != document.mostCommonMsec()) {
+		columnOptions.mostCommonFrameTimes = document.mostCommonFrameTime();
+		columnOptions.mostCommonMsec = document.mostCommonMsec();
+		signalAllDataChanged();
+	}
+	emit logFramesAppended(oldRowCount);
+}
+
 bool LogTableModel::insertRows(int row, int count, const QModelIndex &parent)
 {
+	if (count <= 0)
+		return false;
 	beginInsertRows(parent, row, row + count - 1);
+	modelRowCount += count;
 	endInsertRows();
-	mostCommonFrameTimesOutdated = true;
-	if (_hideMostCommonFrameTimes)
-		findMostCommonFrameTimes();
 	return true;
 }
 
 bool LogTableModel::removeRows(int row, int count, const QModelIndex &parent)
 {
+	if (count <= 0)
+		return false;
 	beginRemoveRows(parent, row, row + count - 1);
+	modelRowCount -= count;
 	endRemoveRows();
-	mostCommonFrameTimesOutdated = true;
 	return true;
 }
 
 int LogTableModel::rowCount(const QModelIndex &) const
 {
-	if (logLoaded)
-		return commandToPhysicsIndex.size();
-	else
-		return 0;
+	return modelRowCount;
 }
 
 int LogTableModel::columnCount(const QModelIndex &) const
 {
-	return HorizontalHeaderCount;
+	return HorizontalHeaderCount + _computedColumns->count();
 }
 
-// Search for the row index corresponding to the lowest command frame within a physics frame.
-// Usually this takes only a few iterations, so it is almost constant time.
-int LogTableModel::searchBaseCommandRow(int phyIndex, int row) const
+int LogTableModel::computedColumnIndex(int column) const
 {
-	while (row >= 0) {
-		const int ind = commandToPhysicsIndex.at(row);
-		if (ind < phyIndex)
-			return row + 1;
-		--row;
-	}
-	return 0;
+	return column >= HorizontalHeaderCount ? column - HorizontalHeaderCount : -1;
 }
 
-void LogTableModel::signalAllDataChanged()
+bool LogTableModel::addComputedColumn(const QString &name, const QString &expression,
+	QString *errorMessage)
 {
-	const QModelIndex topLeft = createIndex(0, 0);
-	const QModelIndex bottomRight = createIndex(rowCount() - 1, columnCount() - 1);
-	emit dataChanged(topLeft, bottomRight);
+	// Compiled before the column is inserted, and handed over compiled.
+	ColumnExpression program;
+	if (!program.compile(expression, errorMessage))
+		return false;
+
+	const int column = columnCount();
+	beginInsertColumns(QModelIndex(), column, column);
+	_computedColumns->append(name, expression, program);
+	endInsertColumns();
+	return true;
 }
 
-void LogTableModel::setShowPlayerMove(bool pre)
+bool LogTableModel::setComputedColumnExpression(int index, const QString &expression,
+	QString *errorMessage)
 {
-	showPrePlayerMove = pre;
-	signalAllDataChanged();
+	if (!_computedColumns->setExpression(index, expression, errorMessage))
+		return false;
+
+	// The column keeps its previous values until the evaluation finishes and signals them.
+	emit headerDataChanged(Qt::Horizontal, HorizontalHeaderCount + index,
+		HorizontalHeaderCount + index);
+	return true;
 }
 
-void LogTableModel::setShowAnglemodUnit(bool enable)
+void LogTableModel::setComputedColumnName(int index, const QString &name)
 {
-	_showAnglemodUnit = enable;
-	signalAllDataChanged();
+	_computedColumns->setName(index, name);
+	emit headerDataChanged(Qt::Horizontal, HorizontalHeaderCount + index,
+		HorizontalHeaderCount + index);
 }
 
-void LogTableModel::setShowFSUValues(bool enable)
+void LogTableModel::removeComputedColumn(int index)
 {
-	_showFSUValues = enable;
-	signalAllDataChanged();
+	const int column = HorizontalHeaderCount + index;
+	beginRemoveColumns(QModelIndex(), column, column);
+	_computedColumns->remove(index);
+	endRemoveColumns();
 }
 
-void LogTableModel::setHideMostCommonFrameTimes(bool enable)
+void LogTableModel::computedColumnReady(int index)
 {
-	_hideMostCommonFrameTimes = enable;
-	if (enable && mostCommonFrameTimesOutdated)
-		findMostCommonFrameTimes();
-	signalAllDataChanged();
+	const int column = HorizontalHeaderCount + index;
+	emit computedColumnChanged(column);
+	if (rowCount() == 0)
+		return;
+	emit dataChanged(createIndex(0, column), createIndex(rowCount() - 1, column));
 }
 
-template<class T>
-static T findMostCommonElement(const std::unordered_map<T, size_t> &table)
+void LogTableModel::signalAllDataChanged()
 {
-	size_t occurrence = 0;
-	T element{};
-	for (const auto pair : table) {
-		if (pair.second > occurrence) {
-			occurrence = pair.second;
-			element = pair.first;
-		}
-	}
-	return element;
+	const QModelIndex topLeft = createIndex(0, 0);
+	const QModelIndex bottomRight = createIndex(rowCount() - 1, columnCount() - 1);
+	emit dataChanged(topLeft, bottomRight);
 }
 
-void LogTableModel::findMostCommonFrameTimes()
+void LogTableModel::startTextSearchIndex()
 {
-	std::unordered_map<float, size_t> ftTable;
-	for (const TASLogger::ReaderPhysicsFrame &phy : _tasLog.physicsFrameList)
-		++ftTable[phy.frameTime];
-	_mostCommonFrameTimes = findMostCommonElement(ftTable);
-	ftTable.clear();
-
-	std::unordered_map<uint8_t, size_t> msecTable;
-	for (const TASLogger::ReaderPhysicsFrame &phy : _tasLog.physicsFrameList)
-		for (const TASLogger::ReaderCommandFrame &cmd : phy.commandFrameList)
-			++msecTable[cmd.msec];
-	_mostCommonMsec = findMostCommonElement(msecTable);
-
-	mostCommonFrameTimesOutdated = false;
+	const QSharedPointer<QAtomicInt> canceled(new QAtomicInt(0));
+	textSearchCanceled = canceled;
+	const DocumentReader reader = document.startReading();
+	textSearchReader = reader;
+	const TASLogger::TASLog *tasLog = &document.tasLog();
+	textSearchWatcher.setFuture(QtConcurrent::run([tasLog, canceled, reader]() {
+		TextSearchIndex index;
+		if (!index.build(*tasLog, canceled.data()))
+			index.clear();
+		return index;
+	}));
 }
 
-void LogTableModel::getFrameData(int row,
-	TASLogger::ReaderPhysicsFrame &phyFrame,
-	TASLogger::ReaderCommandFrame **cmdFrame,
-	TASLogger::ReaderPlayerState **pmState) const
+void LogTableModel::stopTextSearchIndex()
 {
-	const int ind = commandToPhysicsIndex.at(row);
-	const int baseRow = searchBaseCommandRow(ind, row);
-	const int cmdInd = row - baseRow;
-
-	phyFrame = _tasLog.physicsFrameList.at(ind);
-	*cmdFrame = nullptr;
-	*pmState = nullptr;
-	if (!phyFrame.commandFrameList.empty()) {
-		*cmdFrame = &phyFrame.commandFrameList.at(cmdInd);
-		*pmState = &(showPrePlayerMove ? (*cmdFrame)->prePMState : (*cmdFrame)->postPMState);
-	}
+	if (textSearchCanceled)
+		textSearchCanceled->store(1);
+	textSearchCanceled.clear();
+	textSearchWatcher.waitForFinished();
+	textSearchReader.clear();
+	_textSearchIndex.clear();
+	_textSearchIndexReady = false;
 }
 
-QVariant LogTableModel::dataForeground(int row, int column) const
+void LogTableModel::textSearchIndexBuilt()
 {
-	TASLogger::ReaderPhysicsFrame phyFrame;
-	TASLogger::ReaderCommandFrame *cmdFrame;
-	TASLogger::ReaderPlayerState *pmState;
-	getFrameData(row, phyFrame, &cmdFrame, &pmState);
-
-	switch (column) {
-	case PhysicsFrameTimeHeader:
-		return QColor(phyFrame.consolePrintList.empty() ? Qt::darkGray : Qt::white);
-	case CommandFrameTimeHeader:
-		return QColor(Qt::darkGray);
-	case FramebulkIdHeader:
-		return QColor(Qt::darkGray);
-	case HorizontalSpeedHeader:
-	case VelocityAngleHeader:
-		if (phyFrame.objectMoveList.empty())
-			break;
-		return QColor(Qt::blue);
-	case VerticalSpeedHeader:
-		if (!cmdFrame || pmState->velocity[2] == 0.0)
-			break;
-		return QColor(pmState->velocity[2] > 0.0 ? Qt::blue : Qt::red);
-	case ForwardMoveHeader:
-		if (!cmdFrame || cmdFrame->FSU[0] == 0.0)
-			break;
-		return QColor(Qt::white);
-	case SideMoveHeader:
-		if (!cmdFrame || cmdFrame->FSU[1] == 0.0)
-			break;
-		return QColor(Qt::white);
-	case UpMoveHeader:
-		if (!cmdFrame || cmdFrame->FSU[2] == 0.0)
-			break;
-		return QColor(Qt::white);
-	case HealthHeader:
-		if (phyFrame.damageList.empty())
-			break;
-		return QColor(Qt::white);
-	case ArmorHeader:
-		if (phyFrame.damageList.empty())
-			break;
-		return QColor(Qt::white);
-	case SharedSeedHeader:
-		return QColor(Qt::darkGray);
-	case NonSharedRNGParameterHeader:
-		return QColor(Qt::darkGray);
-	case ClientStateHeader:
-		if (phyFrame.paused)
-			return QColor(Qt::white);
-		else
-			return QColor(phyFrame.clientState == 5 ? Qt::darkGray : Qt::red);
-	case FrameTimeRemainderHeader:
-		if (!cmdFrame)
-			break;
-		return QColor(Qt::darkGray);
-	}
-
-	return QVariant();
+	// The index of a canceled build belongs to an outdated log.
+	if (!textSearchCanceled || textSearchCanceled->load())
+		return;
+	textSearchCanceled.clear();
+	textSearchReader.clear();
+
+	_textSearchIndex = textSearchWatcher.result();
+	_textSearchIndexReady = true;
+	emit textSearchIndexReady();
 }
 
-QVariant LogTableModel::dataBackground(int row, int column) const
+void LogTableModel::setShowPlayerMove(bool pre)
 {
-	static const QColor CollisionColor(255, 233, 186);
-	static const QColor CmdAbsentColor(240, 240, 240);
-
-	TASLogger::ReaderPhysicsFrame phyFrame;
-	TASLogger::ReaderCommandFrame *cmdFrame;
-	TASLogger::ReaderPlayerState *pmState;
-	getFrameData(row, phyFrame, &cmdFrame, &pmState);
-
-	switch (column) {
-	case PhysicsFrameTimeHeader:
-		if (phyFrame.consolePrintList.empty())
-			break;
-		return QColor(Qt::darkGray);
-	case CommandFrameTimeHeader:
-		if (!cmdFrame)
-			return CmdAbsentColor;
-		break;
-	case FramebulkIdHeader:
-		if (!cmdFrame)
-			return CmdAbsentColor;
-		break;
-	case HorizontalSpeedHeader:
-	case VelocityAngleHeader: {
-		if (!cmdFrame)
-			return CmdAbsentColor;
-		if (cmdFrame->collisionList.empty())
-			break;
-		bool horizontalCollision = false;
-		for (const TASLogger::ReaderCollision &col : cmdFrame->collisionList) {
-			if (col.normal[0] != 0.0 || col.normal[1] != 0.0) {
-				horizontalCollision = true;
-				break;
-			}
-		}
-		if (!horizontalCollision)
-			break;
-		return CollisionColor;
-	}
-	case VerticalSpeedHeader: {
-		if (!cmdFrame)
-			return CmdAbsentColor;
-		if (cmdFrame->collisionList.empty())
-			break;
-		bool verticalCollision = false;
-		for (const TASLogger::ReaderCollision &col : cmdFrame->collisionList) {
-			if (col.normal[2] != 0.0) {
-				verticalCollision = true;
-				break;
-			}
-		}
-		if (!verticalCollision)
-			break;
-		return CollisionColor;
-	}
-	case OnGroundHeader:
-		if (!cmdFrame)
-			return CmdAbsentColor;
-		if (!pmState->onGround)
-			break;
-		return QColor(Qt::green);
-	case DuckStateHeader:
-		if (!cmdFrame)
-			return CmdAbsentColor;
-		if (pmState->duckState == TASLogger::UNDUCKED)
-			break;
-		return QColor(pmState->duckState == TASLogger::INDUCK ? Qt::gray : Qt::black);
-	case JumpHeader:
-		if (!cmdFrame)
-			return CmdAbsentColor;
-		if (!(cmdFrame->buttons & IN_JUMP))
-			break;
-		return QColor(Qt::cyan);
-	case DuckHeader:
-		if (!cmdFrame)
-			return CmdAbsentColor;
-		if (!(cmdFrame->buttons & IN_DUCK))
-			break;
-		return QColor(Qt::magenta);
-	case ForwardMoveHeader:
-		if (!cmdFrame)
-			return CmdAbsentColor;
-		if (cmdFrame->FSU[0] == 0.0)
-			break;
-		return QColor(cmdFrame->FSU[0] > 0 ? Qt::blue : Qt::red);
-	case SideMoveHeader:
-		if (!cmdFrame)
-			return CmdAbsentColor;
-		if (cmdFrame->FSU[1] == 0.0)
-			break;
-		return QColor(cmdFrame->FSU[1] > 0 ? Qt::blue : Qt::red);
-	case UpMoveHeader:
-		if (!cmdFrame)
-			return CmdAbsentColor;
-		if (cmdFrame->FSU[2] == 0.0)
-			break;
-		return QColor(cmdFrame->FSU[2] > 0 ? Qt::blue : Qt::red);
-	case YawHeader:
-		if (!cmdFrame)
-			return CmdAbsentColor;
-		if (cmdFrame->punchangles[0] == 0.0)
-			break;
-		return QColor(Qt::yellow);
-	case PitchHeader:
-		if (!cmdFrame)
-			return CmdAbsentColor;
-		if (cmdFrame->punchangles[1] == 0.0)
-			break;
-		return QColor(Qt::yellow);
-	case HealthHeader:
-		if (!cmdFrame)
-			return CmdAbsentColor;
-		if (phyFrame.damageList.empty())
-			break;
-		return QColor(Qt::red);
-	case ArmorHeader:
-		if (!cmdFrame)
-			return CmdAbsentColor;
-		if (phyFrame.damageList.empty())
-			break;
-		return QColor(Qt::red);
-	case UseHeader:
-		if (!cmdFrame)
-			return CmdAbsentColor;
-		if (!(cmdFrame->buttons & IN_USE))
-			break;
-		return QColor(Qt::darkYellow);
-	case AttackHeader:
-		if (!cmdFrame)
-			return CmdAbsentColor;
-		if (!(cmdFrame->buttons & IN_ATTACK))
-			break;
-		return QColor(Qt::darkYellow);
-	case Attack2Header:
-		if (!cmdFrame)
-			return CmdAbsentColor;
-		if (!(cmdFrame->buttons & IN_ATTACK2))
-			break;
-		return QColor(Qt::darkYellow);
-	case ReloadHeader:
-		if (!cmdFrame)
-			return CmdAbsentColor;
-		if (!(cmdFrame->buttons & IN_RELOAD))
-			break;
-		return QColor(Qt::darkYellow);
-	case OnLadderHeader:
-		if (!cmdFrame)
-			return CmdAbsentColor;
-		if (!pmState->onLadder)
-			break;
-		return QColor(125, 58, 19);
-	case ClientStateHeader:
-		if (!phyFrame.paused)
-			break;
-		return QColor(Qt::darkCyan);
-	case WaterLevelHeader:
-		if (!cmdFrame)
-			return CmdAbsentColor;
-		if (!pmState->waterLevel)
-			break;
-		return QColor(pmState->waterLevel == 1 ? Qt::blue : Qt::darkBlue);
-	case EntityFrictionHeader:
-		if (!cmdFrame)
-			return CmdAbsentColor;
-		if (cmdFrame->entFriction == 1.0)
-			break;
-		return QColor(Qt::gray);
-	case EntityGravityHeader:
-		if (!cmdFrame)
-			return CmdAbsentColor;
-		if (cmdFrame->entGravity == 1.0)
-			break;
-		return QColor(Qt::gray);
-	case FrameTimeRemainderHeader:
-	case SharedSeedHeader:
-	case NonSharedRNGParameterHeader:
-	case PositionZHeader:
-	case PositionXHeader:
-	case PositionYHeader:
-		if (!cmdFrame)
-			return CmdAbsentColor;
-		break;
-	}
-
-	return QVariant();
+	if (logLoaded) {
+		_computedColumns->stop();
+		emit logColumnsAboutToChange();
+		document.setPrePlayerMove(pre);
+		_computedColumns->refresh();
+		emit logColumnsChanged();
+	} else
+		document.setPrePlayerMove(pre);
+	signalAllDataChanged();
 }
 
-QVariant LogTableModel::dataDisplay(int row, int column) const
+void LogTableModel::setShowAnglemodUnit(bool enable)
 {
-	TASLogger::ReaderPhysicsFrame phyFrame;
-	TASLogger::ReaderCommandFrame *cmdFrame;
-	TASLogger::ReaderPlayerState *pmState;
-	getFrameData(row, phyFrame, &cmdFrame, &pmState);
-
-	switch (column) {
-	case PhysicsFrameTimeHeader:
-		if (_hideMostCommonFrameTimes && phyFrame.frameTime == _mostCommonFrameTimes)
-			break;
-		return phyFrame.frameTime;
-	case CommandFrameTimeHeader:
-		if (!cmdFrame || (_hideMostCommonFrameTimes && cmdFrame->msec == _mostCommonMsec))
-			break;
-		return cmdFrame->msec;
-	case FramebulkIdHeader:
-		if (!cmdFrame)
-			break;
-		return cmdFrame->framebulkId;
-	case HorizontalSpeedHeader: {
-		if (!cmdFrame)
-			break;
-		const bool hbasevelExist = pmState->baseVelocity[0] != 0.0
-			|| pmState->baseVelocity[1] != 0.0;
-		if (pmState->velocity[0] == 0.0 && pmState->velocity[1] == 0.0
-			&& !hbasevelExist
-			&& phyFrame.objectMoveList.empty())
-			return QVariant();
-		const float hspeed = std::hypot(pmState->velocity[0], pmState->velocity[1]);
-		if (hbasevelExist)
-			return BaseVelFormat.arg(hspeed);
-		else
-			return hspeed;
-	}
-	case VelocityAngleHeader:
-		if (!cmdFrame || (pmState->velocity[0] == 0.0 && pmState->velocity[1] == 0.0))
-			break;
-		return std::atan2(pmState->velocity[1], pmState->velocity[0]) * 180 / M_PI;
-	case VerticalSpeedHeader:
-		if (!cmdFrame || (pmState->velocity[2] == 0.0 && pmState->baseVelocity[2] == 0.0))
-			break;
-		if (pmState->baseVelocity[2] != 0.0)
-			return BaseVelFormat.arg(pmState->velocity[2]);
-		else
-			return pmState->velocity[2];
-	case ForwardMoveHeader:
-		if (!cmdFrame || cmdFrame->FSU[0] == 0.0)
-			break;
-		if (_showFSUValues)
-			return cmdFrame->FSU[0];
-		else
-			return cmdFrame->FSU[0] > 0 ? QStringLiteral("F") : QStringLiteral("B");
-	case SideMoveHeader:
-		if (!cmdFrame || cmdFrame->FSU[1] == 0.0)
-			break;
-		if (_showFSUValues)
-			return cmdFrame->FSU[1];
-		else
-			return cmdFrame->FSU[1] > 0 ? QStringLiteral("R") : QStringLiteral("L");
-	case UpMoveHeader:
-		if (!cmdFrame || cmdFrame->FSU[2] == 0.0)
-			break;
-		if (_showFSUValues)
-			return cmdFrame->FSU[2];
-		else
-			return cmdFrame->FSU[2] > 0 ? QStringLiteral("U") : QStringLiteral("D");
-	case YawHeader:
-		if (!cmdFrame)
-			break;
-		if (_showAnglemodUnit)
-			return QString("%1u").arg(cmdFrame->viewangles[0] / M_U);
-		else
-			return cmdFrame->viewangles[0];
-	case PitchHeader:
-		if (!cmdFrame)
-			break;
-		if (_showAnglemodUnit)
-			return QString("%1u").arg(cmdFrame->viewangles[1] / M_U);
-		else
-			return cmdFrame->viewangles[1];
-	case HealthHeader:
-		if (!cmdFrame)
-			break;
-		return cmdFrame->health;
-	case ArmorHeader:
-		if (!cmdFrame)
-			break;
-		return cmdFrame->armor;
-	case ClientStateHeader:
-		return phyFrame.clientState;
-	case FrameTimeRemainderHeader:
-		if (!cmdFrame)
-			break;
-		return QString::number(cmdFrame->frameTimeRemainder, 'e', 3);
-	case SharedSeedHeader:
-		if (!cmdFrame)
-			break;
-		return cmdFrame->sharedSeed;
-	case NonSharedRNGParameterHeader:
-		return phyFrame.rng.idum;
-	case PositionZHeader:
-		if (!cmdFrame)
-			break;
-		return pmState->position[2];
-	case PositionXHeader:
-		if (!cmdFrame)
-			break;
-		return pmState->position[0];
-	case PositionYHeader:
-		if (!cmdFrame)
-			break;
-		return pmState->position[1];
-	}
-
-	return QVariant();
+	columnOptions.showAnglemodUnit = enable;
+	signalAllDataChanged();
 }
 
-QVariant LogTableModel::dataFont(int row, int column) const
+void LogTableModel::setShowFSUValues(bool enable)
 {
-	static const QFont boldFont = QFont(QString(), -1, QFont::Bold);
-
-	TASLogger::ReaderPhysicsFrame phyFrame;
-	TASLogger::ReaderCommandFrame *cmdFrame;
-	TASLogger::ReaderPlayerState *pmState;
-	getFrameData(row, phyFrame, &cmdFrame, &pmState);
-
-	switch (column) {
-	case HorizontalSpeedHeader:
-	case VelocityAngleHeader:
-		if (phyFrame.objectMoveList.empty())
-			break;
-		return boldFont;
-	case HealthHeader:
-		if (phyFrame.damageList.empty())
-			break;
-		return boldFont;
-	case ArmorHeader:
-		if (phyFrame.damageList.empty())
-			break;
-		return boldFont;
-	case ClientStateHeader:
-		if (phyFrame.clientState == 5)
-			break;
-		return boldFont;
-	}
-
-	return QVariant();
+	columnOptions.showFSUValues = enable;
+	signalAllDataChanged();
 }
 
-QVariant LogTableModel::dataAlignment(int, int column) const
+void LogTableModel::setHideMostCommonFrameTimes(bool enable)
 {
-	switch (column) {
-	case ForwardMoveHeader:
-	case SideMoveHeader:
-	case UpMoveHeader:
-		return Qt::AlignCenter;
-	}
-
-	return QVariant();
+	columnOptions.hideMostCommonFrameTimes = enable;
+	signalAllDataChanged();
 }
 
 QVariant LogTableModel::data(const QModelIndex &index, int role) const
 {
+	const int computedIndex = computedColumnIndex(index.column());
+	if (computedIndex != -1) {
+		if (role != Qt::DisplayRole)
+			return QVariant();
+		const float value = _computedColumns->value(computedIndex, index.row());
+		if (std::isnan(value))
+			return QVariant();
+		return value;
+	}
+
+	const ColumnDescriptor &column = ColumnDescriptorList[index.column()];
+	CellAccessor accessor;
 	switch (role) {
 	case Qt::DisplayRole:
-		return dataDisplay(index.row(), index.column());
+		accessor = column.display;
+		break;
 	case Qt::BackgroundRole:
-		return dataBackground(index.row(), index.column());
+		accessor = column.background;
+		break;
 	case Qt::ForegroundRole:
-		return dataForeground(index.row(), index.column());
+		accessor = column.foreground;
+		break;
 	case Qt::FontRole:
-		return dataFont(index.row(), index.column());
+		accessor = column.font;
+		break;
 	case Qt::TextAlignmentRole:
-		return dataAlignment(index.row(), index.column());
+		accessor = column.alignment;
+		break;
+	default:
+		return QVariant();
 	}
 
-	return QVariant();
+	// Most columns have no rule for some of the roles, which skips the row lookup.
+	if (!accessor)
+		return QVariant();
+	return accessor(frameAt(index.row()), columnOptions);
+}
+
+void LogTableModel::setHighlightedRows(const QVector<int> &rows)
+{
+	_highlightedRows = rows;
+	if (rowCount() > 0)
+		emit headerDataChanged(Qt::Vertical, 0, rowCount() - 1);
 }
 
 QVariant LogTableModel::headerData(int section, Qt::Orientation orientation, int role) const
 {
+	const int computedIndex = orientation == Qt::Horizontal ? computedColumnIndex(section) : -1;
+	if (computedIndex != -1) {
+		if (role == Qt::DisplayRole)
+			return _computedColumns->name(computedIndex);
+		else if (role == Qt::ToolTipRole)
+			return _computedColumns->expression(computedIndex);
+		return QAbstractTableModel::headerData(section, orientation, role);
+	}
+
 	if (role == Qt::DisplayRole) {
 		if (orientation == Qt::Horizontal)
-			return HorizontalHeaderList[section][0];
+			return QString(ColumnDescriptorList[section].name);
 	} else if (role == Qt::TextAlignmentRole) {
 		if (orientation == Qt::Vertical)
 			return Qt::AlignRight;
+	} else if (role == Qt::BackgroundRole) {
+		if (orientation == Qt::Vertical
+			&& std::binary_search(_highlightedRows.cbegin(), _highlightedRows.cend(), section))
+			return HighlightColor;
 	} else if (role == Qt::ToolTipRole) {
 		if (orientation == Qt::Horizontal)
-			return HorizontalHeaderList[section][1];
+			return QString(ColumnDescriptorList[section].description);
 	}
 
 	return QAbstractTableModel::headerData(section, orientation, role);
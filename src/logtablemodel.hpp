@@ -1,100 +1,11 @@
 #pragma once
 
 #include <QtWidgets>
-#include "taslogger/reader.hpp"
-
-enum LogFileError
-{
-	LFErrorNone,
-	LFErrorCannotOpen,
-	LFErrorInvalidLogFile
-};
-
-const int IN_ATTACK = 1 << 0;
-const int IN_JUMP = 1 << 1;
-const int IN_DUCK = 1 << 2;
-const int IN_FORWARD = 1 << 3;
-const int IN_BACK = 1 << 4;
-const int IN_USE = 1 << 5;
-const int IN_LEFT = 1 << 7;
-const int IN_RIGHT = 1 << 8;
-const int IN_MOVELEFT = 1 << 9;
-const int IN_MOVERIGHT = 1 << 10;
-const int IN_ATTACK2 = 1 << 11;
-const int IN_RELOAD = 1 << 13;
-
-enum HorizontalHeaderIndex {
-	PhysicsFrameTimeHeader = 0,
-	CommandFrameTimeHeader,
-	FramebulkIdHeader,
-	HorizontalSpeedHeader,
-	VelocityAngleHeader,
-	VerticalSpeedHeader,
-	OnGroundHeader,
-	DuckStateHeader,
-	JumpHeader,
-	DuckHeader,
-	ForwardMoveHeader,
-	SideMoveHeader,
-	UpMoveHeader,
-	YawHeader,
-	PitchHeader,
-	HealthHeader,
-	ArmorHeader,
-	UseHeader,
-	AttackHeader,
-	Attack2Header,
-	ReloadHeader,
-	OnLadderHeader,
-	WaterLevelHeader,
-	ClientStateHeader,
-	FrameTimeRemainderHeader,
-	EntityFrictionHeader,
-	EntityGravityHeader,
-	SharedSeedHeader,
-	NonSharedRNGParameterHeader,
-	PositionZHeader,
-	PositionXHeader,
-	PositionYHeader,
-};
-
-static const QString HorizontalHeaderList[][2] = {
-	{"ft", "Physics frametime"},
-	{"ms", "Command frametime"},
-	{"bid", "Framebulk ID"},
-	{"hspd", "Horizontal speed"},
-	{"vyaw", "Velocity yaw"},
-	{"vspd", "Vertical speed"},
-	{"g", "Is on ground?"},
-	{"k", "Duck state"},
-	{"j", "Jump key"},
-	{"d", "Duck key"},
-	{"f", "Forward move"},
-	{"s", "Side move"},
-	{"u", "Up move"},
-	{"y", "Yaw"},
-	{"p", "Pitch"},
-	{"hp", "Health"},
-	{"ap", "Armor"},
-	{"e", "Use key"},
-	{"1", "Primary attack key"},
-	{"2", "Second attack key"},
-	{"r", "Reload key"},
-	{"l", "Is on ladder?"},
-	{"w", "Water level"},
-	{"c", "Client state"},
-	{"rem", "Frametime remainder"},
-	{"ef", "Entity friction"},
-	{"eg", "Entity gravity"},
-	{"ss", "Shared seed"},
-	{"idum", "Non-shared RNG parameter"},
-	{"posz", "z position"},
-	{"posx", "x position"},
-	{"posy", "y position"},
-};
-
-static const int HorizontalHeaderCount =
-	sizeof(HorizontalHeaderList) / sizeof(HorizontalHeaderList[0]);
+#include <QtConcurrent>
+#include "logdocument.hpp"
+#include "columndescriptor.hpp"
+#include "computedcolumns.hpp"
+#include "textsearchindex.hpp"
 
 class LogTableModel : public QAbstractTableModel
 {
@@ -102,21 +13,29 @@ class LogTableModel : public QAbstractTableModel
 
 public:
 	LogTableModel(QObject *parent = nullptr);
+	~LogTableModel();
 
-	inline const TASLogger::TASLog &getTASLog() const { return _tasLog; }
+	inline const TASLogger::TASLog &getTASLog() const { return document.tasLog(); }
 	inline QString logFileName() const { return _logFileName; }
-	inline QString toolVersion() const { return QString::fromStdString(_tasLog.toolVersion); }
-	inline int buildNumber() const { return _tasLog.buildNumber; }
-	inline QString gameMod() const { return QString::fromStdString(_tasLog.gameMod); }
+	inline QString toolVersion() const
+	{
+		return QString::fromStdString(document.tasLog().toolVersion);
+	}
+	inline int buildNumber() const { return document.tasLog().buildNumber; }
+	inline QString gameMod() const { return QString::fromStdString(document.tasLog().gameMod); }
 
 	LogFileError openLogFile(const QString &fileName);
+
+	// Appends the frames the game writes to the log file as they are completed, and loads
+	// logs that are still incomplete.
+	void setFollowing(bool enable);
+	inline bool isFollowing() const { return following; }
 	bool insertRows(int row, int count, const QModelIndex &parent = QModelIndex()) override;
 	bool removeRows(int row, int count, const QModelIndex &parent = QModelIndex()) override;
 
-	void getFrameData(int row,
-		TASLogger::ReaderPhysicsFrame &phyFrame,
-		TASLogger::ReaderCommandFrame **cmdFrame,
-		TASLogger::ReaderPlayerState **pmState) const;
+	// Returns the frames of the row without copying them.
+	inline FrameRef frameAt(int row) const { return document.frameAt(row); }
+	inline double duration(int first, int last) const { return document.duration(first, last); }
 
 	int rowCount(const QModelIndex &parent = QModelIndex()) const override;
 	int columnCount(const QModelIndex &parent = QModelIndex()) const override;
@@ -127,44 +46,95 @@ public:
 	void setShowPlayerMove(bool pre);
 
 	void setShowAnglemodUnit(bool enable);
-	inline bool showAnglemodUnit() const { return _showAnglemodUnit; }
+	inline bool showAnglemodUnit() const { return columnOptions.showAnglemodUnit; }
 
 	void setShowFSUValues(bool enable);
-	inline bool showFSUValues() const { return _showFSUValues; }
+	inline bool showFSUValues() const { return columnOptions.showFSUValues; }
 
 	void setHideMostCommonFrameTimes(bool enable);
-	inline bool hideMostCommonFrameTimes() const { return _hideMostCommonFrameTimes; }
-	inline float mostCommonFrameTimes() const { return _mostCommonFrameTimes; }
-	inline float mostCommonMsec() const { return _mostCommonMsec; }
-
-	inline const TASLogger::TASLog &tasLog() const { return _tasLog; }
+	inline bool hideMostCommonFrameTimes() const
+	{
+		return columnOptions.hideMostCommonFrameTimes;
+	}
+	inline float mostCommonFrameTimes() const { return columnOptions.mostCommonFrameTimes; }
+	inline int mostCommonMsec() const { return columnOptions.mostCommonMsec; }
+
+	inline const LogDocument &logDocument() const { return document; }
+	inline const TASLogger::TASLog &tasLog() const { return document.tasLog(); }
+	inline const RowPrefixSums &rowPrefixSums() const { return document.rowPrefixSums(); }
+	inline const FramebulkIndex &framebulkIndex() const { return document.framebulkIndex(); }
+	inline const LogColumns &logColumns() const { return document.logColumns(); }
+	inline const RangeStatistics &rangeStatistics() const
+	{
+		return document.rangeStatistics();
+	}
+	inline const SpatialIndex &spatialIndex() const { return document.spatialIndex(); }
+	inline const GameTimeIndex &gameTimeIndex() const { return document.gameTimeIndex(); }
+	inline const EventIndex &eventIndex() const { return document.eventIndex(); }
+	inline const EntityIndex &entityIndex() const { return document.entityIndex(); }
+	inline const EventDensityPyramid &eventDensityPyramid() const
+	{
+		return document.eventDensityPyramid();
+	}
+	// Marks the rows, which must be sorted, in the vertical header.
+	void setHighlightedRows(const QVector<int> &rows);
+	inline const QVector<int> &highlightedRows() const { return _highlightedRows; }
+
+	// Built in the background after loading, empty until textSearchIndexReady is emitted.
+	inline const TextSearchIndex &textSearchIndex() const { return _textSearchIndex; }
+	inline bool isTextSearchIndexReady() const { return _textSearchIndexReady; }
+	inline int physicsFrameIndex(int row) const { return document.physicsFrameIndex(row); }
+
+	// Computed columns follow the fixed columns of HorizontalHeaderIndex.
+	inline const ComputedColumns &computedColumns() const { return *_computedColumns; }
+	int computedColumnIndex(int column) const;
+	bool addComputedColumn(const QString &name, const QString &expression,
+		QString *errorMessage);
+	bool setComputedColumnExpression(int index, const QString &expression,
+		QString *errorMessage);
+	void setComputedColumnName(int index, const QString &name);
+	void removeComputedColumn(int index);
 
 signals:
 	void logFileLoaded(bool loaded);
+	// Rows were appended to the log in follow mode, from firstRow on. The columns and indexes
+	// were extended with them, unlike when logColumnsChanged is emitted.
+	void logFramesAppended(int firstRow);
+	void logColumnsAboutToChange();
+	void logColumnsChanged();
+	// The values of the computed column changed, or it started being computed again.
+	void computedColumnChanged(int column);
+	void textSearchIndexReady();
+
+private slots:
+	void computedColumnReady(int index);
+	void textSearchIndexBuilt();
+	void logFileChanged();
+	void appendLogFrames();
 
 private:
-	TASLogger::TASLog _tasLog;
-	QVector<int> commandToPhysicsIndex;
+	LogDocument document;
+	ComputedColumns *_computedColumns;
+	TextSearchIndex _textSearchIndex;
+	QFutureWatcher<TextSearchIndex> textSearchWatcher;
+	QSharedPointer<QAtomicInt> textSearchCanceled;
+	DocumentReader textSearchReader;
+	bool _textSearchIndexReady = false;
 	bool logLoaded = false;
-	bool showPrePlayerMove = false;
-	bool _showAnglemodUnit = false;
-	bool _showFSUValues = false;
-	bool _hideMostCommonFrameTimes = false;
-
-	bool mostCommonFrameTimesOutdated = true;
-	float _mostCommonFrameTimes;
-	int _mostCommonMsec;
-	QString _logFileName;
+	// Rows the views know of, which lags behind the document while rows are inserted.
+	int modelRowCount = 0;
+	ColumnOptions columnOptions;
+	QVector<int> _highlightedRows;
 
-	void signalAllDataChanged();
+	QString _logFileName;
 
-	int searchBaseCommandRow(int phyIndex, int row) const;
-	void findMostCommonFrameTimes();
+	bool following = false;
+	QFileSystemWatcher fileWatcher;
+	QTimer followTimer;
+	qint64 followedFileSize = -1;
 
-	void populateCommandToPhysicsIndex();
-	QVariant dataForeground(int row, int column) const;
-	QVariant dataBackground(int row, int column) const;
-	QVariant dataDisplay(int row, int column) const;
-	QVariant dataFont(int row, int column) const;
-	QVariant dataAlignment(int row, int column) const;
+	LogFileError loadDocument();
+	void signalAllDataChanged();
+	void startTextSearchIndex();
+	void stopTextSearchIndex();
 };
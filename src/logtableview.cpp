@@ -10,3 +10,10 @@ void LogTableView::currentChanged(const QModelIndex &current, const QModelIndex
 	emit currentChanged_(current, previous);
 	QTableView::currentChanged(current, previous);
 }
+
+void LogTableView::selectionChanged(const QItemSelection &selected,
+	const QItemSelection &deselected)
+{
+	QTableView::selectionChanged(selected, deselected);
+	emit selectionChanged_();
+}
@@ -11,7 +11,10 @@ public:
 
 signals:
 	void currentChanged_(const QModelIndex &current, const QModelIndex &previous);
+	void selectionChanged_();
 
 protected:
 	void currentChanged(const QModelIndex &current, const QModelIndex &previous) override;
+	void selectionChanged(const QItemSelection &selected,
+		const QItemSelection &deselected) override;
 };
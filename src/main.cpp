@@ -1,8 +1,16 @@
 #include <QApplication>
 #include "mainwindow.hpp"
+#include "batchmode.hpp"
 
 int main(int argc, char **argv)
 {
+	if (isBatchMode(argc, argv)) {
+		QCoreApplication app(argc, argv);
+		app.setOrganizationName("HLTAS");
+		app.setApplicationName("qconread2");
+		return runBatchMode(app.arguments());
+	}
+
 	QApplication app(argc, argv);
 	app.setOrganizationName("HLTAS");
 	app.setApplicationName("qconread2");
@@ -1,5 +1,10 @@
+#include <algorithm>
+#include <cmath>
 #include "mainwindow.hpp"
 
+// Ctrl jumps to the next event of the type, Ctrl+Shift to the previous one.
+static const char EventShortcutKeyList[] = {'D', 'K', 'M', 'P', 'U', 'E'};
+
 MainWindow::MainWindow()
 	: QMainWindow()
 {
@@ -8,6 +13,14 @@ MainWindow::MainWindow()
 	setupUi();
 }
 
+MainWindow::~MainWindow()
+{
+	// The filter and sort workers read the model, which may be destroyed before them.
+	filterBar->stopFilter();
+	rowSorter->stopSort();
+	stopExport();
+}
+
 void MainWindow::setupMenuBar()
 {
 	QMenu *fileMenu = menuBar()->addMenu("&File");
@@ -27,6 +40,15 @@ void MainWindow::setupMenuBar()
 	reloadAct = fileMenu->addAction("&Reload", this, SLOT(reloadLogFile()), QKeySequence::Refresh);
 	reloadAct->setEnabled(false);
 
+	followAct = fileMenu->addAction("&Follow Log File", this, SLOT(followLogFile()));
+	followAct->setCheckable(true);
+	followAct->setStatusTip("Append the frames the game writes to the log file, "
+		"and open logs still being written");
+
+	scrollToNewFramesAct = fileMenu->addAction("Scroll to New Frames");
+	scrollToNewFramesAct->setCheckable(true);
+	scrollToNewFramesAct->setChecked(true);
+
 	closeAct = fileMenu->addAction("&Close", this, SLOT(close()), QKeySequence::Close);
 
 	fileMenu->addSeparator();
@@ -34,6 +56,13 @@ void MainWindow::setupMenuBar()
 	logFileInfoAct = fileMenu->addAction("Log File &Info...", this, SLOT(showLogFileInfo()));
 	logFileInfoAct->setEnabled(false);
 
+	exportAct = fileMenu->addAction("&Export...", this, SLOT(exportRows()));
+	exportAct->setEnabled(false);
+
+	saveSelectionAsLogAct = fileMenu->addAction("Save &Selection as Log...",
+		this, SLOT(saveSelectionAsLog()));
+	saveSelectionAsLogAct->setEnabled(false);
+
 	fileMenu->addSeparator();
 
 	quitAct = fileMenu->addAction("Close &All Files", qApp, SLOT(quit()), QKeySequence::Quit);
@@ -58,6 +87,30 @@ void MainWindow::setupMenuBar()
 	hideMostCommonFrameTimesAct->setCheckable(true);
 	hideMostCommonFrameTimesAct->setEnabled(false);
 
+	showElapsedTimeAct = viewMenu->addAction("Show &Elapsed Time",
+		this, SLOT(showElapsedTime()));
+	showElapsedTimeAct->setCheckable(true);
+
+	showEventMinimapAct = viewMenu->addAction("Show Event &Minimap",
+		this, SLOT(showEventMinimap()));
+	showEventMinimapAct->setCheckable(true);
+	showEventMinimapAct->setChecked(true);
+
+	showFilterBarAct = viewMenu->addAction("&Filter Rows",
+		this, SLOT(showFilterBar()), QKeySequence::Find);
+	showFilterBarAct->setCheckable(true);
+
+	clearSortAct = viewMenu->addAction("Clear &Sort", this, SLOT(clearSort()));
+
+	viewMenu->addSeparator();
+
+	addComputedColumnAct = viewMenu->addAction("&Add Computed Column...",
+		this, SLOT(addComputedColumn()));
+	editComputedColumnAct = viewMenu->addAction("E&dit Computed Column...",
+		this, SLOT(editComputedColumn()));
+	removeComputedColumnAct = viewMenu->addAction("Remove Computed Col&umn",
+		this, SLOT(removeComputedColumn()));
+
 	viewMenu->addSeparator();
 
 	prePlayerMoveAct = viewMenu->addAction("Show P&re-PM State",
@@ -80,6 +133,54 @@ void MainWindow::setupMenuBar()
 		this, SLOT(jumpToEndOfLog()), QKeySequence::MoveToEndOfDocument);
 	jumpToEndOfLogAct->setEnabled(false);
 
+	navigateMenu->addSeparator();
+
+	goToTimeAct = navigateMenu->addAction("Go to &Time...",
+		this, SLOT(goToTime()), QKeySequence("Ctrl+T"));
+	goToTimeAct->setEnabled(false);
+	goToPhysicsFrameAct = navigateMenu->addAction("Go to &Physics Frame...",
+		this, SLOT(goToPhysicsFrame()), QKeySequence("Ctrl+Shift+L"));
+	goToPhysicsFrameAct->setEnabled(false);
+	goToCommandFrameAct = navigateMenu->addAction("Go to &Command Frame...",
+		this, SLOT(goToCommandFrame()), QKeySequence("Ctrl+L"));
+	goToCommandFrameAct->setEnabled(false);
+	goToPositionAct = navigateMenu->addAction("Go to P&osition...",
+		this, SLOT(goToPosition()), QKeySequence("Ctrl+Shift+O"));
+	goToPositionAct->setEnabled(false);
+	highlightNearbyFramesAct = navigateMenu->addAction("&Highlight Frames Near Here...",
+		this, SLOT(highlightNearbyFrames()));
+	highlightNearbyFramesAct->setEnabled(false);
+	clearHighlightAct = navigateMenu->addAction("Clear Highlight",
+		this, SLOT(clearHighlight()));
+
+	navigateMenu->addSeparator();
+
+	for (int i = 0; i < EventTypeCount; i++) {
+		const QChar key = EventShortcutKeyList[i];
+		nextEventActionList[i] = navigateMenu->addAction(
+			QString("Next %1").arg(EventTypeNameList[i]),
+			this, SLOT(goToNextEvent()), QKeySequence(QString("Ctrl+%1").arg(key)));
+		nextEventActionList[i]->setData(i);
+		nextEventActionList[i]->setEnabled(false);
+		previousEventActionList[i] = navigateMenu->addAction(
+			QString("Previous %1").arg(EventTypeNameList[i]),
+			this, SLOT(goToPreviousEvent()),
+			QKeySequence(QString("Ctrl+Shift+%1").arg(key)));
+		previousEventActionList[i]->setData(i);
+		previousEventActionList[i]->setEnabled(false);
+	}
+
+	navigateMenu->addSeparator();
+
+	nextSearchMatchAct = navigateMenu->addAction("Next Search Match",
+		this, SLOT(goToNextSearchMatch()), QKeySequence("F3"));
+	previousSearchMatchAct = navigateMenu->addAction("Previous Search Match",
+		this, SLOT(goToPreviousSearchMatch()), QKeySequence("Shift+F3"));
+	nextContactAct = navigateMenu->addAction("Next Entity Contact",
+		this, SLOT(goToNextContact()), QKeySequence("Ctrl+]"));
+	previousContactAct = navigateMenu->addAction("Previous Entity Contact",
+		this, SLOT(goToPreviousContact()), QKeySequence("Ctrl+["));
+
 	QMenu *toolsMenu = menuBar()->addMenu("&Tools");
 	showInspectorAct = toolsMenu->addAction("Frame &Inspector",
 		this, SLOT(showInspector()), QKeySequence("F"));
@@ -88,6 +189,26 @@ void MainWindow::setupMenuBar()
 	showPlayerPlotAct = toolsMenu->addAction("&Player Plot",
 		this, SLOT(showPlayerPlot()), QKeySequence("R"));
 	showPlayerPlotAct->setCheckable(true);
+
+	showTrajectoryAct = toolsMenu->addAction("&Trajectory",
+		this, SLOT(showTrajectory()), QKeySequence("T"));
+	showTrajectoryAct->setCheckable(true);
+
+	showChartAct = toolsMenu->addAction("&Chart",
+		this, SLOT(showChart()), QKeySequence("C"));
+	showChartAct->setCheckable(true);
+
+	showFramebulksAct = toolsMenu->addAction("Frame&bulks",
+		this, SLOT(showFramebulks()), QKeySequence("B"));
+	showFramebulksAct->setCheckable(true);
+
+	showTextSearchAct = toolsMenu->addAction("Text &Search",
+		this, SLOT(showTextSearch()), QKeySequence("/"));
+	showTextSearchAct->setCheckable(true);
+
+	showEntitiesAct = toolsMenu->addAction("E&ntities",
+		this, SLOT(showEntities()), QKeySequence("N"));
+	showEntitiesAct->setCheckable(true);
 }
 
 void MainWindow::populateRecentFiles()
@@ -149,6 +270,7 @@ void MainWindow::showPlayerPlot()
 	if (!playerPlotWindow) {
 		playerPlotWindow = new PlayerPlotWindow(this, logTableModel);
 		connect(playerPlotWindow, SIGNAL(aboutToClose()), showPlayerPlotAct, SLOT(toggle()));
+		rowUpdateScheduler->addTarget(playerPlotWindow, "plotFrame");
 	}
 
 	if (showPlayerPlotAct->isChecked()) {
@@ -158,11 +280,90 @@ void MainWindow::showPlayerPlot()
 		playerPlotWindow->hide();
 }
 
+void MainWindow::showTrajectory()
+{
+	if (!trajectoryWindow) {
+		trajectoryWindow = new TrajectoryWindow(this, logTableModel);
+		connect(trajectoryWindow, SIGNAL(aboutToClose()), showTrajectoryAct, SLOT(toggle()));
+		connect(trajectoryWindow, SIGNAL(rowClicked(int)), this, SLOT(goToRow(int)));
+		rowUpdateScheduler->addTarget(trajectoryWindow, "setCurrentRow");
+	}
+
+	if (showTrajectoryAct->isChecked()) {
+		trajectoryWindow->show();
+		trajectoryWindow->setCurrentRow(currentSourceRow());
+	} else
+		trajectoryWindow->hide();
+}
+
+void MainWindow::showChart()
+{
+	if (!chartWindow) {
+		chartWindow = new ChartWindow(this, logTableModel);
+		addDockWidget(Qt::BottomDockWidgetArea, chartWindow);
+		connect(chartWindow, SIGNAL(aboutToClose()), showChartAct, SLOT(toggle()));
+		connect(chartWindow, SIGNAL(rowClicked(int)), this, SLOT(goToRow(int)));
+		rowUpdateScheduler->addTarget(chartWindow, "setCurrentRow");
+	}
+
+	chartWindow->setVisible(showChartAct->isChecked());
+	if (showChartAct->isChecked())
+		chartWindow->setCurrentRow(currentSourceRow());
+}
+
+void MainWindow::showFramebulks()
+{
+	if (!framebulkWindow) {
+		framebulkWindow = new FramebulkWindow(this, logTableModel);
+		addDockWidget(Qt::BottomDockWidgetArea, framebulkWindow);
+		connect(framebulkWindow, SIGNAL(aboutToClose()), showFramebulksAct, SLOT(toggle()));
+		connect(framebulkWindow, SIGNAL(framebulkActivated(int, int)),
+			this, SLOT(selectRows(int, int)));
+	}
+
+	framebulkWindow->setVisible(showFramebulksAct->isChecked());
+}
+
+void MainWindow::showTextSearch()
+{
+	if (!textSearchWindow) {
+		textSearchWindow = new TextSearchWindow(this, logTableModel);
+		addDockWidget(Qt::BottomDockWidgetArea, textSearchWindow);
+		connect(textSearchWindow, SIGNAL(aboutToClose()), showTextSearchAct, SLOT(toggle()));
+		connect(textSearchWindow, SIGNAL(matchActivated(int)), this, SLOT(goToRow(int)));
+	}
+
+	textSearchWindow->setVisible(showTextSearchAct->isChecked());
+	if (showTextSearchAct->isChecked())
+		textSearchWindow->focusSearch();
+}
+
+void MainWindow::showEntities()
+{
+	if (!entityWindow) {
+		entityWindow = new EntityWindow(this, logTableModel);
+		addDockWidget(Qt::BottomDockWidgetArea, entityWindow);
+		connect(entityWindow, SIGNAL(aboutToClose()), showEntitiesAct, SLOT(toggle()));
+		connect(entityWindow, SIGNAL(entitySelected(int)), this, SLOT(highlightEntity(int)));
+		connect(entityWindow, SIGNAL(contactActivated(int)), this, SLOT(goToRow(int)));
+	}
+
+	entityWindow->setVisible(showEntitiesAct->isChecked());
+	highlightEntity(showEntitiesAct->isChecked() ? entityWindow->currentEntry() : -1);
+}
+
+void MainWindow::highlightEntity(int index)
+{
+	logTableModel->setHighlightedRows(index != -1
+		? logTableModel->entityIndex().rows(index) : QVector<int>());
+}
+
 void MainWindow::showInspector()
 {
 	if (!frameInspectorWindow) {
 		frameInspectorWindow = new FrameInspectorWindow(this, logTableModel);
 		connect(frameInspectorWindow, SIGNAL(aboutToClose()), showInspectorAct, SLOT(toggle()));
+		rowUpdateScheduler->addTarget(frameInspectorWindow, "inspectFrame");
 	}
 
 	if (showInspectorAct->isChecked()) {
@@ -172,6 +373,17 @@ void MainWindow::showInspector()
 		frameInspectorWindow->hide();
 }
 
+void MainWindow::followLogFile()
+{
+	logTableModel->setFollowing(followAct->isChecked());
+}
+
+void MainWindow::logFramesAppended()
+{
+	if (scrollToNewFramesAct->isChecked())
+		logTableView->scrollToBottom();
+}
+
 void MainWindow::showLogFileInfo()
 {
 	if (!fileInfoDialog) {
@@ -185,6 +397,166 @@ void MainWindow::showLogFileInfo()
 	fileInfoDialog->activateWindow();
 }
 
+void MainWindow::exportRows()
+{
+	if (!exportDialog)
+		exportDialog = new ExportDialog(this);
+	const QItemSelectionModel *selectionModel = logTableView->selectionModel();
+	exportDialog->setRowScopesAvailable(logProxyModel->hasRowMap(),
+		selectionModel && selectionModel->hasSelection());
+	if (exportDialog->exec() != QDialog::Accepted)
+		return;
+
+	ExportOptions options;
+	options.format = exportDialog->format();
+	options.columnList = exportDialog->columnList();
+	options.anglemodUnit = logTableModel->showAnglemodUnit();
+	options.fsuValues = logTableModel->showFSUValues();
+	switch (exportDialog->rowScope()) {
+	case AllRowsScope:
+		break;
+	case VisibleRowsScope:
+		options.rowList.reserve(logProxyModel->rowCount());
+		for (int row = 0; row < logProxyModel->rowCount(); row++)
+			options.rowList.append(logProxyModel->sourceRow(row));
+		// A filter hiding every row would otherwise export all of them.
+		if (options.rowList.isEmpty()) {
+			statusBar()->showMessage("No rows are visible to export.", 5000);
+			return;
+		}
+		break;
+	case SelectedRowsScope:
+		options.rowList = selectedSourceRows();
+		break;
+	}
+
+	const QString extension = exportFileExtension(options.format);
+	QSettings settings;
+	const QString lastDir = settings.value(LastExportDirectoryKey,
+		QFileInfo(logTableModel->logFileName()).path()).toString();
+	const QString suggestedName = QDir(lastDir).filePath(
+		QFileInfo(logTableModel->logFileName()).completeBaseName() + '.' + extension);
+	const QString fileName = QFileDialog::getSaveFileName(this, "Export", suggestedName,
+		QString("%1 files (*.%2);;All files (*)").arg(extension.toUpper(), extension));
+	if (fileName.isEmpty())
+		return;
+	settings.setValue(LastExportDirectoryKey, QFileInfo(fileName).canonicalPath());
+
+	const LogDocument *document = &logTableModel->logDocument();
+	startExport(fileName, [document, options](QIODevice *device, QString *errorMessage,
+		const QAtomicInt *canceled) -> bool {
+		if (options.format == ColumnarFormat)
+			return ColumnarExporter(*document).write(device, errorMessage, canceled);
+		return LogExporter(*document, options).write(device, errorMessage, canceled);
+	});
+}
+
+void MainWindow::saveSelectionAsLog()
+{
+	const FrameByteIndex &byteIndex = logTableModel->logDocument().frameByteIndex();
+	if (!byteIndex.isValid()) {
+		QMessageBox::warning(this, "Save Selection as Log",
+			"The frames of this log file could not be located in the file.");
+		return;
+	}
+
+	// Whole physics frames are saved, with every command frame of the selected rows.
+	QVector<int> frameList;
+	for (const int row : selectedSourceRows())
+		frameList.append(logTableModel->physicsFrameIndex(row));
+	frameList.erase(std::unique(frameList.begin(), frameList.end()), frameList.end());
+	if (frameList.isEmpty()) {
+		statusBar()->showMessage("Select the rows to save first.", 5000);
+		return;
+	}
+
+	const QFileInfo logFileInfo(logTableModel->logFileName());
+	QString suggestedName = QString("%1_%2-%3").arg(logFileInfo.completeBaseName())
+		.arg(frameList.first()).arg(frameList.last());
+	if (!logFileInfo.suffix().isEmpty())
+		suggestedName += '.' + logFileInfo.suffix();
+	QSettings settings;
+	const QString lastDir = settings.value(LastExportDirectoryKey, logFileInfo.path()).toString();
+	const QString fileName = QFileDialog::getSaveFileName(this, "Save Selection as Log",
+		QDir(lastDir).filePath(suggestedName));
+	if (fileName.isEmpty())
+		return;
+	settings.setValue(LastExportDirectoryKey, QFileInfo(fileName).canonicalPath());
+
+	if (QFileInfo(fileName) == logFileInfo) {
+		QMessageBox::warning(this, "Save Selection as Log",
+			"The selection cannot be saved over the log file it is read from.");
+		return;
+	}
+
+	startExport(fileName, [&byteIndex, frameList](QIODevice *device, QString *errorMessage,
+		const QAtomicInt *canceled) {
+		return byteIndex.writeFrames(device, frameList, errorMessage, canceled);
+	});
+}
+
+// Writes the file on a worker thread, removing it if writing fails or is canceled.
+void MainWindow::startExport(const QString &fileName, const ExportWriter &writer)
+{
+	stopExport();
+	QSharedPointer<QAtomicInt> canceled(new QAtomicInt(0));
+	exportCanceled = canceled;
+	exportFileName = fileName;
+	// Frames appended in follow mode wait for the export, which reads the document.
+	const DocumentReader reader = logTableModel->logDocument().startReading();
+	exportWatcher.setFuture(QtConcurrent::run([writer, fileName, canceled,
+		reader]() -> QString {
+		QFile file(fileName);
+		if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+			return file.errorString();
+		QString errorMessage;
+		if (!writer(&file, &errorMessage, canceled.data())) {
+			file.remove();
+			return errorMessage;
+		}
+		return QString();
+	}));
+	updateExportActions();
+	statusBar()->showMessage(QString("Writing %1...").arg(fileName));
+}
+
+void MainWindow::updateExportActions()
+{
+	const bool enabled = logTableModel->rowCount() > 0 && !exportCanceled;
+	exportAct->setEnabled(enabled);
+	saveSelectionAsLogAct->setEnabled(enabled);
+}
+
+void MainWindow::exportFinished()
+{
+	// A stopped export has already been reported.
+	if (!exportCanceled || exportCanceled->load())
+		return;
+	exportCanceled.clear();
+	updateExportActions();
+
+	const QString errorMessage = exportWatcher.result();
+	if (errorMessage.isEmpty()) {
+		statusBar()->showMessage(QString("Saved %1.").arg(exportFileName), 5000);
+		return;
+	}
+	statusBar()->clearMessage();
+	QMessageBox::warning(this, "qconread2",
+		QString("Cannot write %1: %2").arg(exportFileName, errorMessage));
+}
+
+void MainWindow::stopExport()
+{
+	if (!exportCanceled)
+		return;
+
+	exportCanceled->store(1);
+	exportCanceled.clear();
+	exportWatcher.waitForFinished();
+	updateExportActions();
+	statusBar()->showMessage(QString("Writing %1 was canceled.").arg(exportFileName), 5000);
+}
+
 void MainWindow::jumpToStartOfLog()
 {
 	logTableView->scrollToTop();
@@ -195,22 +567,391 @@ void MainWindow::jumpToEndOfLog()
 	logTableView->scrollToBottom();
 }
 
+int MainWindow::currentSourceRow() const
+{
+	return logProxyModel->sourceRow(logTableView->currentIndex().row());
+}
+
+// Returns the distinct source rows of the selection in ascending order.
+QVector<int> MainWindow::selectedSourceRows() const
+{
+	QVector<int> rowList;
+	const QItemSelectionModel *selectionModel = logTableView->selectionModel();
+	if (!selectionModel)
+		return rowList;
+
+	for (const QItemSelectionRange &range : selectionModel->selection()) {
+		for (int row = range.top(); row <= range.bottom(); row++)
+			rowList.append(logProxyModel->sourceRow(row));
+	}
+	std::sort(rowList.begin(), rowList.end());
+	rowList.erase(std::unique(rowList.begin(), rowList.end()), rowList.end());
+	return rowList;
+}
+
+// Rows hidden by the filter fall back to the next visible row.
+void MainWindow::goToRow(int row)
+{
+	if (row < 0 || row >= logTableModel->rowCount() || logProxyModel->rowCount() == 0)
+		return;
+
+	const int column = std::max(0, logTableView->currentIndex().column());
+	const QModelIndex index = logProxyModel->index(logProxyModel->nearestProxyRow(row), column);
+	logTableView->setCurrentIndex(index);
+	logTableView->scrollTo(index, QAbstractItemView::PositionAtCenter);
+}
+
+void MainWindow::goToTime()
+{
+	// The dialog would have no valid range in an empty log.
+	if (logTableModel->rowCount() == 0)
+		return;
+
+	const GameTimeIndex &timeIndex = logTableModel->gameTimeIndex();
+	const int currentRow = currentSourceRow();
+	const double currentTime = currentRow != -1
+		? timeIndex.timeAt(logTableModel->physicsFrameIndex(currentRow)) : 0;
+
+	bool ok;
+	const double time = QInputDialog::getDouble(this, "Go to Time", "Game time (s):",
+		currentTime, 0, timeIndex.totalTime(), 4, &ok);
+	if (!ok)
+		return;
+
+	const int phy = timeIndex.findPhysicsFrame(time);
+	if (phy != -1)
+		goToRow(timeIndex.physicsFrameRow(phy));
+}
+
+void MainWindow::goToPhysicsFrame()
+{
+	if (logTableModel->rowCount() == 0)
+		return;
+
+	const GameTimeIndex &timeIndex = logTableModel->gameTimeIndex();
+	const int currentRow = currentSourceRow();
+	const int currentFrame = currentRow != -1
+		? logTableModel->physicsFrameIndex(currentRow) + 1 : 1;
+
+	bool ok;
+	const int frame = QInputDialog::getInt(this, "Go to Physics Frame", "Physics frame:",
+		currentFrame, 1, timeIndex.physicsFrameCount(), 1, &ok);
+	if (ok)
+		goToRow(timeIndex.physicsFrameRow(frame - 1));
+}
+
+void MainWindow::goToCommandFrame()
+{
+	const GameTimeIndex &timeIndex = logTableModel->gameTimeIndex();
+	if (timeIndex.commandFrameCount() == 0)
+		return;
+
+	const int row = currentSourceRow();
+	int currentFrame = 1;
+	if (row != -1) {
+		currentFrame = std::max(0,
+			timeIndex.commandFrameIndex(logTableModel->physicsFrameIndex(row), row)) + 1;
+	}
+
+	bool ok;
+	const int frame = QInputDialog::getInt(this, "Go to Command Frame", "Command frame:",
+		currentFrame, 1, timeIndex.commandFrameCount(), 1, &ok);
+	if (ok)
+		goToRow(timeIndex.findCommandFrameRow(frame - 1));
+}
+
+// Goes to the frame nearest to the position, in the top-down view if z is left out.
+void MainWindow::goToPosition()
+{
+	const LogColumns &columns = logTableModel->logColumns();
+	const int row = currentSourceRow();
+	QString currentText;
+	if (row != -1 && !std::isnan(columns.value(PositionXField, row))) {
+		currentText = QString("%1 %2 %3").arg(columns.value(PositionXField, row))
+			.arg(columns.value(PositionYField, row)).arg(columns.value(PositionZField, row));
+	}
+
+	bool ok;
+	const QString text = QInputDialog::getText(this, "Go to Position", "Position (x y [z]):",
+		QLineEdit::Normal, currentText, &ok);
+	if (!ok)
+		return;
+
+	const QStringList parts = text.split(' ', QString::SkipEmptyParts);
+	float point[3] = {0, 0, 0};
+	bool valid = parts.size() == 2 || parts.size() == 3;
+	for (int i = 0; valid && i < parts.size(); i++)
+		point[i] = parts.at(i).toFloat(&valid);
+	if (!valid) {
+		QMessageBox::warning(this, "Go to Position", "Enter two or three coordinates.");
+		return;
+	}
+
+	goToRow(logTableModel->spatialIndex().findNearest(point, parts.size() == 2
+		? SpatialIndex::XAxis | SpatialIndex::YAxis : SpatialIndex::AllAxes));
+}
+
+// Highlights the frames passing near the position of the current frame, which shows where
+// the route comes back to it.
+void MainWindow::highlightNearbyFrames()
+{
+	const LogColumns &columns = logTableModel->logColumns();
+	const int row = currentSourceRow();
+	if (row == -1 || std::isnan(columns.value(PositionXField, row)))
+		return;
+
+	bool ok;
+	const double radius = QInputDialog::getDouble(this, "Highlight Frames Near Here",
+		"Radius (units):", 32, 0, 1e6, 1, &ok);
+	if (!ok)
+		return;
+
+	const float point[3] = {
+		columns.value(PositionXField, row),
+		columns.value(PositionYField, row),
+		columns.value(PositionZField, row),
+	};
+	logTableModel->setHighlightedRows(
+		logTableModel->spatialIndex().findWithinRadius(point, radius));
+}
+
+void MainWindow::clearHighlight()
+{
+	logTableModel->setHighlightedRows(QVector<int>());
+}
+
+void MainWindow::goToNextEvent()
+{
+	QAction *action = qobject_cast<QAction *>(sender());
+	if (!action)
+		return;
+
+	const int row = currentSourceRow();
+	goToRow(logTableModel->eventIndex().findNext(action->data().toInt(), row));
+}
+
+void MainWindow::goToPreviousEvent()
+{
+	QAction *action = qobject_cast<QAction *>(sender());
+	if (!action)
+		return;
+
+	const int currentRow = currentSourceRow();
+	const int row = currentRow != -1 ? currentRow : logTableModel->rowCount();
+	goToRow(logTableModel->eventIndex().findPrevious(action->data().toInt(), row));
+}
+
+void MainWindow::goToNextSearchMatch()
+{
+	if (textSearchWindow)
+		goToRow(textSearchWindow->findNextMatch(currentSourceRow()));
+}
+
+void MainWindow::goToPreviousSearchMatch()
+{
+	if (!textSearchWindow)
+		return;
+
+	const int currentRow = currentSourceRow();
+	const int row = currentRow != -1 ? currentRow : logTableModel->rowCount();
+	goToRow(textSearchWindow->findPreviousMatch(row));
+}
+
+void MainWindow::goToNextContact()
+{
+	if (!entityWindow || entityWindow->currentEntry() == -1)
+		return;
+
+	goToRow(logTableModel->entityIndex().findNext(entityWindow->currentEntry(),
+		currentSourceRow()));
+}
+
+void MainWindow::goToPreviousContact()
+{
+	if (!entityWindow || entityWindow->currentEntry() == -1)
+		return;
+
+	const int currentRow = currentSourceRow();
+	const int row = currentRow != -1 ? currentRow : logTableModel->rowCount();
+	goToRow(logTableModel->entityIndex().findPrevious(entityWindow->currentEntry(), row));
+}
+
+void MainWindow::showElapsedTime()
+{
+	logTableView->setColumnHidden(ElapsedTimeHeader, !showElapsedTimeAct->isChecked());
+}
+
+void MainWindow::showEventMinimap()
+{
+	eventMinimap->setVisible(showEventMinimapAct->isChecked());
+}
+
+void MainWindow::showFilterBar()
+{
+	if (showFilterBarAct->isChecked()) {
+		filterBar->show();
+		filterBar->focusFilter();
+	} else {
+		filterBar->clearFilter();
+		filterBar->hide();
+	}
+}
+
+void MainWindow::clearSort()
+{
+	logTableView->horizontalHeader()->setSortIndicator(-1, Qt::AscendingOrder);
+}
+
+void MainWindow::addComputedColumn()
+{
+	if (!computedColumnDialog)
+		computedColumnDialog = new ComputedColumnDialog(this, logTableModel);
+	computedColumnDialog->editColumn(-1);
+	computedColumnDialog->exec();
+}
+
+// Returns the computed column index of the current column, or -1 after telling the user.
+int MainWindow::currentComputedColumn()
+{
+	const int index = logTableModel->computedColumnIndex(logTableView->currentIndex().column());
+	if (index == -1) {
+		QMessageBox::information(this, "qconread2",
+			"Select a cell of a computed column first.");
+	}
+	return index;
+}
+
+void MainWindow::editComputedColumn()
+{
+	const int index = currentComputedColumn();
+	if (index == -1)
+		return;
+
+	if (!computedColumnDialog)
+		computedColumnDialog = new ComputedColumnDialog(this, logTableModel);
+	computedColumnDialog->editColumn(index);
+	computedColumnDialog->exec();
+}
+
+void MainWindow::removeComputedColumn()
+{
+	const int index = currentComputedColumn();
+	if (index != -1)
+		logTableModel->removeComputedColumn(index);
+}
+
+// Lists every column for hiding and showing it.
+void MainWindow::showHeaderMenu(const QPoint &pos)
+{
+	QMenu menu(this);
+	for (int column = 0; column < logTableModel->columnCount(); column++) {
+		QAction *action = menu.addAction(QString("%1 (%2)")
+			.arg(logTableModel->headerData(column, Qt::Horizontal).toString())
+			.arg(logTableModel->headerData(column, Qt::Horizontal, Qt::ToolTipRole)
+				.toString()));
+		action->setCheckable(true);
+		action->setChecked(!logTableView->isColumnHidden(column));
+		action->setData(column);
+	}
+
+	QAction *action = menu.exec(logTableView->horizontalHeader()->mapToGlobal(pos));
+	if (!action)
+		return;
+
+	const int column = action->data().toInt();
+	logTableView->setColumnHidden(column, !action->isChecked());
+	if (column == ElapsedTimeHeader)
+		showElapsedTimeAct->setChecked(action->isChecked());
+}
+
+void MainWindow::restoreComputedColumns()
+{
+	QSettings settings;
+	const int count = settings.beginReadArray(ComputedColumnsKey);
+	for (int i = 0; i < count; i++) {
+		settings.setArrayIndex(i);
+		logTableModel->addComputedColumn(settings.value(ComputedColumnNameKey).toString(),
+			settings.value(ComputedColumnExpressionKey).toString(), nullptr);
+	}
+	settings.endArray();
+}
+
+void MainWindow::saveComputedColumns()
+{
+	const ComputedColumns &columns = logTableModel->computedColumns();
+	QSettings settings;
+	settings.beginWriteArray(ComputedColumnsKey, columns.count());
+	for (int i = 0; i < columns.count(); i++) {
+		settings.setArrayIndex(i);
+		settings.setValue(ComputedColumnNameKey, columns.name(i));
+		settings.setValue(ComputedColumnExpressionKey, columns.expression(i));
+	}
+	settings.endArray();
+}
+
+void MainWindow::updateMinimapViewport()
+{
+	const int firstRow = logTableView->rowAt(0);
+	int lastRow = logTableView->rowAt(logTableView->viewport()->height() - 1);
+	if (lastRow == -1)
+		lastRow = logProxyModel->rowCount() - 1;
+	// The rows on screen are scattered over the log when sorted.
+	if (logProxyModel->isSorted()) {
+		eventMinimap->setVisibleRows(0, -1);
+		return;
+	}
+	eventMinimap->setVisibleRows(logProxyModel->sourceRow(firstRow),
+		logProxyModel->sourceRow(lastRow));
+}
+
+void MainWindow::selectRows(int firstRow, int lastRow)
+{
+	// Only the rows shown by the filter get selected, wherever the sort puts them.
+	QVector<int> proxyRows;
+	for (int row = firstRow; row <= lastRow; row++) {
+		const int proxyRow = logProxyModel->proxyRow(row);
+		if (proxyRow != -1)
+			proxyRows.append(proxyRow);
+	}
+	if (proxyRows.isEmpty())
+		return;
+	std::sort(proxyRows.begin(), proxyRows.end());
+
+	const int lastColumn = logProxyModel->columnCount() - 1;
+	QItemSelection selection;
+	int runStart = 0;
+	for (int i = 1; i <= proxyRows.size(); i++) {
+		if (i < proxyRows.size() && proxyRows.at(i) == proxyRows.at(i - 1) + 1)
+			continue;
+		selection.select(logProxyModel->index(proxyRows.at(runStart), 0),
+			logProxyModel->index(proxyRows.at(i - 1), lastColumn));
+		runStart = i;
+	}
+
+	const QModelIndex first = logProxyModel->index(logProxyModel->proxyRow(firstRow) != -1
+		? logProxyModel->proxyRow(firstRow) : proxyRows.first(), 0);
+	QItemSelectionModel *selectionModel = logTableView->selectionModel();
+	selectionModel->setCurrentIndex(first, QItemSelectionModel::NoUpdate);
+	selectionModel->select(selection, QItemSelectionModel::ClearAndSelect);
+	logTableView->scrollTo(first, QAbstractItemView::PositionAtTop);
+}
+
 void MainWindow::inspectCurrentRow()
 {
 	if (!frameInspectorWindow)
 		return;
-	const QModelIndex &currentIndex = logTableView->currentIndex();
-	if (currentIndex.isValid())
-		frameInspectorWindow->inspectFrame(currentIndex.row());
+	const int row = currentSourceRow();
+	if (row != -1)
+		frameInspectorWindow->inspectFrame(row);
 }
 
 void MainWindow::plotCurrentRow()
 {
 	if (!playerPlotWindow)
 		return;
-	const QModelIndex &currentIndex = logTableView->currentIndex();
-	if (currentIndex.isValid())
-		playerPlotWindow->plotFrame(currentIndex.row());
+	const int row = currentSourceRow();
+	if (row != -1)
+		playerPlotWindow->plotFrame(row);
 }
 
 void MainWindow::showAnglemodUnit()
@@ -240,16 +981,99 @@ void MainWindow::showPostPM()
 
 void MainWindow::setupStatusBar()
 {
-	statusBar();
+	selectionStatsLabel = new QLabel(this);
+	selectionStatsLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+	statusBar()->addWidget(selectionStatsLabel, 1);
 }
 
-void MainWindow::currentChanged(const QModelIndex &current, const QModelIndex &)
+// Loops over the source rows spanned by the selection, or over the whole log without one.
+void MainWindow::setLoopRegionToSelection()
 {
-	if (frameInspectorWindow)
-		frameInspectorWindow->inspectFrame(current.row());
+	// The ends of a sorted selection are not its first and last source rows.
+	const QVector<int> rowList = selectedSourceRows();
+	int firstRow = rowList.isEmpty() ? -1 : rowList.first();
+	int lastRow = rowList.isEmpty() ? -1 : rowList.last();
+	if (firstRow == lastRow)
+		firstRow = lastRow = -1;
+	playbackBar->setLoopRegion(firstRow, lastRow);
+}
 
-	if (playerPlotWindow)
-		playerPlotWindow->plotFrame(current.row());
+void MainWindow::updateSelectionStats()
+{
+	const QItemSelectionModel *selectionModel = logTableView->selectionModel();
+	if (!selectionModel || !selectionModel->hasSelection()) {
+		selectionStatsLabel->clear();
+		return;
+	}
+
+	// Ranges of different columns may cover the same rows, so merge them into disjoint spans
+	// of source rows. With a filter or a sort, a range is split where it skips source rows.
+	QVector<QPair<int, int>> spanList;
+	for (const QItemSelectionRange &range : selectionModel->selection())
+		spanList += logProxyModel->sourceSpans(range.top(), range.bottom());
+	std::sort(spanList.begin(), spanList.end());
+	int merged = 0;
+	for (int i = 1; i < spanList.size(); i++) {
+		if (spanList[i].first <= spanList[merged].second + 1)
+			spanList[merged].second = std::max(spanList[merged].second, spanList[i].second);
+		else
+			spanList[++merged] = spanList[i];
+	}
+	spanList.resize(merged + 1);
+
+	const RowPrefixSums &sums = logTableModel->rowPrefixSums();
+	const RangeStatistics &stats = logTableModel->rangeStatistics();
+	const LogColumns &columns = logTableModel->logColumns();
+	const int column = logTableView->currentIndex().column();
+	const int field = column >= 0 && column < HorizontalHeaderCount
+		? ColumnDescriptorList[column].field : -1;
+
+	int rows = 0;
+	int jumps = 0;
+	int ducks = 0;
+	double duration = 0;
+	double distance = 0;
+	RangeSummary summary;
+	for (const QPair<int, int> &span : spanList) {
+		rows += span.second - span.first + 1;
+		duration += logTableModel->duration(span.first, span.second);
+		distance += sums.distance(span.first, span.second);
+		jumps += sums.jumpPresses(span.first, span.second);
+		ducks += sums.duckPresses(span.first, span.second);
+		if (field != -1)
+			summary.merge(stats.summarize(field, span.first, span.second));
+	}
+
+	if (rows < 2) {
+		selectionStatsLabel->clear();
+		return;
+	}
+
+	QStringList partList;
+	partList << QString("Rows: %1").arg(rows)
+		<< QString("Time: %1 s").arg(duration)
+		<< QString("Distance: %1").arg(distance);
+
+	const float firstSpeed = columns.value(HorizontalSpeedField, spanList.first().first);
+	const float lastSpeed = columns.value(HorizontalSpeedField, spanList.last().second);
+	if (!std::isnan(firstSpeed) && !std::isnan(lastSpeed))
+		partList << QString("Speed gain: %1").arg(lastSpeed - firstSpeed);
+
+	if (summary.count) {
+		partList << QString("%1 min/max/mean: %2 / %3 / %4")
+			.arg(ColumnDescriptorList[column].name)
+			.arg(summary.min).arg(summary.max).arg(summary.mean());
+	}
+
+	partList << QString("Jumps: %1").arg(jumps) << QString("Ducks: %1").arg(ducks);
+	selectionStatsLabel->setText(partList.join(QStringLiteral("    ")));
+}
+
+void MainWindow::currentChanged(const QModelIndex &current, const QModelIndex &)
+{
+	const int row = logProxyModel->sourceRow(current.row());
+	rowUpdateScheduler->scheduleRow(row);
+	playbackBar->setCurrentRow(row);
 }
 
 void MainWindow::setupUi()
@@ -263,13 +1087,62 @@ void MainWindow::setupUi()
 	logTableView->setHorizontalScrollMode(QAbstractItemView::ScrollPerPixel);
 	logTableView->setEditTriggers(QAbstractItemView::NoEditTriggers);
 	logTableView->horizontalHeader()->setSectionsMovable(true);
+	logTableView->horizontalHeader()->setContextMenuPolicy(Qt::CustomContextMenu);
+	connect(logTableView->horizontalHeader(), SIGNAL(customContextMenuRequested(const QPoint &)),
+		this, SLOT(showHeaderMenu(const QPoint &)));
 	logTableView->horizontalHeader()->setDefaultSectionSize(90);
+	logTableView->horizontalHeader()->setSortIndicatorShown(true);
+	logTableView->horizontalHeader()->setSortIndicator(-1, Qt::AscendingOrder);
+	logTableView->horizontalHeader()->setSectionsClickable(true);
 	logTableView->verticalHeader()->setDefaultSectionSize(25);
 	connect(logTableView, SIGNAL(currentChanged_(const QModelIndex &, const QModelIndex &)),
 		this, SLOT(currentChanged(const QModelIndex &, const QModelIndex &)));
-	setCentralWidget(logTableView);
+	connect(logTableView, SIGNAL(selectionChanged_()), this, SLOT(updateSelectionStats()));
 
 	logTableModel = new LogTableModel(logTableView);
+	restoreComputedColumns();
+	logProxyModel = new LogProxyModel(logTableView);
+	logProxyModel->setSourceModel(logTableModel);
+	connect(logProxyModel, SIGNAL(rowMapChanged()), this, SLOT(updateMinimapViewport()));
+
+	filterBar = new FilterBar(this, logTableModel, logProxyModel);
+	filterBar->hide();
+	connect(filterBar, SIGNAL(aboutToClose()), showFilterBarAct, SLOT(toggle()));
+
+	rowSorter = new RowSorter(this, logTableModel, logProxyModel);
+	connect(logTableView->horizontalHeader(), SIGNAL(sortIndicatorChanged(int, Qt::SortOrder)),
+		rowSorter, SLOT(sortByColumn(int, Qt::SortOrder)));
+
+	rowUpdateScheduler = new RowUpdateScheduler(this);
+
+	playbackBar = new PlaybackBar(this, logTableModel, logProxyModel);
+	addToolBar(Qt::BottomToolBarArea, playbackBar);
+	connect(playbackBar, SIGNAL(rowChanged(int)), this, SLOT(goToRow(int)));
+	connect(playbackBar, SIGNAL(loopRegionRequested()), this, SLOT(setLoopRegionToSelection()));
+
+	eventMinimap = new EventMinimap(this, logTableModel);
+	connect(eventMinimap, SIGNAL(rowClicked(int)), this, SLOT(goToRow(int)));
+	// Emitted on loading too, and when the on-ground densities follow the other player states.
+	connect(logTableModel, SIGNAL(logColumnsChanged()), eventMinimap, SLOT(densityChanged()));
+	connect(logTableModel, SIGNAL(logFramesAppended(int)), eventMinimap, SLOT(densityChanged()));
+	connect(logTableModel, SIGNAL(logFramesAppended(int)), this, SLOT(logFramesAppended()));
+	connect(logTableView->verticalScrollBar(), SIGNAL(valueChanged(int)),
+		this, SLOT(updateMinimapViewport()));
+	connect(logTableView->verticalScrollBar(), SIGNAL(rangeChanged(int, int)),
+		this, SLOT(updateMinimapViewport()));
+
+	QWidget *centralWidget = new QWidget(this);
+	QVBoxLayout *centralLayout = new QVBoxLayout(centralWidget);
+	centralLayout->setContentsMargins(0, 0, 0, 0);
+	centralLayout->setSpacing(0);
+	centralLayout->addWidget(filterBar);
+	QHBoxLayout *tableLayout = new QHBoxLayout;
+	tableLayout->setSpacing(0);
+	tableLayout->addWidget(logTableView);
+	tableLayout->addWidget(eventMinimap);
+	centralLayout->addLayout(tableLayout, 1);
+	centralWidget->setLayout(centralLayout);
+	setCentralWidget(centralWidget);
 	connect(logTableModel, SIGNAL(logFileLoaded(bool)),
 		reloadAct, SLOT(setEnabled(bool)));
 	connect(logTableModel, SIGNAL(logFileLoaded(bool)),
@@ -286,10 +1159,34 @@ void MainWindow::setupUi()
 		jumpToStartOfLogAct, SLOT(setEnabled(bool)));
 	connect(logTableModel, SIGNAL(logFileLoaded(bool)),
 		jumpToEndOfLogAct, SLOT(setEnabled(bool)));
+	connect(logTableModel, SIGNAL(logFileLoaded(bool)),
+		goToTimeAct, SLOT(setEnabled(bool)));
+	connect(logTableModel, SIGNAL(logFileLoaded(bool)),
+		goToPhysicsFrameAct, SLOT(setEnabled(bool)));
+	connect(logTableModel, SIGNAL(logFileLoaded(bool)),
+		goToCommandFrameAct, SLOT(setEnabled(bool)));
+	connect(logTableModel, SIGNAL(logFileLoaded(bool)),
+		goToPositionAct, SLOT(setEnabled(bool)));
+	connect(logTableModel, SIGNAL(logFileLoaded(bool)),
+		highlightNearbyFramesAct, SLOT(setEnabled(bool)));
+	for (int i = 0; i < EventTypeCount; i++) {
+		connect(logTableModel, SIGNAL(logFileLoaded(bool)),
+			nextEventActionList[i], SLOT(setEnabled(bool)));
+		connect(logTableModel, SIGNAL(logFileLoaded(bool)),
+			previousEventActionList[i], SLOT(setEnabled(bool)));
+	}
 	connect(logTableModel, SIGNAL(logFileLoaded(bool)),
 		logFileInfoAct, SLOT(setEnabled(bool)));
+	connect(logTableModel, SIGNAL(logFileLoaded(bool)),
+		exportAct, SLOT(setEnabled(bool)));
+	connect(logTableModel, SIGNAL(logFileLoaded(bool)),
+		saveSelectionAsLogAct, SLOT(setEnabled(bool)));
+	// The export reads the document, which changes under it.
+	connect(logTableModel, SIGNAL(logColumnsAboutToChange()), this, SLOT(stopExport()));
+	connect(&exportWatcher, SIGNAL(finished()), this, SLOT(exportFinished()));
+	connect(logTableModel, SIGNAL(logColumnsChanged()), this, SLOT(updateSelectionStats()));
 
-	logTableView->setModel(logTableModel);
+	logTableView->setModel(logProxyModel);
 	logTableView->resizeColumnToContents(OnGroundHeader);
 	logTableView->resizeColumnToContents(DuckStateHeader);
 	logTableView->resizeColumnToContents(JumpHeader);
@@ -312,6 +1209,7 @@ void MainWindow::setupUi()
 	logTableView->resizeColumnToContents(NonSharedRNGParameterHeader);
 	logTableView->setColumnWidth(HealthHeader, 50);
 	logTableView->setColumnWidth(ArmorHeader, 50);
+	logTableView->setColumnHidden(ElapsedTimeHeader, true);
 }
 
 void MainWindow::reloadLogFile()
@@ -362,6 +1260,7 @@ void MainWindow::closeEvent(QCloseEvent *event)
 	settings.setValue(MainWindowGeometryKey, saveGeometry());
 	settings.setValue(LogTableHorizontalHeaderStateKey,
 		logTableView->horizontalHeader()->saveState());
+	saveComputedColumns();
 
 	event->accept();
 }
@@ -372,6 +1271,9 @@ void MainWindow::showEvent(QShowEvent *event)
 	restoreGeometry(settings.value(MainWindowGeometryKey).toByteArray());
 	logTableView->horizontalHeader()->restoreState(
 		settings.value(LogTableHorizontalHeaderStateKey).toByteArray());
+	showElapsedTimeAct->setChecked(!logTableView->isColumnHidden(ElapsedTimeHeader));
+	// The saved state includes the sort indicator, but the log opens in log order.
+	logTableView->horizontalHeader()->setSortIndicator(-1, Qt::AscendingOrder);
 
 	event->accept();
 }
@@ -1,11 +1,25 @@
 #pragma once
 
+#include <functional>
 #include <QtWidgets>
 #include "logtableview.hpp"
 #include "logtablemodel.hpp"
+#include "logproxymodel.hpp"
 #include "fileinfodialog.hpp"
 #include "frameinspectorwindow.hpp"
 #include "playerplotwindow.hpp"
+#include "trajectorywindow.hpp"
+#include "chartwindow.hpp"
+#include "framebulkwindow.hpp"
+#include "textsearchwindow.hpp"
+#include "entitywindow.hpp"
+#include "eventminimap.hpp"
+#include "filterbar.hpp"
+#include "rowsorter.hpp"
+#include "playbackbar.hpp"
+#include "rowupdatescheduler.hpp"
+#include "computedcolumndialog.hpp"
+#include "exportdialog.hpp"
 #include "settings.hpp"
 
 class MainWindow : public QMainWindow
@@ -14,13 +28,20 @@ class MainWindow : public QMainWindow
 
 public:
 	MainWindow();
+	~MainWindow();
 
 private slots:
 	void openNewInstance();
 	void openLogFile();
 	void openRecentFile();
 	void reloadLogFile();
+	void followLogFile();
+	void logFramesAppended();
 	void showLogFileInfo();
+	void exportRows();
+	void saveSelectionAsLog();
+	void exportFinished();
+	void stopExport();
 	void showAnglemodUnit();
 	void showFSUValues();
 	void showGrid();
@@ -29,10 +50,41 @@ private slots:
 	void showPostPM();
 	void jumpToStartOfLog();
 	void jumpToEndOfLog();
+	void goToTime();
+	void goToPhysicsFrame();
+	void goToCommandFrame();
+	void goToPosition();
+	void highlightNearbyFrames();
+	void clearHighlight();
+	void goToNextEvent();
+	void goToPreviousEvent();
+	void goToNextSearchMatch();
+	void goToPreviousSearchMatch();
+	void goToNextContact();
+	void goToPreviousContact();
+	void showElapsedTime();
+	void showEventMinimap();
+	void showFilterBar();
+	void clearSort();
+	void addComputedColumn();
+	void editComputedColumn();
+	void removeComputedColumn();
+	void showHeaderMenu(const QPoint &pos);
+	void updateMinimapViewport();
 	void showInspector();
 	void showPlayerPlot();
+	void showTrajectory();
+	void showChart();
+	void showFramebulks();
+	void showTextSearch();
+	void showEntities();
+	void highlightEntity(int index);
+	void goToRow(int row);
+	void selectRows(int firstRow, int lastRow);
+	void setLoopRegionToSelection();
 
 	void currentChanged(const QModelIndex &current, const QModelIndex &previous);
+	void updateSelectionStats();
 
 protected:
 	void closeEvent(QCloseEvent *event) override;
@@ -43,32 +95,82 @@ private:
 	QAction *openAct;
 	QMenu *openRecentMenu;
 	QAction *reloadAct;
+	QAction *followAct;
+	QAction *scrollToNewFramesAct;
 	QAction *closeAct;
 	QAction *logFileInfoAct;
+	QAction *exportAct;
+	QAction *saveSelectionAsLogAct;
 	QAction *quitAct;
 
 	QAction *anglemodUnitAct;
 	QAction *showFSUValuesAct;
 	QAction *showGridAct;
 	QAction *hideMostCommonFrameTimesAct;
+	QAction *showElapsedTimeAct;
+	QAction *showEventMinimapAct;
+	QAction *showFilterBarAct;
+	QAction *clearSortAct;
+	QAction *addComputedColumnAct;
+	QAction *editComputedColumnAct;
+	QAction *removeComputedColumnAct;
 	QAction *prePlayerMoveAct;
 	QAction *postPlayerMoveAct;
 	QActionGroup *playerMoveGroup;
 
 	QAction *jumpToStartOfLogAct;
 	QAction *jumpToEndOfLogAct;
+	QAction *goToTimeAct;
+	QAction *goToPhysicsFrameAct;
+	QAction *goToCommandFrameAct;
+	QAction *goToPositionAct;
+	QAction *highlightNearbyFramesAct;
+	QAction *clearHighlightAct;
+	QAction *nextEventActionList[EventTypeCount];
+	QAction *previousEventActionList[EventTypeCount];
+	QAction *nextSearchMatchAct;
+	QAction *previousSearchMatchAct;
+	QAction *nextContactAct;
+	QAction *previousContactAct;
 
 	QAction *showInspectorAct;
 	QAction *showPlayerPlotAct;
+	QAction *showTrajectoryAct;
+	QAction *showChartAct;
+	QAction *showFramebulksAct;
+	QAction *showTextSearchAct;
+	QAction *showEntitiesAct;
 
 	QAction *recentFileActionList[MaxRecentFiles];
 
+	QLabel *selectionStatsLabel;
+
 	FileInfoDialog *fileInfoDialog = nullptr;
 	FrameInspectorWindow *frameInspectorWindow = nullptr;
 	PlayerPlotWindow *playerPlotWindow = nullptr;
+	TrajectoryWindow *trajectoryWindow = nullptr;
+	ChartWindow *chartWindow = nullptr;
+	FramebulkWindow *framebulkWindow = nullptr;
+	TextSearchWindow *textSearchWindow = nullptr;
+	EntityWindow *entityWindow = nullptr;
+	ComputedColumnDialog *computedColumnDialog = nullptr;
+	ExportDialog *exportDialog = nullptr;
+
+	// Writes an export to the device, returning false on failure or cancellation.
+	typedef std::function<bool(QIODevice *, QString *, const QAtomicInt *)> ExportWriter;
+
+	QFutureWatcher<QString> exportWatcher;
+	QSharedPointer<QAtomicInt> exportCanceled;
+	QString exportFileName;
 
 	LogTableView *logTableView;
+	EventMinimap *eventMinimap;
+	FilterBar *filterBar;
+	RowSorter *rowSorter;
+	PlaybackBar *playbackBar;
+	RowUpdateScheduler *rowUpdateScheduler;
 	LogTableModel *logTableModel;
+	LogProxyModel *logProxyModel;
 
 	void setupMenuBar();
 	void setupStatusBar();
@@ -78,6 +180,14 @@ private:
 
 	bool loadLogFile(const QString &fileName);
 
+	int currentSourceRow() const;
+	QVector<int> selectedSourceRows() const;
+	void startExport(const QString &fileName, const ExportWriter &writer);
+	void updateExportActions();
+	int currentComputedColumn();
+	void restoreComputedColumns();
+	void saveComputedColumns();
+
 	void inspectCurrentRow();
 	void plotCurrentRow();
 };
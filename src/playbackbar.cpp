@@ -0,0 +1,267 @@
+#include <algorithm>
+#include "playbackbar.hpp"
+
+static const double SpeedList[] = {0.1, 0.25, 0.5, 1, 2, 4, 10};
+static const int SpeedCount = sizeof(SpeedList) / sizeof(SpeedList[0]);
+static const int DefaultSpeedIndex = 3;
+
+PlaybackBar::PlaybackBar(QWidget *parent, const LogTableModel *model,
+	const LogProxyModel *proxyModel)
+	: QToolBar("Playback", parent), logTableModel(model), logProxyModel(proxyModel)
+{
+	setupUi();
+}
+
+void PlaybackBar::setupUi()
+{
+	setObjectName("playbackBar");
+
+	stepBackwardAct = addAction(style()->standardIcon(QStyle::SP_MediaSeekBackward),
+		"Step Backward", this, SLOT(stepBackward()));
+	stepBackwardAct->setShortcut(QKeySequence(","));
+	playAct = addAction(style()->standardIcon(QStyle::SP_MediaPlay),
+		"Play", this, SLOT(togglePlayback()));
+	playAct->setShortcut(QKeySequence("Space"));
+	stepForwardAct = addAction(style()->standardIcon(QStyle::SP_MediaSeekForward),
+		"Step Forward", this, SLOT(stepForward()));
+	stepForwardAct->setShortcut(QKeySequence("."));
+
+	speedCombo = new QComboBox(this);
+	for (int i = 0; i < SpeedCount; i++)
+		speedCombo->addItem(QString("%1x").arg(SpeedList[i]), SpeedList[i]);
+	speedCombo->setCurrentIndex(DefaultSpeedIndex);
+	speedCombo->setToolTip("Playback speed relative to game time");
+	connect(speedCombo, SIGNAL(currentIndexChanged(int)), this, SLOT(speedChanged()));
+	addWidget(speedCombo);
+
+	loopAct = addAction("Loop");
+	loopAct->setCheckable(true);
+	loopAct->setToolTip("Loop over the selected rows, or over the whole log");
+	connect(loopAct, SIGNAL(toggled(bool)), this, SLOT(loopToggled(bool)));
+
+	addSeparator();
+
+	positionSlider = new QSlider(Qt::Horizontal, this);
+	positionSlider->setRange(0, 0);
+	connect(positionSlider, SIGNAL(valueChanged(int)), this, SLOT(sliderMoved(int)));
+	addWidget(positionSlider);
+
+	timeLabel = new QLabel(this);
+	timeLabel->setAlignment(Qt::AlignRight | Qt::AlignVCenter);
+	addWidget(timeLabel);
+
+	timer.setTimerType(Qt::PreciseTimer);
+	connect(&timer, SIGNAL(timeout()), this, SLOT(tick()));
+
+	connect(logTableModel, SIGNAL(logColumnsAboutToChange()),
+		this, SLOT(logColumnsAboutToChange()));
+	connect(logTableModel, SIGNAL(logColumnsChanged()), this, SLOT(logColumnsChanged()));
+	connect(logTableModel, SIGNAL(logFramesAppended(int)), this, SLOT(logFramesAppended()));
+	logColumnsChanged();
+}
+
+void PlaybackBar::togglePlayback()
+{
+	if (isPlaying()) {
+		stopPlayback();
+		return;
+	}
+
+	if (logTableModel->rowCount() == 0 || lastPlayedRow() < firstPlayedRow())
+		return;
+
+	int row = currentRow;
+	if (row < firstPlayedRow() || row >= lastPlayedRow())
+		row = firstPlayedRow();
+	if (row != currentRow)
+		moveToRow(row);
+	rebase(rowTime(row));
+
+	updateTimerInterval();
+	timer.start();
+	playAct->setIcon(style()->standardIcon(QStyle::SP_MediaPause));
+	playAct->setText("Pause");
+}
+
+void PlaybackBar::stopPlayback()
+{
+	timer.stop();
+	playAct->setIcon(style()->standardIcon(QStyle::SP_MediaPlay));
+	playAct->setText("Play");
+}
+
+void PlaybackBar::stepForward()
+{
+	if (currentRow + 1 < logTableModel->rowCount())
+		sliderMoved(currentRow + 1);
+}
+
+void PlaybackBar::stepBackward()
+{
+	if (currentRow > 0)
+		sliderMoved(currentRow - 1);
+}
+
+void PlaybackBar::setCurrentRow(int row)
+{
+	if (row == currentRow)
+		return;
+
+	currentRow = row;
+	updatePosition();
+	if (isPlaying() && row != -1)
+		rebase(rowTime(row));
+}
+
+void PlaybackBar::setLoopRegion(int firstRow, int lastRow)
+{
+	loopFirstRow = firstRow;
+	loopLastRow = lastRow;
+}
+
+void PlaybackBar::tick()
+{
+	const GameTimeIndex &timeIndex = logTableModel->gameTimeIndex();
+	const int firstRow = firstPlayedRow();
+	const int lastRow = lastPlayedRow();
+	// The filter may have hidden every row that was left to play.
+	if (lastRow < firstRow) {
+		stopPlayback();
+		return;
+	}
+	const double startTime = rowTime(firstRow);
+	const double endTime = timeIndex.timeAt(logTableModel->physicsFrameIndex(lastRow) + 1);
+	const double time = elapsedGameTime();
+
+	if (time >= endTime) {
+		if (loopAct->isChecked() && endTime > startTime) {
+			rebase(startTime);
+			moveToRow(firstRow);
+		} else {
+			moveToRow(lastRow);
+			stopPlayback();
+		}
+		return;
+	}
+
+	// Only the row for the current time is shown, however many rows passed since the last tick.
+	const int phy = timeIndex.findPhysicsFrame(time);
+	const int row = std::min(std::max(timeIndex.physicsFrameRow(phy), firstRow), lastRow);
+	if (row != currentRow)
+		moveToRow(row);
+}
+
+void PlaybackBar::speedChanged()
+{
+	if (isPlaying())
+		rebase(elapsedGameTime());
+	speed = speedCombo->currentData().toDouble();
+}
+
+void PlaybackBar::loopToggled(bool checked)
+{
+	if (checked)
+		emit loopRegionRequested();
+	else
+		setLoopRegion(-1, -1);
+}
+
+void PlaybackBar::sliderMoved(int value)
+{
+	if (value == currentRow)
+		return;
+
+	moveToRow(value);
+	if (isPlaying())
+		rebase(rowTime(value));
+}
+
+void PlaybackBar::logColumnsAboutToChange()
+{
+	stopPlayback();
+}
+
+void PlaybackBar::logColumnsChanged()
+{
+	const int rowCount = logTableModel->rowCount();
+	currentRow = -1;
+	setLoopRegion(-1, -1);
+	loopAct->setChecked(false);
+
+	positionSlider->blockSignals(true);
+	positionSlider->setRange(0, std::max(0, rowCount - 1));
+	positionSlider->blockSignals(false);
+	updatePosition();
+
+	setEnabled(rowCount > 0);
+}
+
+// Playback and the loop region carry on over the appended rows.
+void PlaybackBar::logFramesAppended()
+{
+	const int rowCount = logTableModel->rowCount();
+	positionSlider->blockSignals(true);
+	positionSlider->setRange(0, std::max(0, rowCount - 1));
+	positionSlider->blockSignals(false);
+	updatePosition();
+
+	setEnabled(rowCount > 0);
+}
+
+void PlaybackBar::updateTimerInterval()
+{
+	// Widgets have no vertical blank callback, so the timer ticks at the refresh rate instead.
+	const QWindow *handle = window()->windowHandle();
+	const QScreen *screen = handle ? handle->screen() : QGuiApplication::primaryScreen();
+	const qreal refreshRate = screen ? screen->refreshRate() : 60;
+	timer.setInterval(std::max(1, qRound(1000 / std::max<qreal>(1, refreshRate))));
+}
+
+void PlaybackBar::updatePosition()
+{
+	positionSlider->blockSignals(true);
+	positionSlider->setValue(std::max(0, currentRow));
+	positionSlider->blockSignals(false);
+
+	if (currentRow == -1)
+		timeLabel->clear();
+	else
+		timeLabel->setText(QString("%1 s").arg(rowTime(currentRow), 0, 'f', 4));
+}
+
+void PlaybackBar::moveToRow(int row)
+{
+	currentRow = row;
+	updatePosition();
+	emit rowChanged(row);
+}
+
+void PlaybackBar::rebase(double time)
+{
+	baseTime = time;
+	wallClock.restart();
+}
+
+double PlaybackBar::rowTime(int row) const
+{
+	return logTableModel->gameTimeIndex().timeAt(logTableModel->physicsFrameIndex(row));
+}
+
+double PlaybackBar::elapsedGameTime() const
+{
+	return baseTime + wallClock.nsecsElapsed() * 1e-9 * speed;
+}
+
+int PlaybackBar::firstPlayedRow() const
+{
+	return loopAct->isChecked() && loopFirstRow != -1 ? loopFirstRow : 0;
+}
+
+// Hidden rows after the last visible one are not played, as the table would show that row
+// and move playback back to it.
+int PlaybackBar::lastPlayedRow() const
+{
+	const int lastRow = loopAct->isChecked() && loopLastRow != -1
+		? loopLastRow : logTableModel->rowCount() - 1;
+	return logProxyModel->lastVisibleSourceRow(lastRow);
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <QtWidgets>
+#include "logtablemodel.hpp"
+#include "logproxymodel.hpp"
+
+// Toolbar playing the log back in game time. A single timer ticking at the screen refresh rate
+// picks the row for the elapsed wall time, so the rows a slow redraw falls behind on are
+// skipped rather than queued. Rows hidden by the filter are skipped too, and playback ends at
+// the last visible row.
+class PlaybackBar : public QToolBar
+{
+	Q_OBJECT
+
+public:
+	PlaybackBar(QWidget *parent, const LogTableModel *model, const LogProxyModel *proxyModel);
+
+	inline bool isPlaying() const { return timer.isActive(); }
+
+signals:
+	void rowChanged(int row);
+	void loopRegionRequested();
+
+public slots:
+	void togglePlayback();
+	void stopPlayback();
+	void stepForward();
+	void stepBackward();
+	// Follows the current row of the log table. Playback continues from a row moved to by hand.
+	void setCurrentRow(int row);
+	void setLoopRegion(int firstRow, int lastRow);
+
+private slots:
+	void tick();
+	void speedChanged();
+	void loopToggled(bool checked);
+	void sliderMoved(int value);
+	void logColumnsAboutToChange();
+	void logColumnsChanged();
+	void logFramesAppended();
+
+private:
+	const LogTableModel *logTableModel;
+	const LogProxyModel *logProxyModel;
+
+	QAction *playAct;
+	QAction *stepBackwardAct;
+	QAction *stepForwardAct;
+	QComboBox *speedCombo;
+	QAction *loopAct;
+	QSlider *positionSlider;
+	QLabel *timeLabel;
+
+	QTimer timer;
+	QElapsedTimer wallClock;
+	// Game time at the wall clock start, advanced by the speed multiplier.
+	double baseTime = 0;
+	double speed = 1;
+	int currentRow = -1;
+	int loopFirstRow = -1;
+	int loopLastRow = -1;
+
+	void setupUi();
+	void updateTimerInterval();
+	void updatePosition();
+	void moveToRow(int row);
+	void rebase(double time);
+	double rowTime(int row) const;
+	double elapsedGameTime() const;
+	int firstPlayedRow() const;
+	int lastPlayedRow() const;
+};
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cmath>
 #include "playerplotwindow.hpp"
 #include "settings.hpp"
 
@@ -13,6 +15,20 @@ static const QPointF FrontViewPos(-CircleDistance, -CircleDistance);
 static const QPointF SideViewPos(CircleDistance, -CircleDistance);
 static const QPointF FictitiousViewPos(CircleDistance, CircleDistance);
 
+static const int MaxTrailLength = 1000;
+static const int MaxTrailAlpha = 200;
+
+// Adds the vector as drawn in the plan, front and side views.
+static void addVectorToPath(QPainterPath &path, const double line[3])
+{
+	path.moveTo(PlanViewPos);
+	path.lineTo(line[0] + PlanViewPos.x(), -line[1] + PlanViewPos.y());
+	path.moveTo(FrontViewPos);
+	path.lineTo(line[0] + FrontViewPos.x(), -line[2] + FrontViewPos.y());
+	path.moveTo(SideViewPos);
+	path.lineTo(line[1] + SideViewPos.x(), -line[2] + SideViewPos.y());
+}
+
 PlayerPlotWindow::PlayerPlotWindow(QWidget *parent, const LogTableModel *model)
 	: QWidget(parent), logTableModel(model)
 {
@@ -62,12 +78,116 @@ void PlayerPlotWindow::setupUi()
 	lay->addWidget(plotView, 0, 0);
 
 	plotScene = new QGraphicsScene(this);
+	// The vector items move on every frame, which would keep rebuilding a spatial index.
+	plotScene->setItemIndexMethod(QGraphicsScene::NoIndex);
 	plotView->setScene(plotScene);
 
 	drawAxes(PlanViewPos, "X", "Y", true);
 	drawAxes(FrontViewPos, "X", "Z", true);
 	drawAxes(SideViewPos, "Y", "Z", true);
 	drawAxes(FictitiousViewPos, "", "", false);
+
+	trailSpinBox = new QSpinBox(this);
+	trailSpinBox->setRange(0, MaxTrailLength);
+	trailSpinBox->setSpecialValueText("Off");
+	trailSpinBox->setSuffix(" frames");
+	trailSpinBox->setToolTip("Overlay the vectors of this many frames before and after, "
+		"fading with the distance");
+	QSettings settings;
+	trailSpinBox->setValue(settings.value(PlayerPlotTrailLengthKey, 0).toInt());
+	connect(trailSpinBox, SIGNAL(valueChanged(int)), this, SLOT(trailLengthChanged()));
+
+	QHBoxLayout *trailLayout = new QHBoxLayout;
+	trailLayout->addWidget(new QLabel("Ghost trail:", this));
+	trailLayout->addWidget(trailSpinBox);
+	trailLayout->addStretch(1);
+	lay->addLayout(trailLayout, 1, 0);
+
+	setupTrailItems();
+}
+
+void PlayerPlotWindow::setupTrailItems()
+{
+	const QColor colorList[TrailSeriesCount] = {
+		yawPen.color(), velocityPen.color(), collisionPen.color()
+	};
+
+	for (int series = 0; series < TrailSeriesCount; series++) {
+		for (int band = 0; band < TrailBandCount; band++) {
+			QColor color = colorList[series];
+			color.setAlpha(MaxTrailAlpha * (TrailBandCount - band) / (TrailBandCount + 1));
+			QPen pen(color);
+			pen.setCosmetic(true);
+
+			// Behind the vectors of the current frame.
+			trailItems[series][band] = plotScene->addPath(QPainterPath(), pen);
+			trailItems[series][band]->setZValue(-1);
+		}
+	}
+}
+
+void PlayerPlotWindow::trailLengthChanged()
+{
+	QSettings settings;
+	settings.setValue(PlayerPlotTrailLengthKey, trailSpinBox->value());
+	plotTrail(plottedRow);
+}
+
+// Builds one path per series and band from the log columns, so the cost of a trail of
+// hundreds of frames is a handful of path updates rather than thousands of items.
+void PlayerPlotWindow::plotTrail(int row)
+{
+	QPainterPath paths[TrailSeriesCount][TrailBandCount];
+	const int length = trailSpinBox->value();
+	if (row != -1 && length > 0) {
+		const LogColumns &columns = logTableModel->logColumns();
+		const int first = std::max(0, row - length);
+		const int last = std::min(columns.rowCount() - 1, row + length);
+		for (int r = first; r <= last; r++) {
+			const float yaw = columns.value(YawField, r);
+			if (r == row || std::isnan(yaw))
+				continue;
+			const int band = (std::abs(r - row) - 1) * TrailBandCount / length;
+
+			const double yawLine[3] = {
+				std::cos(yaw * M_PI / 180) * LineLength,
+				std::sin(yaw * M_PI / 180) * LineLength,
+				0
+			};
+			addVectorToPath(paths[YawTrail][band], yawLine);
+
+			const double velocity[3] = {
+				columns.value(VelocityXField, r),
+				columns.value(VelocityYField, r),
+				columns.value(VelocityZField, r)
+			};
+			const double speed = std::sqrt(velocity[0] * velocity[0]
+				+ velocity[1] * velocity[1] + velocity[2] * velocity[2]);
+			if (speed > 0) {
+				const double velocityLine[3] = {
+					velocity[0] * LineLength / speed,
+					velocity[1] * LineLength / speed,
+					velocity[2] * LineLength / speed
+				};
+				addVectorToPath(paths[VelocityTrail][band], velocityLine);
+			}
+
+			for (const TASLogger::ReaderCollision &col
+				: logTableModel->frameAt(r).cmdFrame->collisionList) {
+				const double normalLine[3] = {
+					col.normal[0] * LineLength,
+					col.normal[1] * LineLength,
+					col.normal[2] * LineLength
+				};
+				addVectorToPath(paths[CollisionTrail][band], normalLine);
+			}
+		}
+	}
+
+	for (int series = 0; series < TrailSeriesCount; series++) {
+		for (int band = 0; band < TrailBandCount; band++)
+			trailItems[series][band]->setPath(paths[series][band]);
+	}
 }
 
 void PlayerPlotWindow::closeEvent(QCloseEvent *event)
@@ -127,13 +247,16 @@ void PlayerPlotWindow::drawAxes(const QPointF &pos, const QString &xLabel,
 	group->setPos(pos);
 }
 
-void PlayerPlotWindow::clearPlot()
+PlayerPlotWindow::VectorItems &PlayerPlotWindow::acquireVectorItems()
 {
-	for (QGraphicsItem *item : plotItemList) {
-		plotScene->removeItem(item);
-		delete item;
+	if (usedVectorCount == vectorItemsList.size()) {
+		VectorItems items;
+		for (QGraphicsLineItem *&lineItem : items.lineItems)
+			lineItem = plotScene->addLine(QLineF());
+		items.arcItem = plotScene->addEllipse(QRectF());
+		vectorItemsList.append(items);
 	}
-	plotItemList.clear();
+	return vectorItemsList[usedVectorCount++];
 }
 
 void PlayerPlotWindow::drawLinesOnScenes(const double line[3],
@@ -145,45 +268,51 @@ void PlayerPlotWindow::drawLinesOnScenes(const double line[3],
 	const QPointF planFicPoint(FictitiousViewPos.x(), -line[1] + FictitiousViewPos.y());
 	const QPointF sideFicPoint(line[1] + FictitiousViewPos.x(), FictitiousViewPos.y());
 
-	QGraphicsLineItem *planLineItem = plotScene->addLine(QLineF(PlanViewPos, planPoint), pen);
-	QGraphicsLineItem *frontLineItem = plotScene->addLine(QLineF(FrontViewPos, frontPoint), pen);
-	QGraphicsLineItem *sideLineItem = plotScene->addLine(QLineF(SideViewPos, sidePoint), pen);
-
-	QGraphicsLineItem *pfLineItem = plotScene->addLine(QLineF(planPoint, frontPoint), lightPen);
-	QGraphicsLineItem *fsLineItem = plotScene->addLine(QLineF(frontPoint, sidePoint), lightPen);
-
-	QGraphicsLineItem *planImgLineItem = plotScene->addLine(
-		QLineF(planPoint, planFicPoint), lightPen);
-	QGraphicsLineItem *sideImgLineItem = plotScene->addLine(
-		QLineF(sidePoint, sideFicPoint), lightPen);
-	QGraphicsEllipseItem *imgArc = plotScene->addEllipse(
-		FictitiousViewPos.x() - line[1], FictitiousViewPos.y() - line[1],
-		line[1] * 2, line[1] * 2,
-		lightPen
-	);
-
-	plotItemList.append(planLineItem);
-	plotItemList.append(frontLineItem);
-	plotItemList.append(sideLineItem);
-	plotItemList.append(pfLineItem);
-	plotItemList.append(fsLineItem);
-	plotItemList.append(planImgLineItem);
-	plotItemList.append(sideImgLineItem);
-	plotItemList.append(imgArc);
+	const QLineF lineList[VectorLineCount] = {
+		QLineF(PlanViewPos, planPoint),
+		QLineF(FrontViewPos, frontPoint),
+		QLineF(SideViewPos, sidePoint),
+		QLineF(planPoint, frontPoint),
+		QLineF(frontPoint, sidePoint),
+		QLineF(planPoint, planFicPoint),
+		QLineF(sidePoint, sideFicPoint),
+	};
+
+	// The first three lines are the vector in the views, the rest are construction lines.
+	VectorItems &items = acquireVectorItems();
+	for (int i = 0; i < VectorLineCount; i++) {
+		items.lineItems[i]->setLine(lineList[i]);
+		items.lineItems[i]->setPen(i < 3 ? pen : lightPen);
+		items.lineItems[i]->setVisible(true);
+	}
+	items.arcItem->setRect(FictitiousViewPos.x() - line[1], FictitiousViewPos.y() - line[1],
+		line[1] * 2, line[1] * 2);
+	items.arcItem->setPen(lightPen);
+	items.arcItem->setVisible(true);
 }
 
+// Items are kept in a pool and updated in place, and those of the vectors a frame does not
+// have are hidden, so scrubbing through the rows allocates nothing.
 void PlayerPlotWindow::plotFrame(int row)
 {
-	clearPlot();
+	plottedRow = row;
+	plotTrail(row);
 
-	if (row == -1)
-		return;
+	usedVectorCount = 0;
+	if (row != -1)
+		plotVectors(logTableModel->frameAt(row));
 
-	TASLogger::ReaderPhysicsFrame phyFrame;
-	TASLogger::ReaderCommandFrame *cmdFrame;
-	TASLogger::ReaderPlayerState *pmState;
-	logTableModel->getFrameData(row, phyFrame, &cmdFrame, &pmState);
+	for (int i = usedVectorCount; i < vectorItemsList.size(); i++) {
+		for (QGraphicsLineItem *lineItem : vectorItemsList[i].lineItems)
+			lineItem->setVisible(false);
+		vectorItemsList[i].arcItem->setVisible(false);
+	}
+}
 
+void PlayerPlotWindow::plotVectors(const FrameRef &frame)
+{
+	const TASLogger::ReaderCommandFrame *cmdFrame = frame.cmdFrame;
+	const TASLogger::ReaderPlayerState *pmState = frame.pmState;
 	if (!cmdFrame)
 		return;
 
@@ -215,7 +344,7 @@ void PlayerPlotWindow::plotFrame(int row)
 		drawLinesOnScenes(line, velocityPen, velocityImagPen);
 	}
 
-	for (const TASLogger::ReaderDamage &dmg : phyFrame.damageList) {
+	for (const TASLogger::ReaderDamage &dmg : frame.phyFrame->damageList) {
 		if (dmg.direction[0] == 0.0 && dmg.direction[1] == 0.0 && dmg.direction[2] == 0.0)
 			continue;
 
@@ -4,6 +4,13 @@
 #include "logtablemodel.hpp"
 #include "playerplotview.hpp"
 
+enum TrailSeries {
+	YawTrail = 0,
+	VelocityTrail,
+	CollisionTrail,
+	TrailSeriesCount
+};
+
 class PlayerPlotWindow : public QWidget
 {
 	Q_OBJECT
@@ -11,6 +18,7 @@ class PlayerPlotWindow : public QWidget
 public:
 	PlayerPlotWindow(QWidget *parent, const LogTableModel *model);
 
+public slots:
 	void plotFrame(int row);
 
 signals:
@@ -21,6 +29,9 @@ protected:
 	void hideEvent(QHideEvent *event) override;
 	void showEvent(QShowEvent *event) override;
 
+private slots:
+	void trailLengthChanged();
+
 private:
 	const LogTableModel *logTableModel;
 
@@ -36,13 +47,32 @@ private:
 
 	PlayerPlotView *plotView;
 	QGraphicsScene *plotScene;
+	QSpinBox *trailSpinBox;
+	int plottedRow = -1;
+
+	static const int VectorLineCount = 7;
+
+	// Items drawing one vector in the three views and the construction lines between them.
+	struct VectorItems
+	{
+		QGraphicsLineItem *lineItems[VectorLineCount];
+		QGraphicsEllipseItem *arcItem;
+	};
+
+	QVector<VectorItems> vectorItemsList;
+	int usedVectorCount = 0;
 
-	QList<QGraphicsItem *> plotItemList;
+	// The ghost trail fades out in bands of frames, with one path item per series and band.
+	static const int TrailBandCount = 4;
+	QGraphicsPathItem *trailItems[TrailSeriesCount][TrailBandCount];
 
 	void setupUi();
 	void setupPens();
 	void drawAxes(const QPointF &pos, const QString &xLabel,
 		const QString &yLabel, bool drawCircle);
+	VectorItems &acquireVectorItems();
 	void drawLinesOnScenes(const double line[3], const QPen &pen, const QPen &lightPen);
-	void clearPlot();
+	void plotVectors(const FrameRef &frame);
+	void setupTrailItems();
+	void plotTrail(int row);
 };
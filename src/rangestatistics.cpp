@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "rangestatistics.hpp"
+
+static const float Infinity = std::numeric_limits<float>::infinity();
+
+void RangeSummary::merge(const RangeSummary &other)
+{
+	if (!other.count)
+		return;
+	if (!count) {
+		*this = other;
+		return;
+	}
+	count += other.count;
+	min = std::min(min, other.min);
+	max = std::max(max, other.max);
+	sum += other.sum;
+}
+
+void RangeStatistics::clear()
+{
+	logColumns = nullptr;
+	for (FieldTable &table : fieldTableList) {
+		table.blockSum.clear();
+		table.blockCount.clear();
+		table.minLevels.clear();
+		table.maxLevels.clear();
+	}
+}
+
+void RangeStatistics::build(const LogColumns &columns)
+{
+	clear();
+	logColumns = &columns;
+	for (int field = 0; field < LogFieldCount; field++)
+		buildField(field, 0);
+}
+
+void RangeStatistics::append()
+{
+	if (!logColumns)
+		return;
+	for (int field = 0; field < LogFieldCount; field++) {
+		const int summarizedBlocks = fieldTableList[field].blockSum.size() - 1;
+		buildField(field, std::max(0, summarizedBlocks - 1));
+	}
+}
+
+// Summarises the blocks from firstBlock on, and the extrema of every span covering them.
+void RangeStatistics::buildField(int field, int firstBlock)
+{
+	FieldTable &table = fieldTableList[field];
+	const float *values = logColumns->field(field);
+	const int rows = logColumns->rowCount();
+	const int blocks = (rows + BlockSize - 1) / BlockSize;
+
+	table.blockSum.resize(blocks + 1);
+	table.blockCount.resize(blocks + 1);
+	if (table.minLevels.isEmpty()) {
+		table.minLevels.resize(1);
+		table.maxLevels.resize(1);
+	}
+	table.minLevels[0].resize(blocks);
+	table.maxLevels[0].resize(blocks);
+
+	table.blockSum[0] = 0;
+	table.blockCount[0] = 0;
+	for (int b = firstBlock; b < blocks; b++) {
+		const int end = std::min(rows, (b + 1) * BlockSize);
+		double sum = 0;
+		int count = 0;
+		float min = Infinity;
+		float max = -Infinity;
+		for (int row = b * BlockSize; row < end; row++) {
+			const float v = values[row];
+			if (std::isnan(v))
+				continue;
+			sum += v;
+			++count;
+			min = std::min(min, v);
+			max = std::max(max, v);
+		}
+		table.blockSum[b + 1] = table.blockSum[b] + sum;
+		table.blockCount[b + 1] = table.blockCount[b] + count;
+		table.minLevels[0][b] = min;
+		table.maxLevels[0][b] = max;
+	}
+
+	for (int k = 1; (1 << k) <= blocks; k++) {
+		const int width = 1 << (k - 1);
+		const int size = blocks - (1 << k) + 1;
+		if (k == table.minLevels.size()) {
+			table.minLevels.append(QVector<float>());
+			table.maxLevels.append(QVector<float>());
+		}
+		QVector<float> &levelMin = table.minLevels[k];
+		QVector<float> &levelMax = table.maxLevels[k];
+		const QVector<float> &prevMin = table.minLevels.at(k - 1);
+		const QVector<float> &prevMax = table.maxLevels.at(k - 1);
+		levelMin.resize(size);
+		levelMax.resize(size);
+		for (int b = std::max(0, firstBlock - (1 << k) + 1); b < size; b++) {
+			levelMin[b] = std::min(prevMin[b], prevMin[b + width]);
+			levelMax[b] = std::max(prevMax[b], prevMax[b + width]);
+		}
+	}
+}
+
+void RangeStatistics::scan(int field, int first, int last, RangeSummary &summary) const
+{
+	const float *values = logColumns->field(field);
+	RangeSummary part;
+	part.min = Infinity;
+	part.max = -Infinity;
+	for (int row = first; row <= last; row++) {
+		const float v = values[row];
+		if (std::isnan(v))
+			continue;
+		part.sum += v;
+		++part.count;
+		part.min = std::min(part.min, v);
+		part.max = std::max(part.max, v);
+	}
+	summary.merge(part);
+}
+
+RangeSummary RangeStatistics::summarize(int field, int first, int last) const
+{
+	RangeSummary summary;
+	if (!logColumns || first > last)
+		return summary;
+
+	const int firstBlock = first / BlockSize;
+	const int lastBlock = last / BlockSize;
+	if (lastBlock - firstBlock <= 1) {
+		scan(field, first, last, summary);
+		return summary;
+	}
+
+	scan(field, first, (firstBlock + 1) * BlockSize - 1, summary);
+	scan(field, lastBlock * BlockSize, last, summary);
+
+	// Whole blocks in between.
+	const FieldTable &table = fieldTableList[field];
+	const int begin = firstBlock + 1;
+	const int end = lastBlock;
+	RangeSummary middle;
+	middle.count = table.blockCount[end] - table.blockCount[begin];
+	if (middle.count) {
+		int k = 0;
+		while ((2 << k) <= end - begin)
+			++k;
+		const QVector<float> &levelMin = table.minLevels[k];
+		const QVector<float> &levelMax = table.maxLevels[k];
+		middle.sum = table.blockSum[end] - table.blockSum[begin];
+		middle.min = std::min(levelMin[begin], levelMin[end - (1 << k)]);
+		middle.max = std::max(levelMax[begin], levelMax[end - (1 << k)]);
+		summary.merge(middle);
+	}
+
+	return summary;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <QtCore>
+#include "logcolumns.hpp"
+
+struct RangeSummary
+{
+	int count = 0;
+	float min = 0;
+	float max = 0;
+	double sum = 0;
+
+	inline double mean() const { return count ? sum / count : 0; }
+	void merge(const RangeSummary &other);
+};
+
+// Minimum, maximum, sum and count of every log field over arbitrary row ranges in constant
+// time. Rows are grouped into fixed blocks, each summarised once at load time: the sums
+// and counts of whole blocks are accumulated into prefix arrays, and their extrema into a
+// sparse table. A query scans at most two partial blocks at the ends of the range and
+// answers the whole blocks in between with two table lookups. NaN cells are skipped.
+class RangeStatistics
+{
+public:
+	static const int BlockSize = 256;
+
+	void build(const LogColumns &columns);
+	// Summarises the rows appended to the columns since the last build, starting over from
+	// the last block, which may have been partial.
+	void append();
+	void clear();
+
+	RangeSummary summarize(int field, int first, int last) const;
+
+private:
+	struct FieldTable
+	{
+		QVector<double> blockSum;
+		QVector<int> blockCount;
+		// minLevels[k][b] is the minimum over blocks [b, b + 2^k).
+		QVector<QVector<float>> minLevels;
+		QVector<QVector<float>> maxLevels;
+	};
+
+	const LogColumns *logColumns = nullptr;
+	FieldTable fieldTableList[LogFieldCount];
+
+	void buildField(int field, int firstBlock);
+	void scan(int field, int first, int last, RangeSummary &summary) const;
+};
@@ -0,0 +1,379 @@
+#include <algorithm>
+#include "rowfilter.hpp"
+
+static const int ChunkSize = 16384;
+
+// Values of the masks. A comparison with a blank cell is unknown, and so is its negation, so
+// that blank cells never match. && and || take the minimum and maximum of their operands.
+static const quint8 FalseMask = 0;
+static const quint8 UnknownMask = 1;
+static const quint8 TrueMask = 2;
+
+struct EventName
+{
+	const char *name;
+	EventType type;
+};
+
+static const EventName EventNameList[] = {
+	{"dmg", DamageEvent},
+	{"col", CollisionEvent},
+	{"obj", ObjectMoveEvent},
+	{"print", ConsolePrintEvent},
+	{"paused", PauseEvent},
+};
+
+static const QString EntityName = "ent";
+
+// Recursive descent parser appending the nodes of the predicate to the node list.
+class RowFilter::Parser
+{
+public:
+	Parser(const QString &text, QVector<Node> &nodeList)
+		: text(text), nodeList(nodeList)
+	{
+	}
+
+	int parse(QString *errorMessage)
+	{
+		int root = parseOr();
+		skipSpace();
+		if (root != -1 && pos < text.size())
+			root = fail(QString("Unexpected '%1'").arg(text.mid(pos, 10)));
+		if (root == -1 && errorMessage)
+			*errorMessage = error;
+		return root;
+	}
+
+private:
+	const QString &text;
+	QVector<Node> &nodeList;
+	int pos = 0;
+	QString error;
+
+	int fail(const QString &message)
+	{
+		if (error.isEmpty())
+			error = QString("%1 at column %2").arg(message).arg(pos + 1);
+		return -1;
+	}
+
+	void skipSpace()
+	{
+		while (pos < text.size() && text.at(pos).isSpace())
+			++pos;
+	}
+
+	bool accept(const char *token)
+	{
+		skipSpace();
+		const QLatin1String str(token);
+		if (!text.midRef(pos).startsWith(str))
+			return false;
+		pos += str.size();
+		return true;
+	}
+
+	int addNode(NodeKind kind, int left = -1, int right = -1)
+	{
+		Node node;
+		node.kind = kind;
+		node.field = -1;
+		node.op = EqualOp;
+		node.value = 0;
+		node.left = left;
+		node.right = right;
+		nodeList.append(node);
+		return nodeList.size() - 1;
+	}
+
+	int parseOr()
+	{
+		int left = parseAnd();
+		while (left != -1 && accept("||")) {
+			const int right = parseAnd();
+			if (right == -1)
+				return -1;
+			left = addNode(OrNode, left, right);
+		}
+		return left;
+	}
+
+	int parseAnd()
+	{
+		int left = parseUnary();
+		while (left != -1 && accept("&&")) {
+			const int right = parseUnary();
+			if (right == -1)
+				return -1;
+			left = addNode(AndNode, left, right);
+		}
+		return left;
+	}
+
+	int parseUnary()
+	{
+		if (accept("!")) {
+			const int operand = parseUnary();
+			if (operand == -1)
+				return -1;
+			return addNode(NotNode, operand);
+		}
+
+		if (accept("(")) {
+			const int inner = parseOr();
+			if (inner == -1)
+				return -1;
+			if (!accept(")"))
+				return fail("Expected ')'");
+			return inner;
+		}
+
+		return parseTerm();
+	}
+
+	bool parseCompareOp(CompareOp &op)
+	{
+		if (accept("<="))
+			op = LessEqualOp;
+		else if (accept(">="))
+			op = GreaterEqualOp;
+		else if (accept("=="))
+			op = EqualOp;
+		else if (accept("!="))
+			op = NotEqualOp;
+		else if (accept("<"))
+			op = LessOp;
+		else if (accept(">"))
+			op = GreaterOp;
+		else
+			return false;
+		return true;
+	}
+
+	bool parseNumber(float &value)
+	{
+		skipSpace();
+		const int start = pos;
+		if (pos < text.size() && (text.at(pos) == '-' || text.at(pos) == '+'))
+			++pos;
+		while (pos < text.size() && (text.at(pos).isDigit() || text.at(pos) == '.'))
+			++pos;
+		if (pos < text.size() && (text.at(pos) == 'e' || text.at(pos) == 'E')) {
+			++pos;
+			if (pos < text.size() && (text.at(pos) == '-' || text.at(pos) == '+'))
+				++pos;
+			while (pos < text.size() && text.at(pos).isDigit())
+				++pos;
+		}
+
+		bool ok = false;
+		value = text.mid(start, pos - start).toFloat(&ok);
+		if (!ok)
+			pos = start;
+		return ok;
+	}
+
+	int parseTerm()
+	{
+		skipSpace();
+		const int start = pos;
+		while (pos < text.size() && (text.at(pos).isLetterOrNumber() || text.at(pos) == '_'))
+			++pos;
+		const QString name = text.mid(start, pos - start);
+		if (name.isEmpty())
+			return fail("Expected a field name");
+
+		for (const EventName &event : EventNameList) {
+			if (name == QLatin1String(event.name)) {
+				const int node = addNode(EventNode);
+				nodeList[node].field = event.type;
+				return node;
+			}
+		}
+
+		const bool isEntity = name == EntityName;
+		const int field = isEntity ? -1 : findLogField(name);
+		if (!isEntity && field == -1) {
+			pos = start;
+			return fail(QString("Unknown field '%1'").arg(name));
+		}
+
+		CompareOp op;
+		if (!parseCompareOp(op)) {
+			if (isEntity)
+				return fail("Expected a comparison");
+			const int node = addNode(TruthNode);
+			nodeList[node].field = field;
+			return node;
+		}
+
+		float value;
+		if (!parseNumber(value))
+			return fail("Expected a number");
+
+		const int node = addNode(isEntity ? EntityNode : CompareNode);
+		nodeList[node].field = field;
+		nodeList[node].op = op;
+		nodeList[node].value = value;
+		return node;
+	}
+};
+
+bool RowFilter::compile(const QString &text, QString *errorMessage)
+{
+	nodeList.clear();
+	rootNode = -1;
+	if (text.trimmed().isEmpty())
+		return true;
+
+	Parser parser(text, nodeList);
+	rootNode = parser.parse(errorMessage);
+	if (rootNode == -1) {
+		nodeList.clear();
+		return false;
+	}
+	return true;
+}
+
+bool RowFilter::compare(CompareOp op, float a, float b)
+{
+	switch (op) {
+	case LessOp:
+		return a < b;
+	case LessEqualOp:
+		return a <= b;
+	case GreaterOp:
+		return a > b;
+	case GreaterEqualOp:
+		return a >= b;
+	case EqualOp:
+		return a == b;
+	case NotEqualOp:
+		return a != b;
+	}
+	return false;
+}
+
+void RowFilter::evaluateChunk(const RowFilterSource &source, int node, int first, int count,
+	QVector<QVector<quint8>> &maskList) const
+{
+	const Node &n = nodeList.at(node);
+	quint8 *out = maskList[node].data();
+
+	switch (n.kind) {
+	case CompareNode: {
+		const float *v = source.logColumns->field(n.field) + first;
+		const float c = n.value;
+		switch (n.op) {
+		case LessOp:
+			for (int i = 0; i < count; i++)
+				out[i] = (v[i] < c) * TrueMask + (v[i] != v[i]) * UnknownMask;
+			break;
+		case LessEqualOp:
+			for (int i = 0; i < count; i++)
+				out[i] = (v[i] <= c) * TrueMask + (v[i] != v[i]) * UnknownMask;
+			break;
+		case GreaterOp:
+			for (int i = 0; i < count; i++)
+				out[i] = (v[i] > c) * TrueMask + (v[i] != v[i]) * UnknownMask;
+			break;
+		case GreaterEqualOp:
+			for (int i = 0; i < count; i++)
+				out[i] = (v[i] >= c) * TrueMask + (v[i] != v[i]) * UnknownMask;
+			break;
+		case EqualOp:
+			for (int i = 0; i < count; i++)
+				out[i] = (v[i] == c) * TrueMask + (v[i] != v[i]) * UnknownMask;
+			break;
+		case NotEqualOp:
+			for (int i = 0; i < count; i++)
+				out[i] = ((v[i] != c) & (v[i] == v[i])) * TrueMask + (v[i] != v[i]) * UnknownMask;
+			break;
+		}
+		break;
+	}
+	case TruthNode: {
+		const float *v = source.logColumns->field(n.field) + first;
+		for (int i = 0; i < count; i++)
+			out[i] = ((v[i] != 0) & (v[i] == v[i])) * TrueMask + (v[i] != v[i]) * UnknownMask;
+		break;
+	}
+	case EventNode: {
+		std::fill(out, out + count, FalseMask);
+		const QVector<int> &rows = source.eventIndex->rows(n.field);
+		for (auto it = std::lower_bound(rows.cbegin(), rows.cend(), first);
+			it != rows.cend() && *it < first + count; ++it)
+			out[*it - first] = TrueMask;
+		break;
+	}
+	case EntityNode: {
+		std::fill(out, out + count, FalseMask);
+		const QVector<int> &rows = source.eventIndex->rows(CollisionEvent);
+		for (auto it = std::lower_bound(rows.cbegin(), rows.cend(), first);
+			it != rows.cend() && *it < first + count; ++it) {
+			const int phy = source.gameTimeIndex->findPhysicsFrameByRow(*it);
+			const int cmd = *it - source.gameTimeIndex->physicsFrameRow(phy);
+			const TASLogger::ReaderCommandFrame &cmdFrame =
+				source.tasLog->physicsFrameList[phy].commandFrameList[cmd];
+			for (const TASLogger::ReaderCollision &col : cmdFrame.collisionList) {
+				if (compare(n.op, col.entity, n.value)) {
+					out[*it - first] = TrueMask;
+					break;
+				}
+			}
+		}
+		break;
+	}
+	case NotNode: {
+		evaluateChunk(source, n.left, first, count, maskList);
+		const quint8 *a = maskList.at(n.left).constData();
+		for (int i = 0; i < count; i++)
+			out[i] = TrueMask - a[i];
+		break;
+	}
+	case AndNode:
+	case OrNode: {
+		evaluateChunk(source, n.left, first, count, maskList);
+		evaluateChunk(source, n.right, first, count, maskList);
+		const quint8 *a = maskList.at(n.left).constData();
+		const quint8 *b = maskList.at(n.right).constData();
+		if (n.kind == AndNode) {
+			for (int i = 0; i < count; i++)
+				out[i] = std::min(a[i], b[i]);
+		} else {
+			for (int i = 0; i < count; i++)
+				out[i] = std::max(a[i], b[i]);
+		}
+		break;
+	}
+	}
+}
+
+QVector<int> RowFilter::evaluate(const RowFilterSource &source, int firstRow,
+	const QAtomicInt *canceled) const
+{
+	QVector<int> rows;
+	if (rootNode == -1)
+		return rows;
+
+	QVector<QVector<quint8>> maskList(nodeList.size());
+	for (QVector<quint8> &mask : maskList)
+		mask.resize(ChunkSize);
+
+	const int rowCount = source.logColumns->rowCount();
+	for (int first = firstRow; first < rowCount; first += ChunkSize) {
+		if (canceled && canceled->load())
+			return QVector<int>();
+
+		const int count = std::min(ChunkSize, rowCount - first);
+		evaluateChunk(source, rootNode, first, count, maskList);
+		const quint8 *mask = maskList.at(rootNode).constData();
+		for (int i = 0; i < count; i++) {
+			if (mask[i] == TrueMask)
+				rows.append(first + i);
+		}
+	}
+
+	return rows;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <QtCore>
+#include "taslogger/reader.hpp"
+#include "logcolumns.hpp"
+#include "eventindex.hpp"
+#include "gametimeindex.hpp"
+
+// Everything a filter reads. The referenced data must stay unchanged while a filter runs.
+struct RowFilterSource
+{
+	const TASLogger::TASLog *tasLog;
+	const LogColumns *logColumns;
+	const EventIndex *eventIndex;
+	const GameTimeIndex *gameTimeIndex;
+};
+
+// Predicate over the rows of a log, such as "g && hspd > 320" or "ent == 57".
+//
+// A predicate combines comparisons of a field with a number (<, <=, >, >=, ==, !=) and bare
+// fields (true when non-zero) with !, && and || and parentheses. Field names are those of
+// LogFieldNameList. Events are tested with the names dmg, col, obj, print and paused, and
+// "ent" compares the entities the player collided with in the row. Blank cells never match,
+// negated or not.
+//
+// The predicate is compiled once into a tree, then evaluated over fixed-size chunks of rows,
+// each node producing a byte mask of the chunk. The comparisons are tight loops over the
+// field arrays, which the compiler turns into vector instructions.
+class RowFilter
+{
+public:
+	bool compile(const QString &text, QString *errorMessage);
+	inline bool isEmpty() const { return nodeList.isEmpty(); }
+
+	// Returns the rows from firstRow on matching the predicate in ascending order, or no rows
+	// if canceled is set before the evaluation finishes.
+	QVector<int> evaluate(const RowFilterSource &source, int firstRow = 0,
+		const QAtomicInt *canceled = nullptr) const;
+
+private:
+	enum NodeKind {
+		CompareNode,
+		TruthNode,
+		EventNode,
+		EntityNode,
+		NotNode,
+		AndNode,
+		OrNode,
+	};
+
+	enum CompareOp {
+		LessOp,
+		LessEqualOp,
+		GreaterOp,
+		GreaterEqualOp,
+		EqualOp,
+		NotEqualOp,
+	};
+
+	struct Node
+	{
+		NodeKind kind;
+		int field;
+		CompareOp op;
+		float value;
+		int left;
+		int right;
+	};
+
+	class Parser;
+
+	QVector<Node> nodeList;
+	int rootNode = -1;
+
+	void evaluateChunk(const RowFilterSource &source, int node, int first, int count,
+		QVector<QVector<quint8>> &maskList) const;
+	static bool compare(CompareOp op, float a, float b);
+};
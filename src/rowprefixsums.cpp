@@ -0,0 +1,98 @@
+#include <algorithm>
+#include <cmath>
+#include "rowprefixsums.hpp"
+#include "logcolumns.hpp"
+
+void RowPrefixSums::clear()
+{
+	travelledDistance.clear();
+	commandFrames.clear();
+	horizontalSpeed.clear();
+	collisions.clear();
+	damage.clear();
+	jumpPressed.clear();
+	duckPressed.clear();
+	hasLastPosition = false;
+	lastButtons = 0;
+}
+
+void RowPrefixSums::build(const TASLogger::TASLog &tasLog, bool prePlayerMove)
+{
+	clear();
+
+	int rows = 0;
+	for (const TASLogger::ReaderPhysicsFrame &phy : tasLog.physicsFrameList)
+		rows += std::max<int>(1, phy.commandFrameList.size());
+
+	travelledDistance.reserve(rows + 1);
+	commandFrames.reserve(rows + 1);
+	horizontalSpeed.reserve(rows + 1);
+	collisions.reserve(rows + 1);
+	damage.reserve(rows + 1);
+	jumpPressed.reserve(rows + 1);
+	duckPressed.reserve(rows + 1);
+
+	append(tasLog, 0, prePlayerMove);
+}
+
+void RowPrefixSums::append(const TASLogger::TASLog &tasLog, int firstFrame, bool prePlayerMove)
+{
+	if (commandFrames.isEmpty()) {
+		travelledDistance.append(0);
+		commandFrames.append(0);
+		horizontalSpeed.append(0);
+		collisions.append(0);
+		damage.append(0);
+		jumpPressed.append(0);
+		duckPressed.append(0);
+	}
+
+	for (size_t p = firstFrame; p < tasLog.physicsFrameList.size(); p++) {
+		const TASLogger::ReaderPhysicsFrame &phy = tasLog.physicsFrameList[p];
+		double frameDamage = 0;
+		for (const TASLogger::ReaderDamage &dmg : phy.damageList)
+			frameDamage += dmg.damage;
+
+		damage.append(damage.last() + frameDamage);
+
+		if (phy.commandFrameList.empty()) {
+			travelledDistance.append(travelledDistance.last());
+			commandFrames.append(commandFrames.last());
+			horizontalSpeed.append(horizontalSpeed.last());
+			collisions.append(collisions.last());
+			jumpPressed.append(jumpPressed.last());
+			duckPressed.append(duckPressed.last());
+			continue;
+		}
+
+		for (size_t i = 0; i < phy.commandFrameList.size(); i++) {
+			const TASLogger::ReaderCommandFrame &cmd = phy.commandFrameList[i];
+			const TASLogger::ReaderPlayerState &pm = prePlayerMove ? cmd.prePMState
+				: cmd.postPMState;
+
+			if (i > 0)
+				damage.append(damage.last());
+
+			double step = 0;
+			if (hasLastPosition) {
+				const double dx = pm.position[0] - lastPosition[0];
+				const double dy = pm.position[1] - lastPosition[1];
+				const double dz = pm.position[2] - lastPosition[2];
+				step = std::sqrt(dx * dx + dy * dy + dz * dz);
+			}
+			std::copy(pm.position, pm.position + 3, lastPosition);
+			hasLastPosition = true;
+
+			travelledDistance.append(travelledDistance.last() + step);
+			commandFrames.append(commandFrames.last() + 1);
+			horizontalSpeed.append(horizontalSpeed.last()
+				+ std::hypot(pm.velocity[0], pm.velocity[1]));
+			collisions.append(collisions.last() + cmd.collisionList.size());
+
+			const int pressed = cmd.buttons & ~lastButtons;
+			lastButtons = cmd.buttons;
+			jumpPressed.append(jumpPressed.last() + ((pressed & IN_JUMP) != 0));
+			duckPressed.append(duckPressed.last() + ((pressed & IN_DUCK) != 0));
+		}
+	}
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <QtCore>
+#include "taslogger/reader.hpp"
+
+// Cumulative per-row quantities of the log, so that any contiguous range of rows can be
+// aggregated in constant time. Element i holds the sum over rows [0, i), hence every
+// vector has one more element than there are rows. The distances and speeds are those of the
+// pre-PM or post-PM player states, as shown by the log columns. The game time of a range is
+// given by LogDocument::duration() from the game time index instead.
+class RowPrefixSums
+{
+public:
+	void build(const TASLogger::TASLog &tasLog, bool prePlayerMove);
+	// Extends the sums with the physics frames from firstFrame on, appended since the last
+	// build.
+	void append(const TASLogger::TASLog &tasLog, int firstFrame, bool prePlayerMove);
+	void clear();
+
+	inline int rowCount() const { return commandFrames.size() - 1; }
+
+	// Distance travelled from the first row to the last row.
+	inline double distance(int first, int last) const
+	{
+		return travelledDistance.at(last + 1) - travelledDistance.at(first + 1);
+	}
+
+	inline int commandFrameCount(int first, int last) const
+	{
+		return commandFrames.at(last + 1) - commandFrames.at(first);
+	}
+
+	inline double horizontalSpeedSum(int first, int last) const
+	{
+		return horizontalSpeed.at(last + 1) - horizontalSpeed.at(first);
+	}
+
+	inline int collisionCount(int first, int last) const
+	{
+		return collisions.at(last + 1) - collisions.at(first);
+	}
+
+	inline double damageTaken(int first, int last) const
+	{
+		return damage.at(last + 1) - damage.at(first);
+	}
+
+	// Number of rows in which the key goes down, i.e. it is held but was not held in the
+	// preceding command frame.
+	inline int jumpPresses(int first, int last) const
+	{
+		return jumpPressed.at(last + 1) - jumpPressed.at(first);
+	}
+
+	inline int duckPresses(int first, int last) const
+	{
+		return duckPressed.at(last + 1) - duckPressed.at(first);
+	}
+
+private:
+	QVector<double> travelledDistance;
+	QVector<int> commandFrames;
+	QVector<double> horizontalSpeed;
+	QVector<int> collisions;
+	QVector<double> damage;
+	QVector<int> jumpPressed;
+	QVector<int> duckPressed;
+
+	// State of the last command frame, carried over to the appended frames.
+	bool hasLastPosition = false;
+	float lastPosition[3];
+	int lastButtons = 0;
+};
@@ -0,0 +1,306 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "rowsorter.hpp"
+
+// Maps the float to an unsigned integer with the same order.
+static inline quint32 sortableBits(float value)
+{
+	quint32 bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	return bits & 0x80000000u ? ~bits : bits | 0x80000000u;
+}
+
+static inline quint64 sortableBits(double value)
+{
+	quint64 bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	return bits & 0x8000000000000000ull ? ~bits : bits | 0x8000000000000000ull;
+}
+
+// Least significant digit radix sort of the rows by their values, one byte per pass. The sort
+// is stable, so rows with equal values stay in log order, in the descending order too, whose
+// keys are complemented rather than the result reversed. Passes where every key has the same
+// byte are skipped, which is common for the high bytes.
+template<class Value, class Key>
+static QVector<int> radixSortRows(const Value *values, int count, bool descending,
+	int &valueCount)
+{
+	QVector<int> rows;
+	QVector<Key> keys;
+	rows.reserve(count);
+	keys.reserve(count);
+	QVector<int> blankRows;
+	for (int row = 0; row < count; row++) {
+		if (std::isnan(values[row])) {
+			blankRows.append(row);
+			continue;
+		}
+		rows.append(row);
+		keys.append(descending ? ~sortableBits(values[row]) : sortableBits(values[row]));
+	}
+	valueCount = rows.size();
+
+	QVector<int> rowBuffer(valueCount);
+	QVector<Key> keyBuffer(valueCount);
+	for (unsigned shift = 0; shift < sizeof(Key) * 8; shift += 8) {
+		int histogram[257] = {};
+		for (const Key key : keys)
+			++histogram[((key >> shift) & 0xff) + 1];
+		if (histogram[((keys.isEmpty() ? 0 : keys.first() >> shift) & 0xff) + 1] == valueCount)
+			continue;
+		for (int i = 1; i < 257; i++)
+			histogram[i] += histogram[i - 1];
+
+		for (int i = 0; i < valueCount; i++) {
+			const int dest = histogram[(keys.at(i) >> shift) & 0xff]++;
+			rowBuffer[dest] = rows.at(i);
+			keyBuffer[dest] = keys.at(i);
+		}
+		rows.swap(rowBuffer);
+		keys.swap(keyBuffer);
+	}
+
+	rows += blankRows;
+	return rows;
+}
+
+RowSorter::RowSorter(QObject *parent, const LogTableModel *model, LogProxyModel *proxyModel)
+	: QObject(parent), logTableModel(model), logProxyModel(proxyModel)
+{
+	connect(&sortWatcher, SIGNAL(finished()), this, SLOT(sortFinished()));
+
+	// Direct connection, as explained in LogProxyModel.
+	connect(logTableModel, SIGNAL(logColumnsAboutToChange()),
+		this, SLOT(logColumnsAboutToChange()), Qt::DirectConnection);
+	connect(logTableModel, SIGNAL(logColumnsChanged()), this, SLOT(logColumnsChanged()));
+	connect(logTableModel, SIGNAL(logFramesAppended(int)), this, SLOT(logFramesAppended(int)));
+	connect(logTableModel, SIGNAL(computedColumnChanged(int)),
+		this, SLOT(computedColumnChanged(int)));
+	connect(logTableModel, SIGNAL(columnsRemoved(const QModelIndex &, int, int)),
+		this, SLOT(computedColumnsRemoved()));
+}
+
+RowSorter::~RowSorter()
+{
+	stopSort();
+}
+
+void RowSorter::stopSort()
+{
+	++sortGeneration;
+	sortWatcher.waitForFinished();
+	sortReader.clear();
+}
+
+void RowSorter::sortByColumn(int column, Qt::SortOrder order)
+{
+	this->column = column;
+	this->order = order;
+	applySort();
+}
+
+void RowSorter::applySort()
+{
+	if (column == -1 || column >= logTableModel->columnCount()) {
+		stopSort();
+		column = -1;
+		logProxyModel->clearSortPermutation();
+		return;
+	}
+
+	if (!permutationCache.contains(column)) {
+		startSort();
+		return;
+	}
+
+	logProxyModel->setSortPermutation(cachedPermutation());
+}
+
+// Returns the cached permutation of the column in the order, which must be sorted already.
+QVector<int> RowSorter::cachedPermutation() const
+{
+	const Permutation &permutation = permutationCache.find(column).value();
+	return order == Qt::AscendingOrder ? permutation.ascendingRows : permutation.descendingRows;
+}
+
+void RowSorter::startSort()
+{
+	if (runningColumn == column && sortWatcher.isRunning())
+		return;
+
+	stopSort();
+	if (logTableModel->rowCount() == 0)
+		return;
+
+	// The values are snapshot here, as the worker must not use the model, whose row count
+	// lags behind the document while rows are inserted. A computed column is sorted once it
+	// has been evaluated.
+	const int rowCount = logTableModel->rowCount();
+	const ColumnDescriptor *descriptor = nullptr;
+	QVector<float> computedValues;
+	const int computedIndex = logTableModel->computedColumnIndex(column);
+	if (computedIndex != -1) {
+		const ComputedColumns &columns = logTableModel->computedColumns();
+		if (!columns.isReady(computedIndex))
+			return;
+		computedValues.resize(rowCount);
+		for (int row = 0; row < rowCount; row++)
+			computedValues[row] = columns.value(computedIndex, row);
+	} else
+		descriptor = &ColumnDescriptorList[column];
+
+	runningGeneration = sortGeneration;
+	runningColumn = column;
+	const LogDocument *document = &logTableModel->logDocument();
+	const DocumentReader reader = document->startReading();
+	sortReader = reader;
+	sortWatcher.setFuture(QtConcurrent::run([document, rowCount, descriptor, computedValues,
+		reader]() {
+		return computePermutation(document, rowCount, descriptor, computedValues);
+	}));
+}
+
+// Sorts the computed values, or the column of the descriptor if there is one.
+RowSorter::Permutation RowSorter::computePermutation(const LogDocument *document,
+	int rowCount, const ColumnDescriptor *descriptor, const QVector<float> &computedValues)
+{
+	Permutation permutation;
+	if (!descriptor) {
+		permutation.ascendingRows = radixSortRows<float, quint32>(computedValues.constData(),
+			rowCount, false, permutation.valueCount);
+		permutation.descendingRows = radixSortRows<float, quint32>(computedValues.constData(),
+			rowCount, true, permutation.valueCount);
+		return permutation;
+	}
+
+	if (descriptor->field != -1) {
+		const float *values = document->logColumns().field(descriptor->field);
+		permutation.ascendingRows = radixSortRows<float, quint32>(values, rowCount, false,
+			permutation.valueCount);
+		permutation.descendingRows = radixSortRows<float, quint32>(values, rowCount, true,
+			permutation.valueCount);
+		return permutation;
+	}
+
+	QVector<double> keys(rowCount);
+	for (int row = 0; row < rowCount; row++)
+		keys[row] = descriptor->sortKey(document->frameAt(row));
+	permutation.ascendingRows = radixSortRows<double, quint64>(keys.constData(), rowCount,
+		false, permutation.valueCount);
+	permutation.descendingRows = radixSortRows<double, quint64>(keys.constData(), rowCount,
+		true, permutation.valueCount);
+	return permutation;
+}
+
+void RowSorter::sortFinished()
+{
+	const int finishedColumn = runningColumn;
+	runningColumn = -1;
+	if (runningGeneration != sortGeneration)
+		return;
+	sortReader.clear();
+
+	const Permutation permutation = sortWatcher.result();
+	if (permutation.ascendingRows.size() != logTableModel->rowCount())
+		return;
+
+	permutationCache.insert(finishedColumn, permutation);
+	if (finishedColumn == column)
+		applySort();
+}
+
+void RowSorter::logColumnsAboutToChange()
+{
+	stopSort();
+	runningColumn = -1;
+}
+
+void RowSorter::logColumnsChanged()
+{
+	permutationCache.clear();
+	if (column != -1)
+		applySort();
+}
+
+// The appended rows are sorted among themselves and merged into the permutations of the sort
+// column, after the rows with equal values. The other columns are sorted again once they are
+// chosen.
+void RowSorter::logFramesAppended(int firstRow)
+{
+	Permutation permutation = permutationCache.value(column);
+	const bool cached = permutationCache.contains(column);
+	permutationCache.clear();
+	if (column == -1)
+		return;
+
+	const int computedIndex = logTableModel->computedColumnIndex(column);
+	if (!cached || permutation.ascendingRows.size() != firstRow || (computedIndex != -1
+		&& !logTableModel->computedColumns().isReady(computedIndex))) {
+		applySort();
+		return;
+	}
+
+	QVector<int> valueRows;
+	QVector<int> blankRows;
+	for (int row = firstRow; row < logTableModel->rowCount(); row++) {
+		if (std::isnan(sortValue(row)))
+			blankRows.append(row);
+		else
+			valueRows.append(row);
+	}
+
+	auto merge = [&](QVector<int> &rows, bool descending) {
+		auto before = [this, descending](int a, int b) {
+			const quint64 keyA = sortableBits(sortValue(a));
+			const quint64 keyB = sortableBits(sortValue(b));
+			return descending ? keyA > keyB : keyA < keyB;
+		};
+		QVector<int> newRows = valueRows;
+		std::stable_sort(newRows.begin(), newRows.end(), before);
+
+		QVector<int> merged(rows.size() + newRows.size() + blankRows.size());
+		const auto valueEnd = rows.cbegin() + permutation.valueCount;
+		auto out = std::merge(rows.cbegin(), valueEnd, newRows.cbegin(), newRows.cend(),
+			merged.begin(), before);
+		out = std::copy(valueEnd, rows.cend(), out);
+		std::copy(blankRows.cbegin(), blankRows.cend(), out);
+		rows = merged;
+	};
+	merge(permutation.ascendingRows, false);
+	merge(permutation.descendingRows, true);
+	permutation.valueCount += valueRows.size();
+
+	permutationCache.insert(column, permutation);
+	logProxyModel->extendSortPermutation(cachedPermutation());
+}
+
+// Returns the value the row is sorted by in the sort column, as the permutations order it.
+double RowSorter::sortValue(int row) const
+{
+	const int computedIndex = logTableModel->computedColumnIndex(column);
+	if (computedIndex != -1)
+		return logTableModel->computedColumns().value(computedIndex, row);
+
+	const ColumnDescriptor &descriptor = ColumnDescriptorList[column];
+	if (descriptor.field != -1)
+		return logTableModel->logColumns().field(descriptor.field)[row];
+	return descriptor.sortKey(logTableModel->frameAt(row));
+}
+
+void RowSorter::computedColumnChanged(int column)
+{
+	permutationCache.remove(column);
+	if (column == this->column)
+		applySort();
+}
+
+// Removing a computed column shifts the ones after it, so their permutations are dropped and
+// sorting by a computed column is given up.
+void RowSorter::computedColumnsRemoved()
+{
+	for (int c = HorizontalHeaderCount; c <= logTableModel->columnCount(); c++)
+		permutationCache.remove(c);
+	if (logTableModel->computedColumnIndex(column) != -1)
+		sortByColumn(-1, order);
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <QtCore>
+#include <QtConcurrent>
+#include "logtablemodel.hpp"
+#include "logproxymodel.hpp"
+
+// Sorts the rows of the log table by a column and hands the permutation to the proxy model.
+//
+// The permutation is computed on a worker thread with a radix sort over the raw values of the
+// column: the LogColumns field, the values of a computed column, or the sort key of the
+// column descriptor. Rows with blank cells come last in both directions, and rows with equal
+// values stay in log order. Both directions are sorted at once and cached per column until
+// the values change, so sorting by a column again or flipping the order is instant. Rows
+// appended to a followed log are merged into both permutations of the column shown.
+class RowSorter : public QObject
+{
+	Q_OBJECT
+
+public:
+	RowSorter(QObject *parent, const LogTableModel *model, LogProxyModel *proxyModel);
+	~RowSorter();
+
+	// Waits for a running sort and drops its result.
+	void stopSort();
+
+	inline int sortColumn() const { return column; }
+
+public slots:
+	// Sorts by the column, or restores the log order if the column is -1.
+	void sortByColumn(int column, Qt::SortOrder order);
+
+private slots:
+	void logColumnsAboutToChange();
+	void logColumnsChanged();
+	void logFramesAppended(int firstRow);
+	void computedColumnChanged(int column);
+	void computedColumnsRemoved();
+	void sortFinished();
+
+private:
+	struct Permutation
+	{
+		QVector<int> ascendingRows;
+		QVector<int> descendingRows;
+		// Number of rows with a value, which precede the blank rows.
+		int valueCount = 0;
+	};
+
+	const LogTableModel *logTableModel;
+	LogProxyModel *logProxyModel;
+
+	int column = -1;
+	Qt::SortOrder order = Qt::AscendingOrder;
+
+	QHash<int, Permutation> permutationCache;
+
+	QFutureWatcher<Permutation> sortWatcher;
+	DocumentReader sortReader;
+	int sortGeneration = 0;
+	int runningGeneration = 0;
+	int runningColumn = -1;
+
+	void applySort();
+	void startSort();
+	QVector<int> cachedPermutation() const;
+	double sortValue(int row) const;
+
+	static Permutation computePermutation(const LogDocument *document, int rowCount,
+		const ColumnDescriptor *descriptor, const QVector<float> &computedValues);
+};
@@ -0,0 +1,95 @@
+#include <algorithm>
+#include "rowupdatescheduler.hpp"
+
+RowUpdateScheduler::RowUpdateScheduler(QObject *parent)
+	: QObject(parent)
+{
+	timer.setSingleShot(true);
+	timer.setTimerType(Qt::PreciseTimer);
+	connect(&timer, SIGNAL(timeout()), this, SLOT(runNextTarget()));
+	frameTimer.start();
+}
+
+void RowUpdateScheduler::addTarget(QObject *receiver, const char *member)
+{
+	targetList.append({receiver, member, -1});
+	receiver->installEventFilter(this);
+}
+
+bool RowUpdateScheduler::eventFilter(QObject *watched, QEvent *event)
+{
+	if (event->type() != QEvent::Show)
+		return false;
+
+	for (Target &target : targetList) {
+		if (target.receiver != watched || target.row == latestRow)
+			continue;
+		// Queued, so that the widget is laid out before it is updated.
+		target.row = latestRow;
+		QMetaObject::invokeMethod(target.receiver, target.member.constData(),
+			Qt::QueuedConnection, Q_ARG(int, latestRow));
+	}
+	return false;
+}
+
+void RowUpdateScheduler::scheduleRow(int row)
+{
+	latestRow = row;
+	if (visitedTargets > 0 && row == runningRow) {
+		rowPending = false;
+		return;
+	}
+
+	pendingRow = row;
+	rowPending = true;
+
+	// Drop the rest of a stale row, whose targets the new row updates first.
+	if (visitedTargets > 0) {
+		firstTarget = (firstTarget + visitedTargets) % targetList.size();
+		visitedTargets = 0;
+		timer.stop();
+	}
+
+	if (!timer.isActive())
+		timer.start(std::max<qint64>(0, frameInterval() - frameTimer.elapsed()));
+}
+
+void RowUpdateScheduler::runNextTarget()
+{
+	if (visitedTargets == 0) {
+		if (!rowPending)
+			return;
+		runningRow = pendingRow;
+		rowPending = false;
+		frameTimer.restart();
+	}
+
+	while (visitedTargets < targetList.size()) {
+		const int index = (firstTarget + visitedTargets++) % targetList.size();
+		Target &target = targetList[index];
+		const QWidget *widget = qobject_cast<const QWidget *>(target.receiver.data());
+		if (!target.receiver || (widget && !widget->isVisible()))
+			continue;
+
+		target.row = runningRow;
+		QMetaObject::invokeMethod(target.receiver, target.member.constData(),
+			Qt::DirectConnection, Q_ARG(int, runningRow));
+		break;
+	}
+
+	if (visitedTargets < targetList.size()) {
+		timer.start(0);
+		return;
+	}
+
+	visitedTargets = 0;
+	if (rowPending)
+		scheduleRow(pendingRow);
+}
+
+int RowUpdateScheduler::frameInterval() const
+{
+	const QScreen *screen = QGuiApplication::primaryScreen();
+	const qreal refreshRate = screen ? screen->refreshRate() : 60;
+	return qRound(1000 / std::max<qreal>(1, refreshRate));
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <QtWidgets>
+
+// Coalesces current row changes for the tool windows. Each target is updated in its own pass
+// of the event loop, so input arriving meanwhile replaces the pending row and the remaining
+// targets of a stale row are skipped. The new row starts with those targets, so that every
+// target keeps being updated under continuous input. A row is started at most once per screen
+// frame.
+class RowUpdateScheduler : public QObject
+{
+	Q_OBJECT
+
+public:
+	RowUpdateScheduler(QObject *parent);
+
+	// Adds a target updated by invoking the slot with the row, e.g. "plotFrame". Hidden
+	// widgets, such as closed docks or docks in a background tab, are skipped and updated
+	// once they are shown.
+	void addTarget(QObject *receiver, const char *member);
+
+protected:
+	bool eventFilter(QObject *watched, QEvent *event) override;
+
+public slots:
+	void scheduleRow(int row);
+
+private slots:
+	void runNextTarget();
+
+private:
+	struct Target
+	{
+		QPointer<QObject> receiver;
+		QByteArray member;
+		// Row the target was last updated with.
+		int row;
+	};
+
+	QVector<Target> targetList;
+	QTimer timer;
+	QElapsedTimer frameTimer;
+	// Row of the last change, which shown targets catch up with.
+	int latestRow = -1;
+	int pendingRow = -1;
+	int runningRow = -1;
+	// Target the updates of runningRow started with, and the number of targets visited since,
+	// which is 0 when no row is in progress.
+	int firstTarget = 0;
+	int visitedTargets = 0;
+	bool rowPending = false;
+
+	int frameInterval() const;
+};
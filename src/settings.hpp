@@ -4,7 +4,15 @@ const QString MainWindowGeometryKey = "mainWindowGeometry";
 const QString FrameInspectorGeometryKey = "frameInspectorGeometry";
 const QString LogTableHorizontalHeaderStateKey = "logTableHorizontalHeaderState";
 const QString PlayerPlotGeometryKey = "playerPlotGeometry";
+const QString PlayerPlotTrailLengthKey = "playerPlotTrailLength";
+const QString TrajectoryGeometryKey = "trajectoryGeometry";
 const QString LastOpenDirectoryKey = "lastOpenDirectory";
+const QString LastExportDirectoryKey = "lastExportDirectory";
+const QString ExportColumnsKey = "exportColumns";
+const QString ExportFormatKey = "exportFormat";
 const QString RecentFilesKey = "recentFiles";
+const QString ComputedColumnsKey = "computedColumns";
+const QString ComputedColumnNameKey = "name";
+const QString ComputedColumnExpressionKey = "expression";
 
 const int MaxRecentFiles = 10;
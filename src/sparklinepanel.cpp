@@ -0,0 +1,147 @@
+#include <algorithm>
+#include <cmath>
+#include "sparklinepanel.hpp"
+
+// Rows shown on each side of the current one.
+static const int ContextRows = 64;
+static const int LineHeight = 22;
+static const int LabelWidth = 40;
+static const int ValueWidth = 70;
+static const int Margin = 3;
+
+static const int SparklineFieldList[] = {
+	HorizontalSpeedField, VelocityZField, PositionZField, YawField, HealthField
+};
+static const char *SparklineNameList[] = {"hspd", "vspd", "z", "yaw", "hp"};
+static const int SparklineCount = sizeof(SparklineFieldList) / sizeof(SparklineFieldList[0]);
+
+SparklinePanel::SparklinePanel(QWidget *parent, const LogTableModel *model)
+	: QWidget(parent), logTableModel(model)
+{
+	setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Fixed);
+	pointList.reserve(2 * ContextRows + 1);
+}
+
+QSize SparklinePanel::sizeHint() const
+{
+	return QSize(LabelWidth + ValueWidth + 4 * ContextRows, SparklineCount * LineHeight);
+}
+
+void SparklinePanel::setCurrentRow(int row)
+{
+	if (row >= logTableModel->logColumns().rowCount())
+		row = -1;
+	currentRow = row;
+	renderPixmap();
+	update();
+}
+
+void SparklinePanel::paintEvent(QPaintEvent *)
+{
+	QPainter painter(this);
+	painter.drawPixmap(0, 0, pixmap);
+}
+
+void SparklinePanel::resizeEvent(QResizeEvent *)
+{
+	renderPixmap();
+}
+
+void SparklinePanel::renderPixmap()
+{
+	const QSize pixmapSize = size() * devicePixelRatioF();
+	if (pixmap.size() != pixmapSize) {
+		pixmap = QPixmap(pixmapSize);
+		pixmap.setDevicePixelRatio(devicePixelRatioF());
+	}
+	pixmap.fill(palette().color(QPalette::Base));
+
+	QPainter painter(&pixmap);
+	painter.setPen(palette().color(QPalette::Text));
+	for (int i = 0; i < SparklineCount; i++) {
+		const QRect labelRect(Margin, i * LineHeight, LabelWidth - Margin, LineHeight);
+		painter.drawText(labelRect, Qt::AlignLeft | Qt::AlignVCenter, SparklineNameList[i]);
+	}
+
+	if (currentRow == -1)
+		return;
+
+	const double centerX = LabelWidth + (width() - LabelWidth - ValueWidth) / 2.0;
+	painter.setPen(QPen(palette().color(QPalette::Mid), 0, Qt::DashLine));
+	painter.drawLine(QLineF(centerX, 0, centerX, height()));
+
+	painter.setRenderHint(QPainter::Antialiasing);
+	for (int i = 0; i < SparklineCount; i++)
+		drawSparkline(painter, i, SparklineFieldList[i]);
+}
+
+void SparklinePanel::drawSparkline(QPainter &painter, int line, int field)
+{
+	const LogColumns &columns = logTableModel->logColumns();
+	const int firstRow = std::max(0, currentRow - ContextRows);
+	const int lastRow = std::min(columns.rowCount() - 1, currentRow + ContextRows);
+	const float *values = columns.field(field);
+
+	// Yaw is unwrapped across the window, so crossing +-180 does not draw a spike.
+	const bool unwrap = field == YawField;
+	float offset = 0;
+	float previous = NAN;
+	float minValue = INFINITY;
+	float maxValue = -INFINITY;
+	pointList.clear();
+	for (int row = firstRow; row <= lastRow; row++) {
+		float value = values[row];
+		if (unwrap && !std::isnan(value)) {
+			if (!std::isnan(previous)) {
+				const float delta = value + offset - previous;
+				offset -= 360 * std::round(delta / 360);
+			}
+			value += offset;
+			previous = value;
+		}
+		if (!std::isnan(value)) {
+			minValue = std::min(minValue, value);
+			maxValue = std::max(maxValue, value);
+		}
+		pointList.append(QPointF(row - currentRow, value));
+	}
+
+	const float current = values[currentRow];
+	const QRectF valueRect(width() - ValueWidth, line * LineHeight,
+		ValueWidth - Margin, LineHeight);
+	painter.setPen(palette().color(QPalette::Text));
+	painter.drawText(valueRect, Qt::AlignRight | Qt::AlignVCenter,
+		std::isnan(current) ? QStringLiteral("N/A") : QString::number(current));
+
+	if (minValue > maxValue)
+		return;
+
+	// Map the row offsets and values onto the line in place, flat lines in the middle.
+	const double plotWidth = width() - LabelWidth - ValueWidth;
+	const double centerX = LabelWidth + plotWidth / 2;
+	const double xScale = plotWidth / (2 * ContextRows + 1);
+	const double top = line * LineHeight + Margin;
+	const double plotHeight = LineHeight - 2 * Margin;
+	const double range = maxValue - minValue;
+	for (QPointF &point : pointList) {
+		point.setX(centerX + point.x() * xScale);
+		if (!std::isnan(point.y()))
+			point.setY(top + (range > 0 ? (maxValue - point.y()) / range : 0.5) * plotHeight);
+	}
+
+	// Rows without the field break the line.
+	painter.setPen(QPen(palette().color(QPalette::Highlight), 0));
+	int start = 0;
+	while (start < pointList.size()) {
+		while (start < pointList.size() && std::isnan(pointList.at(start).y()))
+			start++;
+		int end = start;
+		while (end < pointList.size() && !std::isnan(pointList.at(end).y()))
+			end++;
+		if (end - start == 1)
+			painter.drawPoint(pointList.at(start));
+		else if (end > start)
+			painter.drawPolyline(pointList.constData() + start, end - start);
+		start = end;
+	}
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <QtWidgets>
+#include "logtablemodel.hpp"
+
+// Sparklines of a few fields over the rows around the inspected one, read straight from the
+// log columns and drawn into a pixmap kept across rows.
+class SparklinePanel : public QWidget
+{
+	Q_OBJECT
+
+public:
+	SparklinePanel(QWidget *parent, const LogTableModel *model);
+
+	void setCurrentRow(int row);
+
+	QSize sizeHint() const override;
+
+protected:
+	void paintEvent(QPaintEvent *event) override;
+	void resizeEvent(QResizeEvent *event) override;
+
+private:
+	const LogTableModel *logTableModel;
+	int currentRow = -1;
+
+	QPixmap pixmap;
+	QVector<QPointF> pointList;
+
+	void renderPixmap();
+	void drawSparkline(QPainter &painter, int line, int field);
+};
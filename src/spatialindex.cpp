@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "spatialindex.hpp"
+
+// The tree is built again once the appended rows outnumber a fraction of its nodes, so the
+// rebuilds cost little per appended row.
+static const int TailFraction = 8;
+static const int MinTailSize = 4096;
+
+void SpatialIndex::clear()
+{
+	nodeRows.clear();
+	nodePoints.clear();
+	tailRows.clear();
+	tailPoints.clear();
+}
+
+void SpatialIndex::build(const LogColumns &columns)
+{
+	clear();
+
+	const float *const fields[3] = {
+		columns.field(PositionXField),
+		columns.field(PositionYField),
+		columns.field(PositionZField),
+	};
+
+	QVector<int> rows;
+	rows.reserve(columns.rowCount());
+	for (int row = 0; row < columns.rowCount(); row++) {
+		if (!std::isnan(fields[0][row]))
+			rows.append(row);
+	}
+
+	buildRange(rows, fields, 0, rows.size(), 0);
+
+	nodeRows = rows;
+	nodePoints.resize(rows.size() * 3);
+	for (int node = 0; node < rows.size(); node++) {
+		for (int axis = 0; axis < 3; axis++)
+			nodePoints[node * 3 + axis] = fields[axis][rows.at(node)];
+	}
+}
+
+void SpatialIndex::append(const LogColumns &columns, int firstRow)
+{
+	const float *const fields[3] = {
+		columns.field(PositionXField),
+		columns.field(PositionYField),
+		columns.field(PositionZField),
+	};
+	for (int row = firstRow; row < columns.rowCount(); row++) {
+		if (std::isnan(fields[0][row]))
+			continue;
+		tailRows.append(row);
+		for (int axis = 0; axis < 3; axis++)
+			tailPoints.append(fields[axis][row]);
+	}
+
+	if (tailRows.size() > std::max(MinTailSize, nodeRows.size() / TailFraction))
+		build(columns);
+}
+
+// Arranges rows[first, last) so that the median by the axis of the depth sits in the middle,
+// then arranges both halves the same way.
+void SpatialIndex::buildRange(QVector<int> &rows, const float *const fields[3], int first,
+	int last, int depth)
+{
+	if (last - first <= 1)
+		return;
+
+	const float *values = fields[depth % 3];
+	const int mid = (first + last) / 2;
+	std::nth_element(rows.begin() + first, rows.begin() + mid, rows.begin() + last,
+		[values](int a, int b) { return values[a] < values[b]; });
+
+	buildRange(rows, fields, first, mid, depth + 1);
+	buildRange(rows, fields, mid + 1, last, depth + 1);
+}
+
+float SpatialIndex::distanceSquared(const float *p, const float point[3], int axisMask)
+{
+	float sum = 0;
+	for (int axis = 0; axis < 3; axis++) {
+		if (axisMask & (1 << axis)) {
+			const float d = p[axis] - point[axis];
+			sum += d * d;
+		}
+	}
+	return sum;
+}
+
+void SpatialIndex::findNearestInRange(NearestState &state, int first, int last,
+	int depth) const
+{
+	if (first >= last)
+		return;
+
+	const int mid = (first + last) / 2;
+	const float distance = distanceSquared(nodePoints.constData() + mid * 3, state.point,
+		state.axisMask);
+	if (distance < state.bestDistance) {
+		state.bestDistance = distance;
+		state.bestNode = mid;
+	}
+
+	const int axis = depth % 3;
+	if (!(state.axisMask & (1 << axis))) {
+		findNearestInRange(state, first, mid, depth + 1);
+		findNearestInRange(state, mid + 1, last, depth + 1);
+		return;
+	}
+
+	// The near half first, so the far half can usually be skipped.
+	const float delta = state.point[axis] - nodePoints.at(mid * 3 + axis);
+	if (delta < 0) {
+		findNearestInRange(state, first, mid, depth + 1);
+		if (delta * delta < state.bestDistance)
+			findNearestInRange(state, mid + 1, last, depth + 1);
+	} else {
+		findNearestInRange(state, mid + 1, last, depth + 1);
+		if (delta * delta < state.bestDistance)
+			findNearestInRange(state, first, mid, depth + 1);
+	}
+}
+
+int SpatialIndex::findNearest(const float point[3], int axisMask) const
+{
+	if (isEmpty())
+		return -1;
+
+	NearestState state;
+	state.point = point;
+	state.axisMask = axisMask;
+	state.bestNode = -1;
+	state.bestDistance = std::numeric_limits<float>::infinity();
+	findNearestInRange(state, 0, nodeRows.size(), 0);
+	int bestRow = state.bestNode != -1 ? nodeRows.at(state.bestNode) : -1;
+
+	for (int i = 0; i < tailRows.size(); i++) {
+		const float distance = distanceSquared(tailPoints.constData() + i * 3, point, axisMask);
+		if (distance < state.bestDistance) {
+			state.bestDistance = distance;
+			bestRow = tailRows.at(i);
+		}
+	}
+	return bestRow;
+}
+
+void SpatialIndex::findWithinRadiusInRange(const float point[3], float radiusSquared,
+	int axisMask, QVector<int> &rows, int first, int last, int depth) const
+{
+	if (first >= last)
+		return;
+
+	const int mid = (first + last) / 2;
+	if (distanceSquared(nodePoints.constData() + mid * 3, point, axisMask) <= radiusSquared)
+		rows.append(nodeRows.at(mid));
+
+	const int axis = depth % 3;
+	const float delta = axisMask & (1 << axis) ? point[axis] - nodePoints.at(mid * 3 + axis) : 0;
+	if (delta <= 0 || delta * delta <= radiusSquared)
+		findWithinRadiusInRange(point, radiusSquared, axisMask, rows, first, mid, depth + 1);
+	if (delta >= 0 || delta * delta <= radiusSquared)
+		findWithinRadiusInRange(point, radiusSquared, axisMask, rows, mid + 1, last, depth + 1);
+}
+
+QVector<int> SpatialIndex::findWithinRadius(const float point[3], float radius,
+	int axisMask) const
+{
+	QVector<int> rows;
+	const float radiusSquared = radius * radius;
+	findWithinRadiusInRange(point, radiusSquared, axisMask, rows, 0, nodeRows.size(), 0);
+	for (int i = 0; i < tailRows.size(); i++) {
+		if (distanceSquared(tailPoints.constData() + i * 3, point, axisMask) <= radiusSquared)
+			rows.append(tailRows.at(i));
+	}
+	std::sort(rows.begin(), rows.end());
+	return rows;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QtCore>
+#include "logcolumns.hpp"
+
+// Static k-d tree over the player positions of the rows with a command frame.
+//
+// The tree is implicit: the nodes are stored in one array, where the node of a range is its
+// median and the halves before and after it are the subtrees. The split axis cycles through
+// x, y and z with the depth. Queries measure distances along a subset of the axes, such as
+// x and y for the top-down view, descending into both halves of the levels split on the
+// other axes.
+//
+// Rows appended to a followed log are kept in a short list searched linearly besides the tree,
+// and the tree is built again once the list grows to a fraction of its size.
+class SpatialIndex
+{
+public:
+	enum Axis {
+		XAxis = 1,
+		YAxis = 2,
+		ZAxis = 4,
+		AllAxes = XAxis | YAxis | ZAxis,
+	};
+
+	void build(const LogColumns &columns);
+	// Adds the rows from firstRow on, appended to the columns since the last build.
+	void append(const LogColumns &columns, int firstRow);
+	void clear();
+
+	inline bool isEmpty() const { return nodeRows.isEmpty() && tailRows.isEmpty(); }
+
+	// Returns the row whose position is nearest to the point, or -1 if there is none.
+	int findNearest(const float point[3], int axisMask = AllAxes) const;
+
+	// Returns the rows whose positions lie within the radius of the point, in ascending order.
+	QVector<int> findWithinRadius(const float point[3], float radius,
+		int axisMask = AllAxes) const;
+
+private:
+	QVector<int> nodeRows;
+	// Positions of the nodes, three floats each.
+	QVector<float> nodePoints;
+	// Appended rows not in the tree yet, and their positions.
+	QVector<int> tailRows;
+	QVector<float> tailPoints;
+
+	struct NearestState
+	{
+		const float *point;
+		int axisMask;
+		int bestNode;
+		float bestDistance;
+	};
+
+	void buildRange(QVector<int> &rows, const float *const fields[3], int first, int last,
+		int depth);
+	void findNearestInRange(NearestState &state, int first, int last, int depth) const;
+	void findWithinRadiusInRange(const float point[3], float radiusSquared, int axisMask,
+		QVector<int> &rows, int first, int last, int depth) const;
+	static float distanceSquared(const float *p, const float point[3], int axisMask);
+};
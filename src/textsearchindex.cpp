@@ -0,0 +1,306 @@
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include "textsearchindex.hpp"
+
+static const int CancelCheckInterval = 1024;
+
+static inline char foldChar(char c)
+{
+	return c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c;
+}
+
+// Only ASCII is folded, since folding bytes of UTF-8 sequences would corrupt them.
+static QByteArray foldCase(const QByteArray &bytes)
+{
+	QByteArray folded = bytes;
+	for (char &c : folded)
+		c = foldChar(c);
+	return folded;
+}
+
+static inline quint32 trigramAt(const char *p)
+{
+	return static_cast<quint32>(static_cast<uchar>(p[0])) << 16
+		| static_cast<quint32>(static_cast<uchar>(p[1])) << 8
+		| static_cast<uchar>(p[2]);
+}
+
+// Returns the index of the last character of the escape sequence of letters or digits starting
+// with the backslash at i, so that the code points and references it ends with are not taken
+// as literal text.
+static int escapeEnd(const QString &pattern, int i)
+{
+	const int size = pattern.size();
+	auto skipWhile = [&](int j, int maxCount, bool (*accept)(QChar)) {
+		for (int count = 0; count < maxCount && j + 1 < size && accept(pattern.at(j + 1)); count++)
+			++j;
+		return j;
+	};
+	auto skipTo = [&](int j, QChar close) {
+		while (j + 1 < size && pattern.at(j + 1) != close)
+			++j;
+		return std::min(j + 1, size - 1);
+	};
+	auto isHexDigit = [](QChar c) {
+		return c.isDigit() || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+	};
+	auto isOctalDigit = [](QChar c) { return c >= '0' && c <= '7'; };
+	auto isDigit = [](QChar c) { return c.isDigit(); };
+
+	const int letter = i + 1;
+	const QChar c = pattern.at(letter);
+	const bool braced = letter + 1 < size && pattern.at(letter + 1) == '{';
+	if (c == 'x' || c == 'u') {
+		if (braced)
+			return skipTo(letter, '}');
+		return skipWhile(letter, c == 'x' ? 2 : 4, isHexDigit);
+	}
+	if (c == '0')
+		return skipWhile(letter, 2, isOctalDigit);
+	if (c.isDigit())
+		return skipWhile(letter, 2, isDigit);
+	if (c == 'c')
+		return std::min(letter + 1, size - 1);
+	if (c == 'Q') {
+		// The quoted text runs to \E, or to the end of the pattern.
+		const int end = pattern.indexOf(QStringLiteral("\\E"), letter + 1);
+		return end == -1 ? size - 1 : end + 1;
+	}
+	if (braced && (c == 'o' || c == 'p' || c == 'P' || c == 'N' || c == 'g' || c == 'k'))
+		return skipTo(letter, '}');
+	if ((c == 'k' || c == 'g') && letter + 1 < size && pattern.at(letter + 1) == '<')
+		return skipTo(letter, '>');
+	if (c == 'g')
+		return skipWhile(letter, size, isDigit);
+	return letter;
+}
+
+// Returns the folded literal runs every match of the regular expression contains. Runs inside
+// groups are skipped, and alternations give up entirely, since neither is required.
+static QList<QByteArray> requiredLiterals(const QString &pattern)
+{
+	QList<QByteArray> literals;
+	if (pattern.contains('|'))
+		return literals;
+
+	QString run;
+	int depth = 0;
+	const auto flush = [&]() {
+		if (depth == 0 && run.size() >= 3)
+			literals.append(foldCase(run.toUtf8()));
+		run.clear();
+	};
+
+	for (int i = 0; i < pattern.size(); i++) {
+		QChar c = pattern.at(i);
+		if (c == '\\') {
+			// Escaped punctuation is literal, escaped letters and digits are classes, code
+			// points or references, which end the run.
+			if (i + 1 >= pattern.size()) {
+				flush();
+				continue;
+			}
+			if (pattern.at(i + 1).isLetterOrNumber()) {
+				flush();
+				i = escapeEnd(pattern, i);
+				continue;
+			}
+			c = pattern.at(++i);
+		} else if (c == '*' || c == '?' || c == '{') {
+			// The atom before is optional.
+			run.chop(1);
+			flush();
+			if (c == '{') {
+				while (i < pattern.size() && pattern.at(i) != '}')
+					++i;
+			}
+			continue;
+		} else if (c == '[') {
+			flush();
+			i += 2;
+			while (i < pattern.size() && pattern.at(i) != ']')
+				i += pattern.at(i) == '\\' ? 2 : 1;
+			continue;
+		} else if (c == '(' || c == ')') {
+			flush();
+			depth += c == '(' ? 1 : -1;
+			continue;
+		} else if (c == '+' || c == '.' || c == '^' || c == '$') {
+			flush();
+			continue;
+		}
+
+		// Case-insensitive matching of other letters does not map to folded bytes.
+		if (c.unicode() >= 0x80) {
+			flush();
+			continue;
+		}
+		run.append(c);
+	}
+	flush();
+
+	return literals;
+}
+
+void TextSearchIndex::clear()
+{
+	text.clear();
+	foldedText.clear();
+	documentFrames.clear();
+	documentOffsets.clear();
+	commandBufferOffsets.clear();
+	postingLists.clear();
+}
+
+bool TextSearchIndex::build(const TASLogger::TASLog &tasLog, const QAtomicInt *canceled)
+{
+	clear();
+	return append(tasLog, 0, canceled);
+}
+
+bool TextSearchIndex::append(const TASLogger::TASLog &tasLog, int firstFrame,
+	const QAtomicInt *canceled)
+{
+	const int firstDocument = documentFrames.size();
+	const int firstOffset = text.size();
+	if (!documentOffsets.isEmpty())
+		documentOffsets.removeLast();
+
+	const int frameCount = static_cast<int>(tasLog.physicsFrameList.size());
+	for (int phy = firstFrame; phy < frameCount; phy++) {
+		if (phy % CancelCheckInterval == 0 && canceled && canceled->load())
+			return false;
+
+		const TASLogger::ReaderPhysicsFrame &frame = tasLog.physicsFrameList[phy];
+		if (frame.consolePrintList.empty() && frame.commandBuffer.empty())
+			continue;
+
+		documentFrames.append(phy);
+		documentOffsets.append(text.size());
+		for (const std::string &msg : frame.consolePrintList) {
+			text.append(msg.data(), static_cast<int>(msg.size()));
+			if (!text.endsWith('\n'))
+				text.append('\n');
+		}
+		commandBufferOffsets.append(text.size());
+		if (!frame.commandBuffer.empty()) {
+			text.append(frame.commandBuffer.data(), static_cast<int>(frame.commandBuffer.size()));
+			if (!text.endsWith('\n'))
+				text.append('\n');
+		}
+	}
+	documentOffsets.append(text.size());
+	foldedText += foldCase(text.mid(firstOffset));
+
+	QVector<quint32> trigrams;
+	for (int document = firstDocument; document < documentFrames.size(); document++) {
+		if (document % CancelCheckInterval == 0 && canceled && canceled->load())
+			return false;
+
+		const char *begin = foldedText.constData() + documentOffsets.at(document);
+		const char *end = foldedText.constData() + documentOffsets.at(document + 1);
+		trigrams.clear();
+		for (const char *p = begin; p + 3 <= end; p++)
+			trigrams.append(trigramAt(p));
+		std::sort(trigrams.begin(), trigrams.end());
+		trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+		for (const quint32 trigram : trigrams)
+			postingLists[trigram].append(document);
+	}
+
+	return true;
+}
+
+// Intersects the posting lists of every trigram of the literals, shortest first. Returns false
+// if the literals have no trigram to look up.
+bool TextSearchIndex::findCandidates(const QList<QByteArray> &literals,
+	QVector<int> &candidates) const
+{
+	QVector<const QVector<int> *> lists;
+	for (const QByteArray &literal : literals) {
+		for (int i = 0; i + 3 <= literal.size(); i++) {
+			const auto it = postingLists.constFind(trigramAt(literal.constData() + i));
+			if (it == postingLists.constEnd()) {
+				candidates.clear();
+				return true;
+			}
+			lists.append(&it.value());
+		}
+	}
+	if (lists.isEmpty())
+		return false;
+
+	std::sort(lists.begin(), lists.end(), [](const QVector<int> *a, const QVector<int> *b) {
+		return a->size() < b->size();
+	});
+	candidates = *lists.first();
+	QVector<int> intersection;
+	for (int i = 1; i < lists.size() && !candidates.isEmpty(); i++) {
+		intersection.clear();
+		std::set_intersection(candidates.constBegin(), candidates.constEnd(),
+			lists.at(i)->constBegin(), lists.at(i)->constEnd(),
+			std::back_inserter(intersection));
+		candidates.swap(intersection);
+	}
+	return true;
+}
+
+bool TextSearchIndex::search(const QString &pattern, bool regex,
+	QVector<TextSearchMatch> &matches, QString *errorMessage, int firstFrame) const
+{
+	matches.clear();
+	if (pattern.isEmpty())
+		return true;
+
+	QRegularExpression expression;
+	QList<QByteArray> literals;
+	if (regex) {
+		expression = QRegularExpression(pattern, QRegularExpression::CaseInsensitiveOption);
+		if (!expression.isValid()) {
+			if (errorMessage)
+				*errorMessage = expression.errorString();
+			return false;
+		}
+		literals = requiredLiterals(pattern);
+	} else
+		literals.append(foldCase(pattern.toUtf8()));
+
+	const int firstDocument = std::lower_bound(documentFrames.cbegin(), documentFrames.cend(),
+		firstFrame) - documentFrames.cbegin();
+	QVector<int> candidates;
+	if (findCandidates(literals, candidates)) {
+		candidates.erase(candidates.begin(), std::lower_bound(candidates.begin(),
+			candidates.end(), firstDocument));
+	} else {
+		candidates.resize(documentCount() - firstDocument);
+		std::iota(candidates.begin(), candidates.end(), firstDocument);
+	}
+
+	const QByteArrayMatcher matcher(regex ? QByteArray() : literals.first());
+	for (const int document : candidates) {
+		const int end = documentOffsets.at(document + 1);
+		int lineBegin = documentOffsets.at(document);
+		while (lineBegin < end) {
+			const int lineEnd = foldedText.indexOf('\n', lineBegin);
+			const char *line = text.constData() + lineBegin;
+			const int length = lineEnd - lineBegin;
+
+			const bool found = regex
+				? expression.match(QString::fromUtf8(line, length)).hasMatch()
+				: matcher.indexIn(foldedText.constData() + lineBegin, length) != -1;
+			if (found) {
+				TextSearchMatch match;
+				match.physicsFrame = documentFrames.at(document);
+				match.source = lineBegin < commandBufferOffsets.at(document)
+					? ConsolePrintSource : CommandBufferSource;
+				match.line = QString::fromUtf8(line, length).trimmed();
+				matches.append(match);
+				break;
+			}
+			lineBegin = lineEnd + 1;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <QtCore>
+#include "taslogger/reader.hpp"
+
+enum TextSource {
+	ConsolePrintSource = 0,
+	CommandBufferSource,
+};
+
+struct TextSearchMatch
+{
+	int physicsFrame;
+	TextSource source;
+	// The first matching line of the frame.
+	QString line;
+};
+
+// Trigram inverted index over the console prints and command buffers of the log, with one
+// document per physics frame that has any text.
+//
+// A search looks up the posting lists of the trigrams of the substring, or of the literals
+// every match of a regular expression must contain, and intersects them. Only the documents
+// left are matched line by line. Searches ignore case, and a regular expression without
+// three literal characters in a row falls back to matching every document.
+class TextSearchIndex
+{
+public:
+	// Returns false if canceled is set before the index is complete.
+	bool build(const TASLogger::TASLog &tasLog, const QAtomicInt *canceled = nullptr);
+	// Indexes the physics frames from firstFrame on, appended since the last build. A canceled
+	// append leaves the index incomplete, to be cleared.
+	bool append(const TASLogger::TASLog &tasLog, int firstFrame,
+		const QAtomicInt *canceled = nullptr);
+	void clear();
+
+	inline int documentCount() const { return documentFrames.size(); }
+
+	// Finds the frames from firstFrame on with a line containing the text, or matching the
+	// regular expression, in physics frame order. Returns false if the regular expression is
+	// invalid.
+	bool search(const QString &pattern, bool regex, QVector<TextSearchMatch> &matches,
+		QString *errorMessage, int firstFrame = 0) const;
+
+private:
+	// Text of every document back to back, with each line ending in a newline, and the same
+	// text with the ASCII letters in lower case.
+	QByteArray text;
+	QByteArray foldedText;
+	QVector<int> documentFrames;
+	// Offsets of the documents into the text, with one extra trailing element.
+	QVector<int> documentOffsets;
+	// Offsets where the command buffers of the documents start.
+	QVector<int> commandBufferOffsets;
+	// Sorted documents containing each trigram of the folded text.
+	QHash<quint32, QVector<int>> postingLists;
+
+	bool findCandidates(const QList<QByteArray> &literals, QVector<int> &candidates) const;
+};
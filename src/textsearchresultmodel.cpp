@@ -0,0 +1,82 @@
+#include <algorithm>
+#include "textsearchresultmodel.hpp"
+
+static const QString SourceNameList[] = {"Con", "Cbuf"};
+
+TextSearchResultModel::TextSearchResultModel(QObject *parent)
+	: QAbstractTableModel(parent)
+{
+}
+
+void TextSearchResultModel::setResults(const QVector<TextSearchResult> &results)
+{
+	beginResetModel();
+	resultList = results;
+	endResetModel();
+}
+
+void TextSearchResultModel::appendResults(const QVector<TextSearchResult> &results)
+{
+	if (results.isEmpty())
+		return;
+	beginInsertRows(QModelIndex(), resultList.size(), resultList.size() + results.size() - 1);
+	resultList += results;
+	endInsertRows();
+}
+
+int TextSearchResultModel::findNext(int row) const
+{
+	const auto it = std::upper_bound(resultList.constBegin(), resultList.constEnd(), row,
+		[](int row, const TextSearchResult &result) { return row < result.row; });
+	return it != resultList.constEnd() ? it->row : -1;
+}
+
+int TextSearchResultModel::findPrevious(int row) const
+{
+	const auto it = std::lower_bound(resultList.constBegin(), resultList.constEnd(), row,
+		[](const TextSearchResult &result, int row) { return result.row < row; });
+	return it != resultList.constBegin() ? (it - 1)->row : -1;
+}
+
+int TextSearchResultModel::rowCount(const QModelIndex &) const
+{
+	return resultList.size();
+}
+
+int TextSearchResultModel::columnCount(const QModelIndex &) const
+{
+	return TextSearchHeaderCount;
+}
+
+QVariant TextSearchResultModel::data(const QModelIndex &index, int role) const
+{
+	const TextSearchResult &result = resultList.at(index.row());
+	if (role == Qt::DisplayRole) {
+		switch (index.column()) {
+		case TSRowHeader:
+			return result.row;
+		case TSTimeHeader:
+			return QString::number(result.time, 'f', 3);
+		case TSSourceHeader:
+			return SourceNameList[result.match.source];
+		case TSLineHeader:
+			return result.match.line;
+		}
+	} else if (role == Qt::TextAlignmentRole && index.column() != TSLineHeader)
+		return int(Qt::AlignRight | Qt::AlignVCenter);
+
+	return QVariant();
+}
+
+QVariant TextSearchResultModel::headerData(int section, Qt::Orientation orientation,
+	int role) const
+{
+	if (orientation == Qt::Horizontal) {
+		if (role == Qt::DisplayRole)
+			return TextSearchHeaderList[section][0];
+		else if (role == Qt::ToolTipRole)
+			return TextSearchHeaderList[section][1];
+	}
+
+	return QAbstractTableModel::headerData(section, orientation, role);
+}
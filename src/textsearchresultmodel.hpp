@@ -0,0 +1,58 @@
+#pragma once
+
+#include <QtWidgets>
+#include "textsearchindex.hpp"
+
+enum TextSearchHeaderIndex {
+	TSRowHeader = 0,
+	TSTimeHeader,
+	TSSourceHeader,
+	TSLineHeader,
+};
+
+static const QString TextSearchHeaderList[][2] = {
+	{"row", "Row of the frame in the log table"},
+	{"t", "Elapsed game time"},
+	{"src", "Console print or command buffer"},
+	{"text", "First matching line of the frame"},
+};
+
+static const int TextSearchHeaderCount =
+	sizeof(TextSearchHeaderList) / sizeof(TextSearchHeaderList[0]);
+
+struct TextSearchResult
+{
+	int row;
+	double time;
+	TextSearchMatch match;
+};
+
+// Frames found by a text search, in log order.
+class TextSearchResultModel : public QAbstractTableModel
+{
+	Q_OBJECT
+
+public:
+	TextSearchResultModel(QObject *parent);
+
+	void setResults(const QVector<TextSearchResult> &results);
+	// Adds results after the shown ones, which must precede them in log order.
+	void appendResults(const QVector<TextSearchResult> &results);
+	inline const TextSearchResult &at(int index) const { return resultList.at(index); }
+	inline int count() const { return resultList.size(); }
+
+	// Returns the first result row after the given table row, or -1 if there is none.
+	int findNext(int row) const;
+
+	// Returns the last result row before the given table row, or -1 if there is none.
+	int findPrevious(int row) const;
+
+	int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+	int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+	QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+	QVariant headerData(int section, Qt::Orientation orientation,
+		int role = Qt::DisplayRole) const override;
+
+private:
+	QVector<TextSearchResult> resultList;
+};
@@ -0,0 +1,176 @@
+#include "textsearchwindow.hpp"
+
+TextSearchWindow::TextSearchWindow(QWidget *parent, const LogTableModel *model)
+	: QDockWidget(parent), logTableModel(model)
+{
+	setupUi();
+}
+
+TextSearchWindow::~TextSearchWindow()
+{
+	++searchGeneration;
+	searchWatcher.waitForFinished();
+}
+
+void TextSearchWindow::setupUi()
+{
+	setWindowTitle("Text Search");
+	setObjectName("textSearchWindow");
+
+	QWidget *searchWidget = new QWidget(this);
+
+	searchEdit = new QLineEdit(searchWidget);
+	searchEdit->setPlaceholderText("Search console prints and command buffers");
+	searchEdit->setClearButtonEnabled(true);
+	connect(searchEdit, SIGNAL(textChanged(const QString &)), this, SLOT(startSearch()));
+
+	regexCheck = new QCheckBox("Regex", searchWidget);
+	connect(regexCheck, SIGNAL(toggled(bool)), this, SLOT(startSearch()));
+
+	statusLabel = new QLabel(searchWidget);
+
+	resultTableView = new QTableView(searchWidget);
+	resultTableView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+	resultTableView->setSelectionBehavior(QAbstractItemView::SelectRows);
+	resultTableView->setSelectionMode(QAbstractItemView::SingleSelection);
+	resultTableView->setWordWrap(false);
+	resultTableView->verticalHeader()->hide();
+	resultTableView->verticalHeader()->setDefaultSectionSize(25);
+	resultTableView->horizontalHeader()->setDefaultSectionSize(70);
+	resultTableView->horizontalHeader()->setStretchLastSection(true);
+	connect(resultTableView, SIGNAL(clicked(const QModelIndex &)),
+		this, SLOT(rowActivated(const QModelIndex &)));
+	connect(resultTableView, SIGNAL(activated(const QModelIndex &)),
+		this, SLOT(rowActivated(const QModelIndex &)));
+
+	resultModel = new TextSearchResultModel(this);
+	resultTableView->setModel(resultModel);
+	resultTableView->setColumnWidth(TSSourceHeader, 40);
+
+	QHBoxLayout *searchLayout = new QHBoxLayout;
+	searchLayout->addWidget(searchEdit, 1);
+	searchLayout->addWidget(regexCheck);
+	searchLayout->addWidget(statusLabel);
+
+	QVBoxLayout *layout = new QVBoxLayout(searchWidget);
+	layout->setContentsMargins(2, 2, 2, 2);
+	layout->addLayout(searchLayout);
+	layout->addWidget(resultTableView, 1);
+	searchWidget->setLayout(layout);
+	setWidget(searchWidget);
+
+	connect(&searchWatcher, SIGNAL(finished()), this, SLOT(searchFinished()));
+	connect(logTableModel, SIGNAL(logFileLoaded(bool)), this, SLOT(logFileLoaded()));
+	connect(logTableModel, SIGNAL(textSearchIndexReady()), this, SLOT(startSearch()));
+	connect(logTableModel, SIGNAL(logFramesAppended(int)), this, SLOT(logFramesAppended(int)));
+}
+
+void TextSearchWindow::focusSearch()
+{
+	searchEdit->setFocus();
+	searchEdit->selectAll();
+}
+
+void TextSearchWindow::startSearch()
+{
+	runSearch(0);
+}
+
+// Searches the frames from firstFrame on. The results of a search from a later frame are
+// added to the shown ones.
+void TextSearchWindow::runSearch(int firstFrame)
+{
+	++searchGeneration;
+
+	const QString pattern = searchEdit->text();
+	if (pattern.isEmpty()) {
+		resultModel->setResults(QVector<TextSearchResult>());
+		statusLabel->clear();
+		return;
+	}
+
+	if (!logTableModel->isTextSearchIndexReady()) {
+		statusLabel->setText(logTableModel->rowCount() ? "Indexing..." : QString());
+		return;
+	}
+
+	// The copies share the data with the model, so the worker keeps it alive even if another
+	// log is loaded meanwhile.
+	const TextSearchIndex index = logTableModel->textSearchIndex();
+	const GameTimeIndex gameTimeIndex = logTableModel->gameTimeIndex();
+	const bool regex = regexCheck->isChecked();
+
+	runningGeneration = searchGeneration;
+	searchTimer.start();
+	searchWatcher.setFuture(QtConcurrent::run([index, gameTimeIndex, pattern, regex,
+		firstFrame]() {
+		SearchOutcome outcome;
+		outcome.appended = firstFrame > 0;
+		QVector<TextSearchMatch> matches;
+		outcome.valid = index.search(pattern, regex, matches, &outcome.errorMessage,
+			firstFrame);
+		outcome.results.reserve(matches.size());
+		for (const TextSearchMatch &match : matches) {
+			TextSearchResult result;
+			result.row = gameTimeIndex.physicsFrameRow(match.physicsFrame);
+			result.time = gameTimeIndex.timeAt(match.physicsFrame);
+			result.match = match;
+			outcome.results.append(result);
+		}
+		return outcome;
+	}));
+}
+
+void TextSearchWindow::searchFinished()
+{
+	if (runningGeneration != searchGeneration)
+		return;
+
+	const qint64 elapsed = searchTimer.elapsed();
+	const SearchOutcome outcome = searchWatcher.result();
+	if (!outcome.valid) {
+		statusLabel->setText(outcome.errorMessage);
+		return;
+	}
+
+	if (outcome.appended)
+		resultModel->appendResults(outcome.results);
+	else
+		resultModel->setResults(outcome.results);
+	statusLabel->setText(QString("%1 frames (%2 ms)").arg(resultModel->count()).arg(elapsed));
+}
+
+// The index was extended with the appended frames, which are searched on their own. A search
+// still running did not see them, so it is started over.
+void TextSearchWindow::logFramesAppended(int firstRow)
+{
+	if (searchEdit->text().isEmpty() || !logTableModel->isTextSearchIndexReady())
+		return;
+	if (searchWatcher.isRunning() && runningGeneration == searchGeneration)
+		startSearch();
+	else
+		runSearch(logTableModel->physicsFrameIndex(firstRow));
+}
+
+void TextSearchWindow::logFileLoaded()
+{
+	// The results refer to the rows of the previous log, and the new index is still being built.
+	++searchGeneration;
+	resultModel->setResults(QVector<TextSearchResult>());
+	if (!searchEdit->text().isEmpty())
+		statusLabel->setText("Indexing...");
+}
+
+void TextSearchWindow::rowActivated(const QModelIndex &index)
+{
+	if (!index.isValid())
+		return;
+
+	emit matchActivated(resultModel->at(index.row()).row);
+}
+
+void TextSearchWindow::closeEvent(QCloseEvent *event)
+{
+	emit aboutToClose();
+	QDockWidget::closeEvent(event);
+}
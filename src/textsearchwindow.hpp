@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QtWidgets>
+#include <QtConcurrent>
+#include "logtablemodel.hpp"
+#include "textsearchresultmodel.hpp"
+
+// Searches the console prints and command buffers of every frame through the text search
+// index of the log table model, listing the frames found.
+class TextSearchWindow : public QDockWidget
+{
+	Q_OBJECT
+
+public:
+	TextSearchWindow(QWidget *parent, const LogTableModel *model);
+	~TextSearchWindow();
+
+	void focusSearch();
+
+	inline int findNextMatch(int row) const { return resultModel->findNext(row); }
+	inline int findPreviousMatch(int row) const { return resultModel->findPrevious(row); }
+
+signals:
+	void aboutToClose();
+	void matchActivated(int row);
+
+protected:
+	void closeEvent(QCloseEvent *event) override;
+
+private slots:
+	void startSearch();
+	void searchFinished();
+	void logFileLoaded();
+	void logFramesAppended(int firstRow);
+	void rowActivated(const QModelIndex &index);
+
+private:
+	struct SearchOutcome
+	{
+		// Whether the frames searched were appended to the ones of the shown results.
+		bool appended;
+		bool valid;
+		QString errorMessage;
+		QVector<TextSearchResult> results;
+	};
+
+	const LogTableModel *logTableModel;
+
+	QLineEdit *searchEdit;
+	QCheckBox *regexCheck;
+	QLabel *statusLabel;
+	QTableView *resultTableView;
+	TextSearchResultModel *resultModel;
+
+	QFutureWatcher<SearchOutcome> searchWatcher;
+	QElapsedTimer searchTimer;
+	int searchGeneration = 0;
+	int runningGeneration = 0;
+
+	void setupUi();
+	void runSearch(int firstFrame);
+};
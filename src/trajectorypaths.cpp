@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <cmath>
+#include "trajectorypaths.hpp"
+
+// Position fields of the horizontal and vertical axes of each plane.
+static const LogField PlaneFieldList[TrajectoryPlaneCount][2] = {
+	{PositionXField, PositionYField},
+	{PositionXField, PositionZField},
+	{PositionYField, PositionZField},
+};
+
+void TrajectoryPaths::clear()
+{
+	logColumns = nullptr;
+	segmentKinds.clear();
+	for (int plane = 0; plane < TrajectoryPlaneCount; plane++) {
+		tileBounds[plane].clear();
+		planeBounds[plane] = QRectF();
+		stepSum[plane] = 0;
+		stepCount[plane] = 0;
+		meanStep[plane] = 0;
+	}
+	tileCache.clear();
+}
+
+void TrajectoryPaths::build(const LogColumns &columns)
+{
+	clear();
+	logColumns = &columns;
+	append();
+}
+
+void TrajectoryPaths::append()
+{
+	if (!logColumns)
+		return;
+
+	const int oldRowCount = segmentKinds.size();
+	const int rowCount = logColumns->rowCount();
+	if (rowCount <= oldRowCount)
+		return;
+	const float *onGround = logColumns->field(OnGroundField);
+	const float *onLadder = logColumns->field(OnLadderField);
+	const float *waterLevel = logColumns->field(WaterLevelField);
+	segmentKinds.resize(rowCount);
+	for (int row = oldRowCount; row < rowCount; row++) {
+		if (onLadder[row] > 0)
+			segmentKinds[row] = LadderSegment;
+		else if (waterLevel[row] >= 2)
+			segmentKinds[row] = WaterSegment;
+		else if (onGround[row] > 0)
+			segmentKinds[row] = GroundSegment;
+		else
+			segmentKinds[row] = AirSegment;
+	}
+
+	// The tile holding the last row ended there, so it gains the first appended rows.
+	const int firstTile = oldRowCount > 0 ? (oldRowCount - 1) / TileRows : 0;
+	const int tiles = (rowCount + TileRows - 1) / TileRows;
+	for (int plane = 0; plane < TrajectoryPlaneCount; plane++) {
+		const float *u = logColumns->field(PlaneFieldList[plane][0]);
+		const float *v = logColumns->field(PlaneFieldList[plane][1]);
+		for (int row = std::max(1, oldRowCount); row < rowCount; row++) {
+			if (!std::isnan(u[row]) && !std::isnan(u[row - 1])) {
+				stepSum[plane] += std::hypot(u[row] - u[row - 1], v[row] - v[row - 1]);
+				++stepCount[plane];
+			}
+		}
+
+		tileBounds[plane].resize(tiles);
+		for (int tile = firstTile; tile < tiles; tile++) {
+			// A tile ends at the first row of the next one, so that the paths join.
+			const int first = tile * TileRows;
+			const int last = std::min(first + TileRows, rowCount - 1);
+			float minU = INFINITY, maxU = -INFINITY, minV = INFINITY, maxV = -INFINITY;
+			for (int row = first; row <= last; row++) {
+				if (std::isnan(u[row]))
+					continue;
+				minU = std::min(minU, u[row]);
+				maxU = std::max(maxU, u[row]);
+				minV = std::min(minV, v[row]);
+				maxV = std::max(maxV, v[row]);
+			}
+			if (minU <= maxU) {
+				tileBounds[plane][tile] = QRectF(QPointF(minU, minV), QPointF(maxU, maxV));
+				planeBounds[plane] |= tileBounds[plane][tile];
+			}
+		}
+		meanStep[plane] = stepCount[plane] ? stepSum[plane] / stepCount[plane] : 0;
+	}
+
+	for (auto it = tileCache.begin(); it != tileCache.end(); ) {
+		if (static_cast<int>(it.key() >> 16) >= firstTile)
+			it = tileCache.erase(it);
+		else
+			++it;
+	}
+}
+
+int TrajectoryPaths::levelForSpacing(TrajectoryPlane plane, double spacing) const
+{
+	if (meanStep[plane] <= 0)
+		return 0;
+	const int level = static_cast<int>(std::floor(std::log2(spacing / meanStep[plane])));
+	return std::max(0, std::min(LevelCount - 1, level));
+}
+
+bool TrajectoryPaths::pointAt(TrajectoryPlane plane, int row, QPointF &point) const
+{
+	if (!logColumns || row < 0 || row >= logColumns->rowCount())
+		return false;
+	const float u = logColumns->value(PlaneFieldList[plane][0], row);
+	if (std::isnan(u))
+		return false;
+	point = QPointF(u, logColumns->value(PlaneFieldList[plane][1], row));
+	return true;
+}
+
+TrajectoryPaths::Tile TrajectoryPaths::tile(TrajectoryPlane plane, int level,
+	int index) const
+{
+	const quint64 key = (static_cast<quint64>(index) << 16) | (level << 8) | plane;
+	auto it = tileCache.find(key);
+	if (it == tileCache.end()) {
+		if (tileCache.size() >= MaxCachedTiles)
+			tileCache.clear();
+		it = tileCache.insert(key, buildTile(plane, level, index));
+	}
+	return it.value();
+}
+
+TrajectoryPaths::Tile TrajectoryPaths::buildTile(TrajectoryPlane plane, int level,
+	int index) const
+{
+	Tile tile;
+	const float *u = logColumns->field(PlaneFieldList[plane][0]);
+	const float *v = logColumns->field(PlaneFieldList[plane][1]);
+	const int stride = 1 << level;
+	const int first = index * TileRows;
+	const int last = std::min(first + TileRows, logColumns->rowCount() - 1);
+
+	// Each segment takes the kind of the row it starts from. lastRow tracks where the path of
+	// each kind ends, to continue it without a gap.
+	int lastRow[TrajectorySegmentCount];
+	std::fill(lastRow, lastRow + TrajectorySegmentCount, -1);
+	int previous = -1;
+	for (int row = first; row <= last; row = row == last ? last + 1 : std::min(row + stride, last)) {
+		if (std::isnan(u[row])) {
+			previous = -1;
+			continue;
+		}
+		if (previous != -1) {
+			const int kind = segmentKinds.at(previous);
+			QPainterPath &path = tile.paths[kind];
+			if (lastRow[kind] != previous)
+				path.moveTo(u[previous], v[previous]);
+			path.lineTo(u[row], v[row]);
+			lastRow[kind] = row;
+		}
+		previous = row;
+	}
+
+	return tile;
+}
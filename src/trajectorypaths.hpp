@@ -0,0 +1,74 @@
+#pragma once
+
+#include <QtWidgets>
+#include "logcolumns.hpp"
+
+enum TrajectoryPlane {
+	TopPlane = 0,
+	FrontPlane,
+	SidePlane,
+	TrajectoryPlaneCount
+};
+
+enum TrajectorySegment {
+	AirSegment = 0,
+	GroundSegment,
+	LadderSegment,
+	WaterSegment,
+	TrajectorySegmentCount
+};
+
+static const QString TrajectorySegmentNameList[] = {"Air", "Ground", "Ladder", "Water"};
+
+// Level-of-detail paths of the player position projected on the XY, XZ and YZ planes.
+//
+// The rows are cut into tiles of TileRows rows. Level n of a tile keeps every 2^n-th row, so
+// every level of the pyramid has the same tiles and the same tile bounds. The painter paths
+// of a tile are built the first time the tile is drawn at a level and cached, one path per
+// segment kind, so drawing a frame only walks the cached paths of the visible tiles.
+class TrajectoryPaths
+{
+public:
+	static const int TileRows = 16384;
+	static const int LevelCount = 11;
+
+	struct Tile
+	{
+		QPainterPath paths[TrajectorySegmentCount];
+	};
+
+	// Keeps a pointer to the columns, which must outlive the paths or be rebuilt with them.
+	void build(const LogColumns &columns);
+	// Extends the paths with the rows appended to the columns since the last build.
+	void append();
+	void clear();
+
+	inline int tileCount() const { return tileBounds[TopPlane].size(); }
+	inline const QRectF &bounds(TrajectoryPlane plane) const { return planeBounds[plane]; }
+	inline const QRectF &tileBound(TrajectoryPlane plane, int tile) const
+	{
+		return tileBounds[plane].at(tile);
+	}
+
+	// Returns the coarsest level whose points lie at most the given distance apart on average.
+	int levelForSpacing(TrajectoryPlane plane, double spacing) const;
+
+	Tile tile(TrajectoryPlane plane, int level, int index) const;
+
+	// Returns the position of the row on the plane, or false if the row has none.
+	bool pointAt(TrajectoryPlane plane, int row, QPointF &point) const;
+
+private:
+	static const int MaxCachedTiles = 2048;
+
+	const LogColumns *logColumns = nullptr;
+	QVector<quint8> segmentKinds;
+	QVector<QRectF> tileBounds[TrajectoryPlaneCount];
+	QRectF planeBounds[TrajectoryPlaneCount];
+	double stepSum[TrajectoryPlaneCount] = {};
+	int stepCount[TrajectoryPlaneCount] = {};
+	double meanStep[TrajectoryPlaneCount] = {};
+	mutable QHash<quint64, Tile> tileCache;
+
+	Tile buildTile(TrajectoryPlane plane, int level, int index) const;
+};
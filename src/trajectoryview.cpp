@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <cmath>
+#include "trajectoryview.hpp"
+
+static const QColor SegmentColorList[TrajectorySegmentCount] = {
+	QColor(70, 70, 200),
+	QColor(0, 150, 0),
+	QColor(230, 140, 0),
+	QColor(0, 170, 220),
+};
+
+// Points of the paths drawn at most this many pixels apart on average.
+static const double MaxPointSpacing = 2;
+static const double ZoomStep = 1.25;
+static const int MarkerRadius = 4;
+static const int DragThreshold = 3;
+
+TrajectoryView::TrajectoryView(QWidget *parent, const LogTableModel *model,
+	const TrajectoryPaths *paths, TrajectoryPlane plane)
+	: QWidget(parent), logTableModel(model), trajectoryPaths(paths), plane(plane)
+{
+	setMinimumSize(100, 100);
+	setAutoFillBackground(true);
+	setBackgroundRole(QPalette::Base);
+}
+
+// The vertical axis points up.
+QTransform TrajectoryView::worldTransform() const
+{
+	QTransform transform;
+	transform.translate(width() / 2.0, height() / 2.0);
+	transform.scale(scale, -scale);
+	transform.translate(-center.x(), -center.y());
+	return transform;
+}
+
+// The fit waits for the first paint, when the widget has its final size.
+void TrajectoryView::fitToPaths()
+{
+	fitPending = true;
+	update();
+}
+
+void TrajectoryView::applyFit()
+{
+	fitPending = false;
+	const QRectF &bounds = trajectoryPaths->bounds(plane);
+	if (bounds.isNull()) {
+		center = QPointF();
+		scale = 1;
+		return;
+	}
+	center = bounds.center();
+	scale = 0.9 * std::min(width() / std::max(1.0, bounds.width()),
+		height() / std::max(1.0, bounds.height()));
+}
+
+void TrajectoryView::setCurrentRow(int row)
+{
+	currentRow = row;
+
+	// Follow the current row when it leaves the view.
+	QPointF point;
+	if (trajectoryPaths->pointAt(plane, row, point)) {
+		const QPointF pos = worldTransform().map(point);
+		if (!rect().contains(pos.toPoint()))
+			center = point;
+	}
+	update();
+}
+
+void TrajectoryView::paintEvent(QPaintEvent *)
+{
+	if (fitPending)
+		applyFit();
+
+	QPainter painter(this);
+	const QTransform transform = worldTransform();
+	const QRectF visible = transform.inverted().mapRect(QRectF(rect()));
+	const int level = trajectoryPaths->levelForSpacing(plane, MaxPointSpacing / scale);
+
+	QPen pens[TrajectorySegmentCount];
+	for (int kind = 0; kind < TrajectorySegmentCount; kind++) {
+		pens[kind] = QPen(SegmentColorList[kind]);
+		pens[kind].setCosmetic(true);
+	}
+
+	// Bounds are padded since a straight vertical or horizontal run has an empty rectangle.
+	painter.setTransform(transform);
+	for (int index = 0; index < trajectoryPaths->tileCount(); index++) {
+		if (!trajectoryPaths->tileBound(plane, index).adjusted(-1, -1, 1, 1).intersects(visible))
+			continue;
+		const TrajectoryPaths::Tile tile = trajectoryPaths->tile(plane, level, index);
+		for (int kind = 0; kind < TrajectorySegmentCount; kind++) {
+			painter.setPen(pens[kind]);
+			painter.drawPath(tile.paths[kind]);
+		}
+	}
+	painter.resetTransform();
+
+	QPointF point;
+	if (trajectoryPaths->pointAt(plane, currentRow, point)) {
+		painter.setRenderHint(QPainter::Antialiasing);
+		painter.setPen(QPen(Qt::red, 2));
+		painter.setBrush(Qt::NoBrush);
+		painter.drawEllipse(transform.map(point), MarkerRadius, MarkerRadius);
+	}
+}
+
+void TrajectoryView::mousePressEvent(QMouseEvent *event)
+{
+	pressPos = event->pos();
+	lastMousePos = event->pos();
+	dragged = false;
+}
+
+void TrajectoryView::mouseMoveEvent(QMouseEvent *event)
+{
+	if (!(event->buttons() & Qt::LeftButton))
+		return;
+	if ((event->pos() - pressPos).manhattanLength() >= DragThreshold)
+		dragged = true;
+	if (!dragged)
+		return;
+
+	const QPoint delta = event->pos() - lastMousePos;
+	lastMousePos = event->pos();
+	center -= QPointF(delta.x() / scale, -delta.y() / scale);
+	update();
+}
+
+void TrajectoryView::mouseReleaseEvent(QMouseEvent *event)
+{
+	if (dragged || event->button() != Qt::LeftButton)
+		return;
+
+	static const int PlaneAxisMaskList[TrajectoryPlaneCount] = {
+		SpatialIndex::XAxis | SpatialIndex::YAxis,
+		SpatialIndex::XAxis | SpatialIndex::ZAxis,
+		SpatialIndex::YAxis | SpatialIndex::ZAxis,
+	};
+	static const int PlaneAxisList[TrajectoryPlaneCount][2] = {{0, 1}, {0, 2}, {1, 2}};
+
+	const QPointF world = worldTransform().inverted().map(QPointF(event->pos()));
+	float point[3] = {0, 0, 0};
+	point[PlaneAxisList[plane][0]] = world.x();
+	point[PlaneAxisList[plane][1]] = world.y();
+	const int row = logTableModel->spatialIndex().findNearest(point, PlaneAxisMaskList[plane]);
+	if (row != -1)
+		emit rowClicked(row);
+}
+
+void TrajectoryView::wheelEvent(QWheelEvent *event)
+{
+	const double factor = std::pow(ZoomStep, event->angleDelta().y() / 120.0);
+	const QTransform transform = worldTransform();
+	const QPointF anchor = transform.inverted().map(QPointF(event->pos()));
+
+	// Keep the point under the cursor in place.
+	scale *= factor;
+	center = anchor + (center - anchor) / factor;
+	update();
+	event->accept();
+}
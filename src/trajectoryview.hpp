@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QtWidgets>
+#include "logtablemodel.hpp"
+#include "trajectorypaths.hpp"
+
+// Draws the trajectory on one plane with the current row marked. Dragging pans, the wheel
+// zooms around the cursor, and clicking picks the row nearest to the click.
+class TrajectoryView : public QWidget
+{
+	Q_OBJECT
+
+public:
+	TrajectoryView(QWidget *parent, const LogTableModel *model, const TrajectoryPaths *paths,
+		TrajectoryPlane plane);
+
+	void setCurrentRow(int row);
+	void fitToPaths();
+
+signals:
+	void rowClicked(int row);
+
+protected:
+	void paintEvent(QPaintEvent *event) override;
+	void mousePressEvent(QMouseEvent *event) override;
+	void mouseMoveEvent(QMouseEvent *event) override;
+	void mouseReleaseEvent(QMouseEvent *event) override;
+	void wheelEvent(QWheelEvent *event) override;
+
+private:
+	const LogTableModel *logTableModel;
+	const TrajectoryPaths *trajectoryPaths;
+	TrajectoryPlane plane;
+
+	// World point at the center of the widget and pixels per unit.
+	QPointF center;
+	double scale = 1;
+
+	bool fitPending = true;
+	int currentRow = -1;
+	QPoint pressPos;
+	QPoint lastMousePos;
+	bool dragged = false;
+
+	QTransform worldTransform() const;
+	void applyFit();
+};
@@ -0,0 +1,100 @@
+#include "trajectorywindow.hpp"
+#include "settings.hpp"
+
+static const QString LegendColorList[TrajectorySegmentCount] = {
+	"#4646c8", "#009600", "#e68c00", "#00aadc",
+};
+
+TrajectoryWindow::TrajectoryWindow(QWidget *parent, const LogTableModel *model)
+	: QWidget(parent), logTableModel(model)
+{
+	setupUi();
+	trajectoryPaths.build(logTableModel->logColumns());
+}
+
+void TrajectoryWindow::setupUi()
+{
+	setWindowTitle("Trajectory");
+	setWindowFlags(Qt::Tool);
+
+	QVBoxLayout *lay = new QVBoxLayout(this);
+	setLayout(lay);
+
+	QSplitter *profileSplitter = new QSplitter(Qt::Horizontal, this);
+	QSplitter *splitter = new QSplitter(Qt::Vertical, this);
+	for (int plane = 0; plane < TrajectoryPlaneCount; plane++) {
+		viewList[plane] = new TrajectoryView(this, logTableModel, &trajectoryPaths,
+			static_cast<TrajectoryPlane>(plane));
+		connect(viewList[plane], SIGNAL(rowClicked(int)), this, SIGNAL(rowClicked(int)));
+	}
+	splitter->addWidget(viewList[TopPlane]);
+	profileSplitter->addWidget(viewList[FrontPlane]);
+	profileSplitter->addWidget(viewList[SidePlane]);
+	splitter->addWidget(profileSplitter);
+	splitter->setStretchFactor(0, 3);
+	splitter->setStretchFactor(1, 1);
+	lay->addWidget(splitter, 1);
+
+	QStringList legendList;
+	for (int kind = 0; kind < TrajectorySegmentCount; kind++) {
+		legendList.append(QString("<font color=\"%1\">&#9632;</font> %2")
+			.arg(LegendColorList[kind]).arg(TrajectorySegmentNameList[kind]));
+	}
+	QLabel *legendLabel = new QLabel(legendList.join("&nbsp;&nbsp;") +
+		"&nbsp;&nbsp;&nbsp;XY above, XZ and YZ below", this);
+	lay->addWidget(legendLabel);
+
+	connect(logTableModel, SIGNAL(logColumnsChanged()), this, SLOT(logColumnsChanged()));
+	connect(logTableModel, SIGNAL(logFramesAppended(int)), this, SLOT(logFramesAppended()));
+	connect(logTableModel, SIGNAL(logFileLoaded(bool)), this, SLOT(logFileLoaded()));
+}
+
+void TrajectoryWindow::setCurrentRow(int row)
+{
+	for (TrajectoryView *view : viewList)
+		view->setCurrentRow(row);
+}
+
+// The positions change with the player move state, so the paths are rebuilt with the columns.
+void TrajectoryWindow::logColumnsChanged()
+{
+	trajectoryPaths.build(logTableModel->logColumns());
+	for (TrajectoryView *view : viewList)
+		view->update();
+}
+
+void TrajectoryWindow::logFramesAppended()
+{
+	trajectoryPaths.append();
+	for (TrajectoryView *view : viewList)
+		view->update();
+}
+
+void TrajectoryWindow::logFileLoaded()
+{
+	for (TrajectoryView *view : viewList)
+		view->fitToPaths();
+}
+
+void TrajectoryWindow::closeEvent(QCloseEvent *event)
+{
+	emit aboutToClose();
+	event->ignore();
+	hide();
+}
+
+void TrajectoryWindow::hideEvent(QHideEvent *event)
+{
+	QSettings settings;
+	settings.setValue(TrajectoryGeometryKey, saveGeometry());
+
+	event->accept();
+}
+
+void TrajectoryWindow::showEvent(QShowEvent *event)
+{
+	QSettings settings;
+	restoreGeometry(settings.value(TrajectoryGeometryKey).toByteArray());
+
+	event->accept();
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <QtWidgets>
+#include "logtablemodel.hpp"
+#include "trajectorypaths.hpp"
+#include "trajectoryview.hpp"
+
+// Top-down map of the player path with the side profiles below it.
+class TrajectoryWindow : public QWidget
+{
+	Q_OBJECT
+
+public:
+	TrajectoryWindow(QWidget *parent, const LogTableModel *model);
+
+public slots:
+	void setCurrentRow(int row);
+
+signals:
+	void aboutToClose();
+	void rowClicked(int row);
+
+protected:
+	void closeEvent(QCloseEvent *event) override;
+	void hideEvent(QHideEvent *event) override;
+	void showEvent(QShowEvent *event) override;
+
+private slots:
+	void logColumnsChanged();
+	void logFramesAppended();
+	void logFileLoaded();
+
+private:
+	const LogTableModel *logTableModel;
+
+	TrajectoryPaths trajectoryPaths;
+	TrajectoryView *viewList[TrajectoryPlaneCount];
+
+	void setupUi();
+};